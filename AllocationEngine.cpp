@@ -1,60 +1,260 @@
 #include "AllocationEngine.h"
 
-AllocationEngine::AllocationEngine(ParkingArea* parkingAreas) {
+template <typename AllocationPolicy>
+BasicAllocationEngine<AllocationPolicy>::BasicAllocationEngine(ParkingArea* parkingAreas, const ZoneIndex* index,
+                                                               Analytics* stats) {
     areas = parkingAreas;
+    zoneIndex = index;
+    analytics = stats;
     penaltyApplied = false;
+    penaltyHops = 0;
     lastAllocatedArea = -1;
+    prepare();  // Zones indexed before the engine was built
 }
 
-AllocationEngine::~AllocationEngine() {
-    // Destructor - no dynamic memory to clean up
+template <typename AllocationPolicy>
+BasicAllocationEngine<AllocationPolicy>::~BasicAllocationEngine() {
+    // Destructor - the policy frees its own state
 }
 
-int AllocationEngine::allocateSlot(int vehicleID, int preferredZone, int numberOfAreas) {
-    // Step 1: Attempt same-zone allocation first (preferred zone)
-    // Loop through all parking areas to find those in the preferred zone
-    for (int i = 0; i < numberOfAreas; i++) {
-        if (areas[i].getZoneID() == preferredZone) {
-            // Step 2: For each area in preferred zone, find the first available slot
-            int slotID = areas[i].findFirstAvailableSlot();
-            if (slotID != -1) {
-                // Step 3: If available slot found, occupy it and mark no penalty
-                areas[i].occupySlot(slotID);
-                penaltyApplied = false;
-                lastAllocatedArea = i;
-                return slotID;
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::setAreas(ParkingArea* parkingAreas) {
+    areas = parkingAreas;
+}
+
+template <typename AllocationPolicy>
+AllocationPolicy& BasicAllocationEngine<AllocationPolicy>::getPolicy() {
+    return policy;
+}
+
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::prepare() {
+    policy.prepare(zoneIndex->getNumBuckets());
+}
+
+template <typename AllocationPolicy>
+int BasicAllocationEngine<AllocationPolicy>::getPolicyStateSize() const {
+    return policy.stateSize(zoneIndex->getNumBuckets());
+}
+
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::savePolicyState(int* out) const {
+    policy.saveState(out, zoneIndex->getNumBuckets());
+}
+
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::restorePolicyState(const int* values) {
+    prepare();
+    policy.restoreState(values, zoneIndex->getNumBuckets());
+}
+
+template <typename AllocationPolicy>
+int BasicAllocationEngine<AllocationPolicy>::allocateInBucket(int bucket, int numberOfAreas, std::mutex* bucketLocks,
+                                                              int vehicleClass, int* areaIndex, int* slotType) {
+    // Only the areas of this zone are visited; the policy picks among them
+    const int* areaList = zoneIndex->getBucketAreas(bucket);
+    int count = zoneIndex->getBucketAreaCount(bucket);
+    if (bucketLocks != nullptr) {
+        bucketLocks[bucket].lock();
+    }
+    int slotID = -1;
+    for (int rank = 0; slotID == -1 && preferredSlotType(vehicleClass, rank) != -1; rank++) {
+        int type = preferredSlotType(vehicleClass, rank);
+        slotID = policy.findInZone(areas, areaList, count, numberOfAreas, bucket, type, areaIndex);
+        if (slotID != -1) {
+            areas[*areaIndex].occupySlot(slotID);
+            *slotType = type;
+        }
+    }
+    if (bucketLocks != nullptr) {
+        bucketLocks[bucket].unlock();
+    }
+    return slotID;
+}
+
+template <typename AllocationPolicy>
+bool BasicAllocationEngine<AllocationPolicy>::zoneLoad(int bucket, int numberOfAreas, std::mutex* bucketLocks,
+                                                       int vehicleClass, long long* occupied, long long* total) {
+    bool hasFree = false;
+    if (bucketLocks == nullptr) {
+        // Serial mode: the per-zone analytics counters are current, O(1) per zone
+        int zoneID = zoneIndex->getBucketZoneID(bucket);
+        *total = analytics->getZoneTotal(zoneID);
+        *occupied = *total - analytics->getZoneAvailable(zoneID);
+        for (int rank = 0; !hasFree && preferredSlotType(vehicleClass, rank) != -1; rank++) {
+            hasFree = analytics->getZoneTypeAvailable(zoneID, preferredSlotType(vehicleClass, rank)) > 0;
+        }
+        return hasFree;
+    }
+
+    // Concurrent mode: the analytics counters trail the slot claims (they
+    // are updated under the bookkeeping lock), so count the zone's areas
+    // under its lock
+    const int* areaList = zoneIndex->getBucketAreas(bucket);
+    int count = zoneIndex->getBucketAreaCount(bucket);
+    *occupied = 0;
+    *total = 0;
+    bucketLocks[bucket].lock();
+    for (int j = 0; j < count; j++) {
+        int i = areaList[j];
+        if (i >= numberOfAreas) {
+            continue;
+        }
+        *total += areas[i].getNumSlots();
+        *occupied += areas[i].getNumSlots() - areas[i].getAvailableSlots();
+        for (int rank = 0; !hasFree && preferredSlotType(vehicleClass, rank) != -1; rank++) {
+            hasFree = areas[i].getAvailableSlotsOfType(preferredSlotType(vehicleClass, rank)) > 0;
+        }
+    }
+    bucketLocks[bucket].unlock();
+    return hasFree;
+}
+
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::allocateBalanced(int preferredBucket, const int* order,
+                                                               int numberOfAreas, std::mutex* bucketLocks,
+                                                               int vehicleClass, AllocationResult* result) {
+    int numBuckets = zoneIndex->getNumBuckets();
+    int k = 0;
+    while (k < numBuckets) {
+        // The search order is sorted by hop distance, so a ring is a run of
+        // equal distances (unreachable zones form the last ring)
+        int hops = zoneIndex->getHopDistance(preferredBucket, order[k]);
+        int end = k + 1;
+        while (end < numBuckets && zoneIndex->getHopDistance(preferredBucket, order[end]) == hops) {
+            end++;
+        }
+
+        // Least utilized zone of the ring (compared exactly as fractions;
+        // ties go to the zone earlier in the search order)
+        int best = -1;
+        long long bestOccupied = 0;
+        long long bestTotal = 1;
+        for (int j = k; j < end; j++) {
+            int b = order[j];
+            long long occupied;
+            long long total;
+            if (b == preferredBucket || !zoneLoad(b, numberOfAreas, bucketLocks, vehicleClass, &occupied, &total)) {
+                continue;
+            }
+            if (best == -1 || occupied * bestTotal < bestOccupied * total) {
+                best = b;
+                bestOccupied = occupied;
+                bestTotal = total;
             }
         }
+        if (best != -1) {
+            result->slotID = allocateInBucket(best, numberOfAreas, bucketLocks, vehicleClass, &result->areaIndex,
+                                              &result->slotType);
+            for (int j = k; result->slotID == -1 && j < end; j++) {
+                if (order[j] != preferredBucket && order[j] != best) {
+                    result->slotID = allocateInBucket(order[j], numberOfAreas, bucketLocks, vehicleClass,
+                                                      &result->areaIndex, &result->slotType);
+                }
+            }
+            if (result->slotID != -1) {
+                result->penaltyHops = (hops > 0) ? hops : numBuckets;
+                return;
+            }
+        }
+        k = end;
+    }
+}
+
+template <typename AllocationPolicy>
+int BasicAllocationEngine<AllocationPolicy>::allocateSlot(int vehicleID, int preferredZone, int numberOfAreas,
+                                                          int vehicleClass) {
+    AllocationResult result = allocate(preferredZone, numberOfAreas, nullptr, vehicleClass);
+    if (result.slotID == -1) {
+        return -1;  // Allocation failed
+    }
+    analytics->onSlotOccupied(areas[result.areaIndex].getZoneID(), result.slotType);
+    penaltyApplied = (result.penaltyHops > 0);
+    penaltyHops = result.penaltyHops;
+    lastAllocatedArea = result.areaIndex;
+    return result.slotID;
+}
+
+template <typename AllocationPolicy>
+AllocationResult BasicAllocationEngine<AllocationPolicy>::allocate(int preferredZone, int numberOfAreas,
+                                                                   std::mutex* bucketLocks, int vehicleClass) {
+    AllocationResult result;
+    result.slotID = -1;
+    result.areaIndex = -1;
+    result.penaltyHops = 0;
+    result.slotType = -1;
+    if (!isValidVehicleClass(vehicleClass)) {
+        return result;
+    }
+
+    // Step 1: Attempt same-zone allocation first (preferred zone)
+    // The zone index gives the areas of the preferred zone directly
+    int preferredBucket = zoneIndex->findBucket(preferredZone);
+    if (preferredBucket != -1) {
+        // Step 2: For each accepted slot type, best first, let the policy
+        // pick an available slot of that type in the preferred zone's areas
+        result.slotID = allocateInBucket(preferredBucket, numberOfAreas, bucketLocks, vehicleClass,
+                                         &result.areaIndex, &result.slotType);
+        if (result.slotID != -1) {
+            // Step 3: If available slot found, no penalty
+            return result;
+        }
     }
 
     // Step 4: If no slot in preferred zone, attempt cross-zone allocation
-    // Loop through all parking areas in other zones
-    for (int i = 0; i < numberOfAreas; i++) {
-        if (areas[i].getZoneID() != preferredZone) {
-            // Step 5: Find first available slot in cross-zone area
-            int slotID = areas[i].findFirstAvailableSlot();
-            if (slotID != -1) {
-                // Step 6: If available slot found, occupy it and mark penalty applied
-                areas[i].occupySlot(slotID);
-                penaltyApplied = true;
-                lastAllocatedArea = i;
-                return slotID;
-            }
+    // Zones are visited nearest first using the precomputed search order;
+    // the preferred zone (first in its own order) is skipped
+    int numBuckets = zoneIndex->getNumBuckets();
+    bool ordered = (preferredBucket != -1 && !zoneIndex->needsRebuild());
+    const int* order = ordered ? zoneIndex->getSearchOrder(preferredBucket) : nullptr;
+    if (AllocationPolicy::BALANCE_FALLBACK_ZONES && ordered) {
+        allocateBalanced(preferredBucket, order, numberOfAreas, bucketLocks, vehicleClass, &result);
+        return result;
+    }
+    for (int k = 0; k < numBuckets; k++) {
+        int b = ordered ? order[k] : k;
+        if (b == preferredBucket) {
+            continue;
+        }
+        // Step 5: Find an available slot in the nearest zone with capacity
+        result.slotID = allocateInBucket(b, numberOfAreas, bucketLocks, vehicleClass, &result.areaIndex, &result.slotType);
+        if (result.slotID != -1) {
+            // Step 6: If available slot found, apply a penalty that grows with distance
+            int hops = ordered ? zoneIndex->getHopDistance(preferredBucket, b) : -1;
+            result.penaltyHops = (hops > 0) ? hops : numBuckets;
+            return result;
         }
     }
 
     // Step 7: If no slots available anywhere, return -1 (allocation failed)
-    return -1;
+    return result;
 }
 
-bool AllocationEngine::hasPenalty() const {
+template <typename AllocationPolicy>
+bool BasicAllocationEngine<AllocationPolicy>::hasPenalty() const {
     return penaltyApplied;
 }
 
-void AllocationEngine::resetPenalty() {
+template <typename AllocationPolicy>
+int BasicAllocationEngine<AllocationPolicy>::getPenaltyHops() const {
+    return penaltyHops;
+}
+
+template <typename AllocationPolicy>
+void BasicAllocationEngine<AllocationPolicy>::resetPenalty() {
     penaltyApplied = false;
+    penaltyHops = 0;
 }
 
-int AllocationEngine::getLastAllocatedArea() const {
+template <typename AllocationPolicy>
+int BasicAllocationEngine<AllocationPolicy>::getLastAllocatedArea() const {
     return lastAllocatedArea;
-}
\ No newline at end of file
+}
+
+// One engine per policy, so benchmarks and tests can compare them in one
+// build; ParkingSystem uses the PARKING_ALLOCATION_POLICY instance
+template class BasicAllocationEngine<FirstFitPolicy>;
+template class BasicAllocationEngine<BestFitPolicy>;
+template class BasicAllocationEngine<RoundRobinPolicy>;
+template class BasicAllocationEngine<NearestSlotPolicy>;
+template class BasicAllocationEngine<LeastUtilizedZonePolicy>;
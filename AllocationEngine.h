@@ -1,30 +1,120 @@
 #ifndef ALLOCATION_ENGINE_H
 #define ALLOCATION_ENGINE_H
 
+#include <mutex>
 #include "ParkingArea.h"
+#include "ZoneIndex.h"
+#include "Analytics.h"
+#include "AllocationPolicy.h"
 
-class AllocationEngine {
+// Result of one allocation, returned per call so concurrent callers never
+// read another caller's "last allocation" state
+struct AllocationResult {
+    int slotID;       // Allocated slotID (-1 if no slot available)
+    int areaIndex;    // Index of the area holding the slot (-1 if none)
+    int penaltyHops;  // Hop distance from the preferred zone (0 = same zone)
+    int slotType;     // SlotType of the allocated slot (-1 if none)
+};
+
+// Allocation engine, parameterized by an allocation policy (see
+// AllocationPolicy.h) that picks the slot inside a zone. The policy is
+// chosen at compile time, so the per-allocation search has no virtual
+// calls. The members are defined in AllocationEngine.cpp and instantiated
+// there for every policy in AllocationPolicy.h; ParkingSystem uses the one
+// named by PARKING_ALLOCATION_POLICY (the AllocationEngine typedef below)
+template <typename AllocationPolicy>
+class BasicAllocationEngine {
 private:
+    AllocationPolicy policy;  // Slot choice inside a zone (and per-zone policy state)
     ParkingArea* areas;     // Array of ParkingArea pointers
+    const ZoneIndex* zoneIndex;  // Zone -> area index owned by ParkingSystem
+    Analytics* analytics;   // Running counters owned by ParkingSystem
     bool penaltyApplied;    // Flag indicating if cross-zone allocation penalty was applied
+    int penaltyHops;        // Hop distance of the last allocation from the preferred zone
     int lastAllocatedArea;  // Index of the last allocated area
 
+    // Try to allocate a slot a vehicle class accepts from the areas of one
+    // zone bucket (-1 if the zone has none free). Slot types are tried in
+    // the class's preference order, each across all of the zone's areas;
+    // areas without a free slot of the type are skipped by their counter.
+    // Locks the bucket's mutex while searching when bucketLocks is given
+    int allocateInBucket(int bucket, int numberOfAreas, std::mutex* bucketLocks, int vehicleClass,
+                         int* areaIndex, int* slotType);
+
+    // Occupied and total slots of a zone (from the analytics counters, or
+    // from its areas under the zone's lock when bucketLocks is given);
+    // returns true if the zone has a free slot of a type the class accepts
+    bool zoneLoad(int bucket, int numberOfAreas, std::mutex* bucketLocks, int vehicleClass,
+                  long long* occupied, long long* total);
+
+    // Cross-zone fallback for policies that balance zones: rings of equally
+    // distant zones nearest first, and in each ring the least utilized zone
+    // with a free slot the class accepts (the rest of the ring in search
+    // order if another thread took that slot first)
+    void allocateBalanced(int preferredBucket, const int* order, int numberOfAreas, std::mutex* bucketLocks,
+                          int vehicleClass, AllocationResult* result);
+
 public:
-    // Constructor: Initializes the engine with an array of parking areas
-    AllocationEngine(ParkingArea* parkingAreas);
+    // Constructor: Initializes the engine with an array of parking areas,
+    // the zone index used to find the areas of each zone and the analytics
+    // counters to update when a slot is occupied
+    BasicAllocationEngine(ParkingArea* parkingAreas, const ZoneIndex* index, Analytics* stats);
 
     // Destructor
-    ~AllocationEngine();
+    ~BasicAllocationEngine();
+
+    // The engine points into ParkingSystem's arrays, so it is not copyable
+    BasicAllocationEngine(const BasicAllocationEngine& other) = delete;
+    BasicAllocationEngine& operator=(const BasicAllocationEngine& other) = delete;
+
+    typedef AllocationPolicy Policy;
+
+    // Access the policy (e.g. NearestSlotPolicy::setReferencePoint)
+    AllocationPolicy& getPolicy();
 
-    // Main responsibility: Allocate a parking slot for a vehicle
+    // Size the policy's per-zone state for the zone index's buckets. The
+    // constructor does this for the zones indexed so far; call it again
+    // after adding zones (ParkingSystem does when it registers one), never
+    // while a search runs
+    void prepare();
+
+    // Policy state for snapshots: its size in ints, and saving and
+    // restoring it for the zone index's buckets (restoring runs prepare)
+    int getPolicyStateSize() const;
+    void savePolicyState(int* out) const;
+    void restorePolicyState(const int* values);
+
+    // Point the engine at the areas array after ParkingSystem grew it
+    // (area indices are unchanged)
+    void setAreas(ParkingArea* parkingAreas);
+
+    // Main responsibility: Allocate a parking slot for a vehicle of a class
+    // (only slot types the class accepts are considered, see SlotType.h);
+    // the policy picks the slot inside each zone
     // Prefers allocation in the same zone as preferredZone
-    // Falls back to cross-zone allocation with penalty if same-zone not available
+    // Falls back to cross-zone allocation with penalty if same-zone not available,
+    // searching zones in increasing hop distance and stopping at the nearest
+    // zone with a free slot
     // Returns the allocated slotID or -1 if no slot available
-    int allocateSlot(int vehicleID, int preferredZone, int numberOfAreas);
+    // Only areas registered in the zone index are searched; the index's
+    // distance tables must be up to date (see ZoneIndex::needsRebuild)
+    int allocateSlot(int vehicleID, int preferredZone, int numberOfAreas, int vehicleClass = VEHICLE_STANDARD);
+
+    // Same search as allocateSlot, but stateless: the result is returned per
+    // call and neither the engine's "last" state nor the analytics counters
+    // are touched (the caller records the occupied slot).
+    // When bucketLocks is given (one mutex per zone bucket), each zone is
+    // searched under its own lock, so calls for different zones run in parallel
+    AllocationResult allocate(int preferredZone, int numberOfAreas, std::mutex* bucketLocks,
+                              int vehicleClass = VEHICLE_STANDARD);
 
     // Check if the last allocation incurred a cross-zone penalty
     bool hasPenalty() const;
 
+    // Get the cross-zone penalty of the last allocation: the hop distance from
+    // the preferred zone (0 = same zone, number of zone buckets = unreachable)
+    int getPenaltyHops() const;
+
     // Reset the penalty flag (utility function)
     void resetPenalty();
 
@@ -32,4 +122,11 @@ public:
     int getLastAllocatedArea() const;
 };
 
-#endif // ALLOCATION_ENGINE_H
\ No newline at end of file
+// Compile-time policy choice, e.g. -DPARKING_ALLOCATION_POLICY=BestFitPolicy
+#ifndef PARKING_ALLOCATION_POLICY
+#define PARKING_ALLOCATION_POLICY FirstFitPolicy
+#endif
+
+typedef BasicAllocationEngine<PARKING_ALLOCATION_POLICY> AllocationEngine;
+
+#endif // ALLOCATION_ENGINE_H
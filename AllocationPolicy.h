@@ -0,0 +1,299 @@
+#ifndef ALLOCATION_POLICY_H
+#define ALLOCATION_POLICY_H
+
+#include "ParkingArea.h"
+#include <climits>
+
+// Allocation policies for BasicAllocationEngine (AllocationEngine.h).
+//
+// A policy decides which free slot of one slot type the engine takes among
+// the areas of one zone, and whether cross-zone fallback balances load
+// across equally near zones. The engine keeps everything else: the same
+// zone is searched first, then the other zones nearest first, and the
+// vehicle class's slot types in preference order within each zone.
+//
+// The policy is a template argument of the engine, so the choice is made at
+// compile time (PARKING_ALLOCATION_POLICY) and findInZone is inlined into
+// the engine's search loop: no virtual call per allocation. Every policy
+// provides:
+//   name()                  Name for benchmark output
+//   SAME_ZONE_FIRST_FIT     True when findInZone takes the lowest free slot
+//                           of the first area that has one, so
+//                           ParkingSystem::allocateBatch may claim same-zone
+//                           slots in bulk and still match one-by-one results
+//   BALANCE_FALLBACK_ZONES  True to take the least utilized of the nearest
+//                           zones with a free slot on cross-zone fallback
+//                           (false: the first of them in search order)
+//   prepare(numBuckets)     Size per-zone state; called when zones are added
+//                           (configuration time), never during a search
+//   stateSize(numBuckets)   Ints of state a snapshot must keep so that a
+//                           restored system picks the same slots (0: none)
+//   saveState(out, n)       Write those ints for n buckets
+//   restoreState(in, n)     Read them back (after prepare(n))
+//   findInZone(...)         SlotID of a free slot of slotType among a zone's
+//                           areas (not yet occupied), -1 if none; sets
+//                           *areaIndex. Runs under the zone's lock in
+//                           concurrent mode
+
+// First fit: the lowest free slot of the first area (in the order areas
+// were added) that has one. The original engine behaviour and the default
+class FirstFitPolicy {
+public:
+    static constexpr bool SAME_ZONE_FIRST_FIT = true;
+    static constexpr bool BALANCE_FALLBACK_ZONES = false;
+
+    static const char* name() { return "first_fit"; }
+
+    void prepare(int numBuckets) { (void)numBuckets; }
+
+    int stateSize(int numBuckets) const { (void)numBuckets; return 0; }
+    void saveState(int* out, int numBuckets) const { (void)out; (void)numBuckets; }
+    void restoreState(const int* values, int numBuckets) { (void)values; (void)numBuckets; }
+
+    int findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas, int bucket,
+                   int slotType, int* areaIndex);
+};
+
+// Best fit by area load: the area with the fewest free slots of the type
+// (ties to the first added), so areas fill up one after another and whole
+// areas stay empty for closing or cleaning. Scans every area of the zone
+class BestFitPolicy {
+public:
+    static constexpr bool SAME_ZONE_FIRST_FIT = false;
+    static constexpr bool BALANCE_FALLBACK_ZONES = false;
+
+    static const char* name() { return "best_fit"; }
+
+    void prepare(int numBuckets) { (void)numBuckets; }
+
+    int stateSize(int numBuckets) const { (void)numBuckets; return 0; }
+    void saveState(int* out, int numBuckets) const { (void)out; (void)numBuckets; }
+    void restoreState(const int* values, int numBuckets) { (void)values; (void)numBuckets; }
+
+    int findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas, int bucket,
+                   int slotType, int* areaIndex);
+};
+
+// Round robin: each zone keeps a cursor over its areas and starts after the
+// area that took the previous car, spreading arrivals (and gate traffic)
+// evenly across the zone's areas
+class RoundRobinPolicy {
+private:
+    int* cursors;        // Next area position per zone bucket
+    int cursorCapacity;  // Buckets covered by cursors
+
+public:
+    static constexpr bool SAME_ZONE_FIRST_FIT = false;
+    static constexpr bool BALANCE_FALLBACK_ZONES = false;
+
+    static const char* name() { return "round_robin"; }
+
+    // Constructor: No cursors yet (all zones start at their first area)
+    RoundRobinPolicy();
+
+    // Destructor
+    ~RoundRobinPolicy();
+
+    // The cursors belong to one engine, so the policy is not copyable
+    RoundRobinPolicy(const RoundRobinPolicy& other) = delete;
+    RoundRobinPolicy& operator=(const RoundRobinPolicy& other) = delete;
+
+    void prepare(int numBuckets);
+
+    // One cursor per bucket
+    int stateSize(int numBuckets) const { return numBuckets; }
+    void saveState(int* out, int numBuckets) const;
+    void restoreState(const int* values, int numBuckets);
+
+    int findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas, int bucket,
+                   int slotType, int* areaIndex);
+};
+
+// Nearest slot: the free slot of the type nearest to a reference point (by
+// default the entrance at 0, 0 on level 0) among every area of the zone,
+// through each area's spatial index (fewest levels away, then smallest
+// planar distance; ties to the area added first). In areas that mix slot
+// types the index skips slots of other types
+class NearestSlotPolicy {
+private:
+    int referenceX;      // Reference point (e.g. the entrance) in slot coordinates
+    int referenceY;
+    int referenceLevel;
+
+public:
+    static constexpr bool SAME_ZONE_FIRST_FIT = false;
+    static constexpr bool BALANCE_FALLBACK_ZONES = false;
+
+    static const char* name() { return "nearest_slot"; }
+
+    // Constructor: Reference point at the entrance (0, 0, level 0)
+    NearestSlotPolicy() : referenceX(0), referenceY(0), referenceLevel(0) {}
+
+    // Move the reference point (applies to every area)
+    void setReferencePoint(int x, int y, int level) {
+        referenceX = x;
+        referenceY = y;
+        referenceLevel = level;
+    }
+
+    void prepare(int numBuckets) { (void)numBuckets; }
+
+    // The reference point is the state (the same for every zone)
+    int stateSize(int numBuckets) const { (void)numBuckets; return 3; }
+
+    void saveState(int* out, int numBuckets) const {
+        (void)numBuckets;
+        out[0] = referenceX;
+        out[1] = referenceY;
+        out[2] = referenceLevel;
+    }
+
+    void restoreState(const int* values, int numBuckets) {
+        (void)numBuckets;
+        setReferencePoint(values[0], values[1], values[2]);
+    }
+
+    int findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas, int bucket,
+                   int slotType, int* areaIndex);
+};
+
+// Least utilized zone: first fit inside a zone, but cross-zone fallback
+// takes the least utilized zone (occupied / total) among the nearest zones
+// that have a free slot the vehicle accepts, so spill-over from a full zone
+// is shared by its neighbours instead of filling the first one
+class LeastUtilizedZonePolicy : public FirstFitPolicy {
+public:
+    static constexpr bool BALANCE_FALLBACK_ZONES = true;
+
+    static const char* name() { return "least_utilized_zone"; }
+};
+
+// Policy definitions stay in the header so they inline into the engine
+
+inline int FirstFitPolicy::findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas,
+                                      int bucket, int slotType, int* areaIndex) {
+    (void)bucket;
+    for (int j = 0; j < count; j++) {
+        int i = areaList[j];
+        if (i >= numberOfAreas || areas[i].getAvailableSlotsOfType(slotType) == 0) {
+            continue;
+        }
+        int slotID = areas[i].findFirstAvailableSlotOfType(slotType);
+        if (slotID != -1) {
+            *areaIndex = i;
+            return slotID;
+        }
+    }
+    return -1;
+}
+
+inline int BestFitPolicy::findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas,
+                                     int bucket, int slotType, int* areaIndex) {
+    (void)bucket;
+    int best = -1;
+    int bestFree = 0;
+    for (int j = 0; j < count; j++) {
+        int i = areaList[j];
+        if (i >= numberOfAreas) {
+            continue;
+        }
+        int free = areas[i].getAvailableSlotsOfType(slotType);
+        if (free > 0 && (best == -1 || free < bestFree)) {
+            best = i;
+            bestFree = free;
+        }
+    }
+    if (best == -1) {
+        return -1;
+    }
+    *areaIndex = best;
+    return areas[best].findFirstAvailableSlotOfType(slotType);
+}
+
+inline RoundRobinPolicy::RoundRobinPolicy() {
+    cursors = nullptr;
+    cursorCapacity = 0;
+}
+
+inline RoundRobinPolicy::~RoundRobinPolicy() {
+    delete[] cursors;
+}
+
+inline void RoundRobinPolicy::prepare(int numBuckets) {
+    if (numBuckets <= cursorCapacity) {
+        return;
+    }
+    int newCapacity = (numBuckets > 2 * cursorCapacity) ? numBuckets : 2 * cursorCapacity;
+    int* grown = new int[newCapacity];
+    for (int b = 0; b < newCapacity; b++) {
+        grown[b] = (b < cursorCapacity) ? cursors[b] : 0;
+    }
+    delete[] cursors;
+    cursors = grown;
+    cursorCapacity = newCapacity;
+}
+
+inline void RoundRobinPolicy::saveState(int* out, int numBuckets) const {
+    for (int b = 0; b < numBuckets; b++) {
+        out[b] = (b < cursorCapacity) ? cursors[b] : 0;
+    }
+}
+
+inline void RoundRobinPolicy::restoreState(const int* values, int numBuckets) {
+    prepare(numBuckets);
+    for (int b = 0; b < numBuckets; b++) {
+        cursors[b] = (values[b] < 0) ? 0 : values[b];  // Past the zone's areas wraps in findInZone
+    }
+}
+
+inline int RoundRobinPolicy::findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas,
+                                        int bucket, int slotType, int* areaIndex) {
+    int start = (bucket < cursorCapacity) ? cursors[bucket] : 0;
+    if (start >= count) {
+        start = 0;  // The zone lost areas since (not possible today, but cheap to guard)
+    }
+    for (int step = 0; step < count; step++) {
+        int j = start + step;
+        if (j >= count) {
+            j -= count;
+        }
+        int i = areaList[j];
+        if (i >= numberOfAreas || areas[i].getAvailableSlotsOfType(slotType) == 0) {
+            continue;
+        }
+        int slotID = areas[i].findFirstAvailableSlotOfType(slotType);
+        if (slotID != -1) {
+            if (bucket < cursorCapacity) {
+                cursors[bucket] = (j + 1 == count) ? 0 : j + 1;
+            }
+            *areaIndex = i;
+            return slotID;
+        }
+    }
+    return -1;
+}
+
+inline int NearestSlotPolicy::findInZone(ParkingArea* areas, const int* areaList, int count, int numberOfAreas,
+                                         int bucket, int slotType, int* areaIndex) {
+    (void)bucket;
+    // Each area only reports a slot strictly nearer than the best so far,
+    // so later areas are pruned and ties go to the area added first
+    int bestSlot = -1;
+    long long bestGap = LLONG_MAX;
+    long long bestDistance = LLONG_MAX;
+    for (int j = 0; j < count; j++) {
+        int i = areaList[j];
+        if (i >= numberOfAreas || areas[i].getAvailableSlotsOfType(slotType) == 0) {
+            continue;
+        }
+        int slotID = areas[i].findNearestAvailableSlotOfType(referenceX, referenceY, referenceLevel, slotType,
+                                                             &bestGap, &bestDistance);
+        if (slotID != -1) {
+            bestSlot = slotID;
+            *areaIndex = i;
+        }
+    }
+    return bestSlot;
+}
+
+#endif // ALLOCATION_POLICY_H
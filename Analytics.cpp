@@ -0,0 +1,482 @@
+#include "Analytics.h"
+
+Analytics::Analytics(const ZoneIndex* index) {
+    totalSlots = 0;
+    availableSlots = 0;
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        typeTotal[t] = 0;
+        typeAvailable[t] = 0;
+    }
+    numRequests = 0;
+    for (int s = 0; s < NUM_STATES; s++) {
+        stateCounts[s] = 0;
+    }
+    resetTransitionErrors();
+    transitionLog = nullptr;
+
+    zoneIndex = index;
+    zoneCapacity = 8;  // Default per-zone capacity
+    zoneTotal = new int[zoneCapacity];
+    zoneOccupied = new int[zoneCapacity];
+    zoneTypeAvailable = new int[zoneCapacity * NUM_SLOT_TYPES];
+    heapPos = new int[zoneCapacity];
+    registrationOrder = new int[zoneCapacity];
+    heap = new int[zoneCapacity];
+    for (int b = 0; b < zoneCapacity; b++) {
+        zoneTotal[b] = 0;
+        zoneOccupied[b] = 0;
+        heapPos[b] = -1;
+        registrationOrder[b] = 0;
+    }
+    for (int i = 0; i < zoneCapacity * NUM_SLOT_TYPES; i++) {
+        zoneTypeAvailable[i] = 0;
+    }
+    heapSize = 0;
+    numRegistered = 0;
+}
+
+Analytics::~Analytics() {
+    delete[] zoneTotal;
+    delete[] zoneOccupied;
+    delete[] zoneTypeAvailable;
+    delete[] heapPos;
+    delete[] registrationOrder;
+    delete[] heap;
+}
+
+void Analytics::ensureBuckets() {
+    int needed = zoneIndex->getNumBuckets();
+    if (needed <= zoneCapacity) {
+        return;
+    }
+    int newCapacity = zoneCapacity * 2;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    int* newTotal = new int[newCapacity];
+    int* newOccupied = new int[newCapacity];
+    int* newTypeAvailable = new int[newCapacity * NUM_SLOT_TYPES];
+    int* newHeapPos = new int[newCapacity];
+    int* newOrder = new int[newCapacity];
+    int* newHeap = new int[newCapacity];
+    for (int b = 0; b < newCapacity; b++) {
+        bool old = (b < zoneCapacity);
+        newTotal[b] = old ? zoneTotal[b] : 0;
+        newOccupied[b] = old ? zoneOccupied[b] : 0;
+        newHeapPos[b] = old ? heapPos[b] : -1;
+        newOrder[b] = old ? registrationOrder[b] : 0;
+    }
+    for (int i = 0; i < newCapacity * NUM_SLOT_TYPES; i++) {
+        newTypeAvailable[i] = (i < zoneCapacity * NUM_SLOT_TYPES) ? zoneTypeAvailable[i] : 0;
+    }
+    for (int i = 0; i < heapSize; i++) {
+        newHeap[i] = heap[i];
+    }
+    delete[] zoneTotal;
+    delete[] zoneOccupied;
+    delete[] zoneTypeAvailable;
+    delete[] heapPos;
+    delete[] registrationOrder;
+    delete[] heap;
+    zoneTotal = newTotal;
+    zoneOccupied = newOccupied;
+    zoneTypeAvailable = newTypeAvailable;
+    heapPos = newHeapPos;
+    registrationOrder = newOrder;
+    heap = newHeap;
+    zoneCapacity = newCapacity;
+}
+
+int Analytics::bucketOf(int zoneID) {
+    int bucket = zoneIndex->findBucket(zoneID);
+    if (bucket >= zoneCapacity) {
+        ensureBuckets();
+    }
+    return bucket;
+}
+
+bool Analytics::ranksAbove(int a, int b) const {
+    // Compare occupied/total fractions exactly: occA/totA vs occB/totB
+    // (a zone without slots counts as 0/1)
+    long long left = static_cast<long long>(zoneOccupied[a]) * (zoneTotal[b] > 0 ? zoneTotal[b] : 1);
+    long long right = static_cast<long long>(zoneOccupied[b]) * (zoneTotal[a] > 0 ? zoneTotal[a] : 1);
+    if (left != right) {
+        return left > right;
+    }
+    return registrationOrder[a] < registrationOrder[b];
+}
+
+void Analytics::siftUp(int i) {
+    int bucket = heap[i];
+    while (i > 0) {
+        int parent = (i - 1) / 2;
+        if (!ranksAbove(bucket, heap[parent])) {
+            break;
+        }
+        heap[i] = heap[parent];
+        heapPos[heap[i]] = i;
+        i = parent;
+    }
+    heap[i] = bucket;
+    heapPos[bucket] = i;
+}
+
+void Analytics::siftDown(int i) {
+    int bucket = heap[i];
+    while (true) {
+        int child = 2 * i + 1;
+        if (child >= heapSize) {
+            break;
+        }
+        if (child + 1 < heapSize && ranksAbove(heap[child + 1], heap[child])) {
+            child++;
+        }
+        if (!ranksAbove(heap[child], bucket)) {
+            break;
+        }
+        heap[i] = heap[child];
+        heapPos[heap[i]] = i;
+        i = child;
+    }
+    heap[i] = bucket;
+    heapPos[bucket] = i;
+}
+
+void Analytics::updateHeap(int bucket) {
+    int i = heapPos[bucket];
+    if (i == -1) {
+        return;  // Zone not registered: tracked but not a peak candidate
+    }
+    siftUp(i);
+    siftDown(heapPos[bucket]);
+}
+
+void Analytics::onZoneRegistered(int zoneID) {
+    int bucket = bucketOf(zoneID);
+    if (bucket == -1 || heapPos[bucket] != -1) {
+        return;  // Unknown zone or already registered
+    }
+    registrationOrder[bucket] = numRegistered++;
+    heap[heapSize] = bucket;
+    heapPos[bucket] = heapSize;
+    heapSize++;
+    siftUp(heapSize - 1);
+}
+
+void Analytics::onSlotsAdded(int zoneID, int slotType, int total, int available) {
+    totalSlots += total;
+    availableSlots += available;
+    typeTotal[slotType] += total;
+    typeAvailable[slotType] += available;
+    int bucket = bucketOf(zoneID);
+    if (bucket != -1) {
+        zoneTotal[bucket] += total;
+        zoneOccupied[bucket] += total - available;
+        zoneTypeAvailable[bucket * NUM_SLOT_TYPES + slotType] += available;
+        updateHeap(bucket);
+    }
+}
+
+void Analytics::onSlotOccupied(int zoneID, int slotType) {
+    availableSlots--;
+    typeAvailable[slotType]--;
+    int bucket = bucketOf(zoneID);
+    if (bucket != -1) {
+        zoneOccupied[bucket]++;
+        zoneTypeAvailable[bucket * NUM_SLOT_TYPES + slotType]--;
+        updateHeap(bucket);
+    }
+}
+
+void Analytics::onSlotsOccupied(int zoneID, int slotType, int count) {
+    availableSlots -= count;
+    typeAvailable[slotType] -= count;
+    int bucket = bucketOf(zoneID);
+    if (bucket != -1) {
+        zoneOccupied[bucket] += count;
+        zoneTypeAvailable[bucket * NUM_SLOT_TYPES + slotType] -= count;
+        updateHeap(bucket);
+    }
+}
+
+void Analytics::onSlotFreed(int zoneID, int slotType) {
+    availableSlots++;
+    typeAvailable[slotType]++;
+    int bucket = bucketOf(zoneID);
+    if (bucket != -1) {
+        zoneOccupied[bucket]--;
+        zoneTypeAvailable[bucket * NUM_SLOT_TYPES + slotType]++;
+        updateHeap(bucket);
+    }
+}
+
+void Analytics::onRequestAdded(int requestIndex, ParkingRequest::State state) {
+    numRequests++;
+    stateCounts[state]++;
+    stateLists.add(requestIndex, state);
+}
+
+void Analytics::onStateChange(int requestIndex, ParkingRequest::State before, ParkingRequest::State after) {
+    if (before != after) {
+        stateCounts[before]--;
+        stateCounts[after]++;
+        stateLists.move(requestIndex, before, after);
+    }
+}
+
+void Analytics::onTransitionError(ParkingRequest::Transition transition, ParkingRequest::State from, int requestID) {
+    transitionErrors[transition][from]++;
+    if (transitionLog != nullptr) {
+        transitionLog->record(requestID, transition, from);
+    }
+}
+
+void Analytics::setTransitionLog(TransitionLog* log) {
+    transitionLog = log;
+}
+
+long long Analytics::getTransitionErrors(ParkingRequest::Transition transition) const {
+    long long total = 0;
+    for (int s = 0; s < NUM_STATES; s++) {
+        total += transitionErrors[transition][s];
+    }
+    return total;
+}
+
+long long Analytics::getTransitionErrors(ParkingRequest::Transition transition, ParkingRequest::State from) const {
+    return transitionErrors[transition][from];
+}
+
+void Analytics::resetTransitionErrors() {
+    for (int t = 0; t < ParkingRequest::NUM_TRANSITIONS; t++) {
+        for (int s = 0; s < NUM_STATES; s++) {
+            transitionErrors[t][s] = 0;
+        }
+    }
+}
+
+int Analytics::getTotalSlots() const {
+    return totalSlots;
+}
+
+int Analytics::getAvailableSlots() const {
+    return availableSlots;
+}
+
+int Analytics::getRequestsInState(ParkingRequest::State state) const {
+    return stateCounts[state];
+}
+
+int Analytics::getActiveRequests() const {
+    return numRequests - stateCounts[ParkingRequest::CANCELLED] - stateCounts[ParkingRequest::RELEASED];
+}
+
+int Analytics::getFirstInState(ParkingRequest::State state) const {
+    return stateLists.getFirst(state);
+}
+
+int Analytics::getNextInState(int requestIndex) const {
+    return stateLists.getNext(requestIndex);
+}
+
+int Analytics::getTypeTotal(int slotType) const {
+    return isValidSlotType(slotType) ? typeTotal[slotType] : 0;
+}
+
+int Analytics::getTypeAvailable(int slotType) const {
+    return isValidSlotType(slotType) ? typeAvailable[slotType] : 0;
+}
+
+int Analytics::getZoneTypeAvailable(int zoneID, int slotType) const {
+    int bucket = zoneIndex->findBucket(zoneID);
+    if (bucket == -1 || bucket >= zoneCapacity || !isValidSlotType(slotType)) {
+        return 0;
+    }
+    return zoneTypeAvailable[bucket * NUM_SLOT_TYPES + slotType];
+}
+
+int Analytics::getZoneAvailable(int zoneID) const {
+    int bucket = zoneIndex->findBucket(zoneID);
+    if (bucket == -1 || bucket >= zoneCapacity) {
+        return 0;
+    }
+    return zoneTotal[bucket] - zoneOccupied[bucket];
+}
+
+int Analytics::getZoneTotal(int zoneID) const {
+    int bucket = zoneIndex->findBucket(zoneID);
+    if (bucket == -1 || bucket >= zoneCapacity) {
+        return 0;
+    }
+    return zoneTotal[bucket];
+}
+
+double Analytics::getZoneUtilization(int zoneID) const {
+    // Formula: (occupied slots / total slots) * 100
+    int bucket = zoneIndex->findBucket(zoneID);
+    if (bucket == -1 || bucket >= zoneCapacity || zoneTotal[bucket] == 0) {
+        return 0.0;
+    }
+    return (static_cast<double>(zoneOccupied[bucket]) / zoneTotal[bucket]) * 100.0;
+}
+
+int Analytics::getPeakZone() const {
+    if (heapSize == 0) {
+        return -1;
+    }
+    return zoneIndex->getBucketZoneID(heap[0]);
+}
+
+int Analytics::getTopZones(int k, int* outZoneIDs) const {
+    if (k <= 0 || heapSize == 0) {
+        return 0;
+    }
+    if (k > heapSize) {
+        k = heapSize;
+    }
+
+    // Best-first walk of the heap: a small candidate heap holds heap
+    // positions whose parents have already been output
+    int* candidates = new int[k + 1];
+    int numCandidates = 1;
+    candidates[0] = 0;
+    int written = 0;
+    while (written < k && numCandidates > 0) {
+        // Pop the best candidate
+        int top = candidates[0];
+        outZoneIDs[written++] = zoneIndex->getBucketZoneID(heap[top]);
+        candidates[0] = candidates[--numCandidates];
+        int i = 0;
+        while (true) {
+            int best = i;
+            int left = 2 * i + 1;
+            int right = left + 1;
+            if (left < numCandidates && ranksAbove(heap[candidates[left]], heap[candidates[best]])) {
+                best = left;
+            }
+            if (right < numCandidates && ranksAbove(heap[candidates[right]], heap[candidates[best]])) {
+                best = right;
+            }
+            if (best == i) {
+                break;
+            }
+            int tmp = candidates[i];
+            candidates[i] = candidates[best];
+            candidates[best] = tmp;
+            i = best;
+        }
+
+        // Push its children (only as many as can still be output)
+        for (int c = 2 * top + 1; c <= 2 * top + 2 && c < heapSize; c++) {
+            if (numCandidates >= k + 1) {
+                break;
+            }
+            int j = numCandidates++;
+            candidates[j] = c;
+            while (j > 0 && ranksAbove(heap[candidates[j]], heap[candidates[(j - 1) / 2]])) {
+                int tmp = candidates[j];
+                candidates[j] = candidates[(j - 1) / 2];
+                candidates[(j - 1) / 2] = tmp;
+                j = (j - 1) / 2;
+            }
+        }
+    }
+    delete[] candidates;
+    return written;
+}
+
+bool Analytics::verify(const ParkingArea* areas, int numAreas,
+                       const ParkingRequest* requests, int numRequests) const {
+    // Recount slots from the areas (whose per-type counters are checked
+    // against their slots first)
+    int total = 0;
+    int available = 0;
+    int typeSlots[NUM_SLOT_TYPES];
+    int typeFree[NUM_SLOT_TYPES];
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        typeSlots[t] = 0;
+        typeFree[t] = 0;
+    }
+    for (int i = 0; i < numAreas; i++) {
+        if (!areas[i].verifyTypeCounters()) {
+            return false;
+        }
+        total += areas[i].getNumSlots();
+        available += areas[i].getAvailableSlots();
+        for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+            typeSlots[t] += areas[i].getSlotsOfType(t);
+            typeFree[t] += areas[i].getAvailableSlotsOfType(t);
+        }
+    }
+    if (total != totalSlots || available != availableSlots) {
+        return false;
+    }
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        if (typeSlots[t] != typeTotal[t] || typeFree[t] != typeAvailable[t]) {
+            return false;
+        }
+    }
+
+    // Recount per-zone slots and check the heap order
+    for (int b = 0; b < zoneIndex->getNumBuckets() && b < zoneCapacity; b++) {
+        int zoneSlots = 0;
+        int zoneFree = 0;
+        int zoneTypeFree[NUM_SLOT_TYPES];
+        for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+            zoneTypeFree[t] = 0;
+        }
+        const int* areaList = zoneIndex->getBucketAreas(b);
+        for (int j = 0; j < zoneIndex->getBucketAreaCount(b); j++) {
+            zoneSlots += areas[areaList[j]].getNumSlots();
+            zoneFree += areas[areaList[j]].getAvailableSlots();
+            for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+                zoneTypeFree[t] += areas[areaList[j]].getAvailableSlotsOfType(t);
+            }
+        }
+        if (zoneSlots != zoneTotal[b] || zoneSlots - zoneFree != zoneOccupied[b]) {
+            return false;
+        }
+        for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+            if (zoneTypeFree[t] != zoneTypeAvailable[b * NUM_SLOT_TYPES + t]) {
+                return false;
+            }
+        }
+    }
+    for (int i = 1; i < heapSize; i++) {
+        if (ranksAbove(heap[i], heap[(i - 1) / 2])) {
+            return false;
+        }
+    }
+
+    // Recount request states from the requests
+    int counts[NUM_STATES];
+    for (int s = 0; s < NUM_STATES; s++) {
+        counts[s] = 0;
+    }
+    for (int i = 0; i < numRequests; i++) {
+        counts[requests[i].getState()]++;
+    }
+    if (numRequests != this->numRequests) {
+        return false;
+    }
+    for (int s = 0; s < NUM_STATES; s++) {
+        if (counts[s] != stateCounts[s]) {
+            return false;
+        }
+    }
+
+    // Walk each state list: exactly stateCounts[s] requests, all in state s
+    // (with the counts above, the lists then partition the requests)
+    for (int s = 0; s < NUM_STATES; s++) {
+        int listed = 0;
+        for (int i = stateLists.getFirst(s); i != -1; i = stateLists.getNext(i)) {
+            if (i < 0 || i >= numRequests || requests[i].getState() != s || ++listed > stateCounts[s]) {
+                return false;
+            }
+        }
+        if (listed != stateCounts[s]) {
+            return false;
+        }
+    }
+    return true;
+}
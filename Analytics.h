@@ -0,0 +1,168 @@
+#ifndef ANALYTICS_H
+#define ANALYTICS_H
+
+#include "ParkingArea.h"
+#include "ParkingRequest.h"
+#include "TransitionLog.h"
+#include "RequestStateLists.h"
+#include "ZoneIndex.h"
+
+// Running counters behind the ParkingSystem analytics getters.
+// The allocation engine, the rollback manager and the request transition
+// paths report every slot and state change here, so the getters are O(1)
+// instead of rescanning all areas or requests on every call.
+//
+// Slot counts are also kept per slot type, overall and (free slots) per
+// zone and type, so typed availability is O(1) too.
+//
+// Occupied/total counts are also kept per zone (indexed by ZoneIndex bucket).
+// Registered zones sit in an indexed binary max-heap keyed on utilization
+// (ties go to the zone registered first), so the peak zone is read in O(1)
+// and a utilization change costs O(log zones).
+//
+// Requests are also kept in one intrusive list per state, so the requests
+// in a state can be enumerated in O(count in that state).
+//
+// Rejected request transitions are counted per transition and per state
+// they were attempted from, and optionally copied into a TransitionLog.
+
+class Analytics {
+private:
+    static const int NUM_STATES = 5;  // Number of ParkingRequest::State values
+
+    int totalSlots;               // Slots across all registered areas
+    int availableSlots;           // Free slots across all registered areas
+    int typeTotal[NUM_SLOT_TYPES];      // Slots of each SlotType across all registered areas
+    int typeAvailable[NUM_SLOT_TYPES];  // Free slots of each SlotType
+    int numRequests;              // Requests registered
+    int stateCounts[NUM_STATES];  // Requests per ParkingRequest::State
+    RequestStateLists stateLists; // Request indices per ParkingRequest::State
+    long long transitionErrors[ParkingRequest::NUM_TRANSITIONS][NUM_STATES];  // Rejected transitions by from-state
+    TransitionLog* transitionLog;  // Optional log of rejected transitions (owned by ParkingSystem, may be null)
+
+    const ZoneIndex* zoneIndex;   // Maps zoneIDs to buckets (owned by ParkingSystem)
+    int* zoneTotal;               // Slots per zone bucket
+    int* zoneOccupied;            // Occupied slots per zone bucket
+    int* zoneTypeAvailable;       // Free slots per zone bucket and SlotType (bucket * NUM_SLOT_TYPES + type)
+    int* heapPos;                 // Position of each bucket in the heap (-1 if not registered)
+    int* registrationOrder;       // Order in which each bucket was registered as a zone
+    int zoneCapacity;             // Capacity of the per-bucket arrays
+
+    int* heap;                    // Max-heap of registered zone buckets
+    int heapSize;                 // Number of buckets in the heap
+    int numRegistered;            // Number of zones registered so far
+
+    // Grow the per-bucket arrays to cover every bucket in the zone index
+    void ensureBuckets();
+
+    // Bucket of a zoneID, creating per-bucket counters if needed (-1 if unknown)
+    int bucketOf(int zoneID);
+
+    // True if bucket a should be above bucket b in the heap
+    bool ranksAbove(int a, int b) const;
+
+    // Restore the heap property around position i
+    void siftUp(int i);
+    void siftDown(int i);
+
+    // Re-position a bucket in the heap after its counts changed
+    void updateHeap(int bucket);
+
+public:
+    // Constructor: All counters start at zero
+    Analytics(const ZoneIndex* index);
+
+    // Destructor
+    ~Analytics();
+
+    // Counters are tied to one zone index, so they are not copyable
+    Analytics(const Analytics& other) = delete;
+    Analytics& operator=(const Analytics& other) = delete;
+
+    // Record a zone added to the system (makes it a peak-usage candidate)
+    void onZoneRegistered(int zoneID);
+
+    // Record the slots of one type in a newly registered area in a zone
+    void onSlotsAdded(int zoneID, int slotType, int total, int available);
+
+    // Record that a free slot of a type in a zone became occupied
+    void onSlotOccupied(int zoneID, int slotType);
+
+    // Record that several free slots of a type in a zone became occupied at once
+    void onSlotsOccupied(int zoneID, int slotType, int count);
+
+    // Record that an occupied slot of a type in a zone became free
+    void onSlotFreed(int zoneID, int slotType);
+
+    // Record a newly registered request (at requestIndex) in its current state
+    void onRequestAdded(int requestIndex, ParkingRequest::State state);
+
+    // Record a successful state transition of the request at requestIndex
+    void onStateChange(int requestIndex, ParkingRequest::State before, ParkingRequest::State after);
+
+    // Record a rejected request transition (state unchanged), O(1). Called
+    // by ParkingSystem and RollbackManager only, so rejected calls made
+    // directly on a ParkingRequest are not counted
+    void onTransitionError(ParkingRequest::Transition transition, ParkingRequest::State from, int requestID);
+
+    // Log that rejected transitions are also copied into (null for none)
+    void setTransitionLog(TransitionLog* log);
+
+    // Rejected attempts of a transition, from any state
+    long long getTransitionErrors(ParkingRequest::Transition transition) const;
+
+    // Rejected attempts of a transition from one state
+    long long getTransitionErrors(ParkingRequest::Transition transition, ParkingRequest::State from) const;
+
+    // Zero the transition error counters
+    void resetTransitionErrors();
+
+    // Getter for total slots
+    int getTotalSlots() const;
+
+    // Getter for available slots
+    int getAvailableSlots() const;
+
+    // Getter for number of requests in a given state
+    int getRequestsInState(ParkingRequest::State state) const;
+
+    // Getter for active requests (not CANCELLED and not RELEASED)
+    int getActiveRequests() const;
+
+    // First (longest in the state) request index in a state, -1 if none, O(1)
+    int getFirstInState(ParkingRequest::State state) const;
+
+    // Next request index in the same state, -1 at the end, O(1)
+    int getNextInState(int requestIndex) const;
+
+    // Getters for the slots and free slots of a slot type (0 for values
+    // outside SlotType)
+    int getTypeTotal(int slotType) const;
+    int getTypeAvailable(int slotType) const;
+
+    // Number of free slots in a zone (0 if unknown)
+    int getZoneAvailable(int zoneID) const;
+
+    // Get total slots in a zone
+    int getZoneTotal(int zoneID) const;
+
+    // Number of free slots of a slot type in a zone (0 if unknown)
+    int getZoneTypeAvailable(int zoneID, int slotType) const;
+
+    // Utilization of a zone in percent (0 if the zone has no slots)
+    double getZoneUtilization(int zoneID) const;
+
+    // Registered zone with the highest utilization (-1 if none), O(1)
+    int getPeakZone() const;
+
+    // Write up to k registered zoneIDs in decreasing utilization order
+    // Returns the number written, O(k log k)
+    int getTopZones(int k, int* outZoneIDs) const;
+
+    // Self-check: recompute every counter from scratch and compare
+    // Returns true if all counters match the areas and requests
+    bool verify(const ParkingArea* areas, int numAreas,
+                const ParkingRequest* requests, int numRequests) const;
+};
+
+#endif // ANALYTICS_H
@@ -0,0 +1,196 @@
+#include "Arena.h"
+#include <cstdlib>
+#include <cstring>  // For memcpy
+#include <new>
+#include <stdint.h>  // For uintptr_t
+
+constexpr double Arena::DEFAULT_GROWTH_FACTOR;
+
+// Chunk data starts after the header, rounded up to this alignment
+static const size_t HEADER_ALIGNMENT = 64;
+
+// Round a size up to a multiple of a power-of-two alignment
+static size_t alignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+// Size class of a small block: the smallest k with 16 << k >= bytes
+static int sizeClass(size_t bytes) {
+    int k = 0;
+    while ((static_cast<size_t>(16) << k) < bytes) {
+        k++;
+    }
+    return k;
+}
+
+// Free-list links live in the released blocks themselves
+static void* nextFree(void* block) {
+    void* next;
+    std::memcpy(&next, block, sizeof(next));
+    return next;
+}
+
+static void setNextFree(void* block, void* next) {
+    std::memcpy(block, &next, sizeof(next));
+}
+
+Arena::Arena(size_t initialChunkSize) {
+    head = nullptr;
+    largeBlocks = nullptr;
+    for (int k = 0; k < NUM_SIZE_CLASSES; k++) {
+        freeBlocks[k] = nullptr;
+    }
+    nextChunkSize = (initialChunkSize > 0) ? initialChunkSize : DEFAULT_CHUNK_SIZE;
+    bytesReserved = 0;
+    bytesUsed = 0;
+    numChunks = 0;
+}
+
+Arena::~Arena() {
+    while (head != nullptr) {
+        Chunk* next = head->next;
+        std::free(head);
+        head = next;
+    }
+    while (largeBlocks != nullptr) {
+        LargeBlock* next = largeBlocks->next;
+        std::free(largeBlocks);
+        largeBlocks = next;
+    }
+}
+
+void Arena::addChunk(size_t minBytes) {
+    size_t size = nextChunkSize;
+    while (size < minBytes) {
+        size *= 2;
+    }
+    size_t headerSize = alignUp(sizeof(Chunk), HEADER_ALIGNMENT);
+    void* memory = std::malloc(headerSize + size);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    Chunk* chunk = static_cast<Chunk*>(memory);
+    chunk->next = head;
+    chunk->size = size;
+    chunk->used = 0;
+    head = chunk;
+    bytesReserved += headerSize + size;
+    numChunks++;
+    nextChunkSize = size * 2;  // Geometric growth keeps the chunk count logarithmic
+}
+
+void* Arena::allocateLarge(size_t bytes) {
+    size_t headerSize = alignUp(sizeof(LargeBlock), HEADER_ALIGNMENT);
+    void* memory = std::malloc(headerSize + bytes);
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    LargeBlock* block = static_cast<LargeBlock*>(memory);
+    block->prev = nullptr;
+    block->next = largeBlocks;
+    block->size = bytes;
+    if (largeBlocks != nullptr) {
+        largeBlocks->prev = block;
+    }
+    largeBlocks = block;
+    bytesReserved += headerSize + bytes;
+    bytesUsed += bytes;
+    return static_cast<char*>(memory) + headerSize;
+}
+
+void Arena::releaseLarge(void* data) {
+    size_t headerSize = alignUp(sizeof(LargeBlock), HEADER_ALIGNMENT);
+    LargeBlock* block = reinterpret_cast<LargeBlock*>(static_cast<char*>(data) - headerSize);
+    if (block->prev != nullptr) {
+        block->prev->next = block->next;
+    } else {
+        largeBlocks = block->next;
+    }
+    if (block->next != nullptr) {
+        block->next->prev = block->prev;
+    }
+    bytesReserved -= headerSize + block->size;
+    bytesUsed -= block->size;
+    std::free(block);
+}
+
+void* Arena::allocate(size_t bytes, size_t alignment) {
+    if (bytes > MAX_SMALL_BLOCK) {
+        return allocateLarge(bytes);
+    }
+    if (bytes >= MIN_RECYCLED) {
+        // Reusable blocks are rounded up to their size class and kept 8-byte
+        // aligned, so a recycled block suits any request of its class but a
+        // 16-byte aligned one
+        int k = sizeClass(bytes);
+        bytes = static_cast<size_t>(16) << k;
+        alignment = (alignment < 8) ? 8 : alignment;
+        void* block = freeBlocks[k];
+        if (block != nullptr && (reinterpret_cast<uintptr_t>(block) & (alignment - 1)) == 0) {
+            freeBlocks[k] = nextFree(block);
+            bytesUsed += bytes;
+            return block;
+        }
+    }
+
+    size_t headerSize = alignUp(sizeof(Chunk), HEADER_ALIGNMENT);
+    if (head != nullptr) {
+        size_t offset = alignUp(head->used, alignment);
+        if (offset + bytes <= head->size) {
+            bytesUsed += offset + bytes - head->used;
+            head->used = offset + bytes;
+            return reinterpret_cast<char*>(head) + headerSize + offset;
+        }
+    }
+    // Current chunk is full: the rest of it is abandoned
+    addChunk(bytes + alignment);
+    size_t offset = alignUp(head->used, alignment);
+    bytesUsed += offset + bytes;
+    head->used = offset + bytes;
+    return reinterpret_cast<char*>(head) + headerSize + offset;
+}
+
+void Arena::release(void* block, size_t bytes) {
+    if (block == nullptr) {
+        return;
+    }
+    if (bytes > MAX_SMALL_BLOCK) {
+        releaseLarge(block);
+        return;
+    }
+    if (bytes < MIN_RECYCLED) {
+        bytesUsed -= bytes;
+        return;  // Too small to hold a free-list link; stays abandoned
+    }
+    int k = sizeClass(bytes);
+    bytesUsed -= static_cast<size_t>(16) << k;
+    setNextFree(block, freeBlocks[k]);
+    freeBlocks[k] = block;
+}
+
+size_t Arena::getBytesReserved() const {
+    return bytesReserved;
+}
+
+size_t Arena::getBytesUsed() const {
+    return bytesUsed;
+}
+
+int Arena::getNumChunks() const {
+    return numChunks;
+}
+
+int Arena::grownCapacity(int capacity, int needed, double factor) {
+    if (factor < 1.0) {
+        factor = 1.0;
+    }
+    double grown = capacity * factor;
+    int newCapacity = (grown > 2147483647.0) ? 2147483647 : static_cast<int>(grown);
+    if (newCapacity <= capacity) {
+        newCapacity = capacity + 1;
+    }
+    if (newCapacity < needed) {
+        newCapacity = needed;
+    }
+    return newCapacity;
+}
@@ -0,0 +1,110 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <cstddef>
+
+// Bump allocator with block reuse.
+// Small blocks are handed out from a few large chunks, and blocks over
+// MAX_SMALL_BLOCK bytes (slot columns, entity arrays, big indexes) get their
+// own system allocation. Everything is released together when the arena is
+// destroyed, in time proportional to the number of chunks and large blocks,
+// not the number of objects.
+// ParkingSystem keeps its zones, vehicles, requests, areas and slot columns
+// in one arena, so related objects sit next to each other in memory.
+//
+// Growable arrays give their old block back with release(), so repeated
+// growth does not pile up abandoned generations: a large block is freed at
+// once, and a small one (rounded up to a power-of-two size class) goes on
+// its class's free list for the next allocation of that class.
+//
+// Objects placed in an arena must not own heap memory of their own (their
+// destructors are not run); arena-aware classes take their buffers from the
+// arena instead.
+
+class Arena {
+private:
+    struct Chunk {
+        Chunk* next;   // Previously filled chunk
+        size_t size;   // Usable bytes after the header
+        size_t used;   // Bytes handed out so far
+    };
+
+    struct LargeBlock {
+        LargeBlock* prev;  // Neighbours in the list of live large blocks
+        LargeBlock* next;
+        size_t size;       // Usable bytes after the header
+    };
+
+    static const int NUM_SIZE_CLASSES = 9;  // Classes of 16, 32, ... 4096 bytes
+
+    Chunk* head;            // Chunk currently being filled
+    LargeBlock* largeBlocks;                // Live large blocks
+    void* freeBlocks[NUM_SIZE_CLASSES];     // Released blocks by class: class k holds blocks of 16 << k bytes
+    size_t nextChunkSize;   // Usable size of the next chunk (doubles each time)
+    size_t bytesReserved;   // Bytes obtained from the system
+    size_t bytesUsed;       // Bytes handed out (including alignment padding)
+    int numChunks;          // Number of chunks
+
+    // Start a new chunk with room for at least the given bytes
+    void addChunk(size_t minBytes);
+
+    // Allocate or free a block of over MAX_SMALL_BLOCK bytes
+    void* allocateLarge(size_t bytes);
+    void releaseLarge(void* block);
+
+public:
+    static const size_t DEFAULT_CHUNK_SIZE = 64 * 1024;  // Default first chunk size
+    static constexpr double DEFAULT_GROWTH_FACTOR = 2.0;  // Default factor for growable arrays
+    static const size_t MIN_RECYCLED = 16;                // Smaller released blocks are not reused
+    static const size_t MAX_SMALL_BLOCK = 4 * 1024;       // Larger blocks get their own allocation
+
+    // Constructor: The first chunk is allocated on first use
+    Arena(size_t initialChunkSize = DEFAULT_CHUNK_SIZE);
+
+    // Destructor: Frees every chunk
+    ~Arena();
+
+    // Handing out the same chunks twice would double-free, so not copyable
+    Arena(const Arena& other) = delete;
+    Arena& operator=(const Arena& other) = delete;
+
+    // Allocate uninitialized bytes with the given alignment (a power of two,
+    // at most 16)
+    void* allocate(size_t bytes, size_t alignment);
+
+    // Give back a block from allocate() with the same size; it is reused by
+    // a later allocation (or freed, if large). The contents are lost
+    void release(void* block, size_t bytes);
+
+    // Allocate an uninitialized array of count objects of type T
+    template <typename T>
+    T* allocateArray(int count) {
+        return static_cast<T*>(allocate(sizeof(T) * (count > 0 ? count : 1), alignof(T)));
+    }
+
+    // Give back an array from allocateArray() with the same count (no
+    // destructors are run; nullptr is ignored)
+    template <typename T>
+    void releaseArray(T* array, int count) {
+        if (array != nullptr) {
+            release(array, sizeof(T) * (count > 0 ? count : 1));
+        }
+    }
+
+    // Getter for bytes obtained from the system
+    size_t getBytesReserved() const;
+
+    // Getter for bytes handed out and not released (including alignment
+    // padding)
+    size_t getBytesUsed() const;
+
+    // Getter for number of chunks (large blocks are not counted)
+    int getNumChunks() const;
+
+    // Next capacity for a full growable array: capacity * factor, but at
+    // least needed and at least one more than capacity (so any factor > 1
+    // gives amortized O(1) appends; smaller factors waste less memory)
+    static int grownCapacity(int capacity, int needed, double factor);
+};
+
+#endif // ARENA_H
@@ -0,0 +1,238 @@
+#include "EventLog.h"
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define EVENT_LOG_HAS_MMAP 1
+#endif
+
+static const char EVENT_LOG_MAGIC[4] = {'P', 'K', 'E', 'V'};
+
+EventLogWriter::EventLogWriter() {
+    file = nullptr;
+    buffered = 0;
+    numWritten = 0;
+}
+
+EventLogWriter::~EventLogWriter() {
+    close();
+}
+
+bool EventLogWriter::open(const char* path) {
+    close();
+    file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    EventLogHeader header;
+    std::memcpy(header.magic, EVENT_LOG_MAGIC, 4);
+    header.version = EventLogHeader::VERSION;
+    header.recordSize = sizeof(EventRecord);
+    header.reserved = 0;
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        close();
+        return false;
+    }
+    buffered = 0;
+    numWritten = 0;
+    return true;
+}
+
+bool EventLogWriter::append(const EventRecord& record) {
+    if (file == nullptr) {
+        return false;
+    }
+    if (buffered == BUFFER_RECORDS && !flush()) {
+        return false;
+    }
+    buffer[buffered++] = record;
+    numWritten++;
+    return true;
+}
+
+bool EventLogWriter::logRequest(int requestID, int vehicleID, int requestedZone, int requestTime) {
+    EventRecord record = {EventRecord::REQUEST, requestID, vehicleID, requestedZone, requestTime};
+    return append(record);
+}
+
+bool EventLogWriter::logAllocate(int requestIndex, int time) {
+    EventRecord record = {EventRecord::ALLOCATE, requestIndex, 0, 0, time};
+    return append(record);
+}
+
+bool EventLogWriter::logOccupy(int requestIndex, int time) {
+    EventRecord record = {EventRecord::OCCUPY, requestIndex, 0, 0, time};
+    return append(record);
+}
+
+bool EventLogWriter::logRelease(int requestIndex, int exitTime) {
+    EventRecord record = {EventRecord::RELEASE, requestIndex, 0, 0, exitTime};
+    return append(record);
+}
+
+bool EventLogWriter::logCancel(int requestIndex, int time) {
+    EventRecord record = {EventRecord::CANCEL, requestIndex, 0, 0, time};
+    return append(record);
+}
+
+bool EventLogWriter::logRollback(int k, int time) {
+    EventRecord record = {EventRecord::ROLLBACK, -1, k, 0, time};
+    return append(record);
+}
+
+bool EventLogWriter::flush() {
+    if (file == nullptr) {
+        return false;
+    }
+    if (buffered > 0) {
+        size_t written = std::fwrite(buffer, sizeof(EventRecord), buffered, file);
+        if (written != static_cast<size_t>(buffered)) {
+            return false;
+        }
+        buffered = 0;
+    }
+    return std::fflush(file) == 0;
+}
+
+bool EventLogWriter::close() {
+    if (file == nullptr) {
+        return true;
+    }
+    bool ok = flush();
+    ok = (std::fclose(file) == 0) && ok;
+    file = nullptr;
+    return ok;
+}
+
+long long EventLogWriter::getNumWritten() const {
+    return numWritten;
+}
+
+EventLogReader::EventLogReader(bool mapped) {
+    useMapping = mapped;
+    file = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+    mappedRecords = nullptr;
+    numRecords = 0;
+    position = 0;
+}
+
+EventLogReader::~EventLogReader() {
+    close();
+}
+
+// Check a header read from a file
+static bool validHeader(const EventLogHeader& header) {
+    return std::memcmp(header.magic, EVENT_LOG_MAGIC, 4) == 0 &&
+           header.version == EventLogHeader::VERSION &&
+           header.recordSize == static_cast<int>(sizeof(EventRecord));
+}
+
+bool EventLogReader::open(const char* path) {
+    close();
+
+#if defined(EVENT_LOG_HAS_MMAP)
+    if (useMapping) {
+        int fd = ::open(path, O_RDONLY);
+        if (fd == -1) {
+            return false;
+        }
+        struct stat info;
+        if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(EventLogHeader)) {
+            ::close(fd);
+            return false;
+        }
+        size_t size = static_cast<size_t>(info.st_size);
+        void* base = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);  // The mapping keeps the file open
+        if (base == MAP_FAILED) {
+            return false;
+        }
+        if (!validHeader(*static_cast<const EventLogHeader*>(base))) {
+            munmap(base, size);
+            return false;
+        }
+        madvise(base, size, MADV_SEQUENTIAL);
+        mapping = base;
+        mappingSize = size;
+        mappedRecords = reinterpret_cast<const EventRecord*>(static_cast<const char*>(base) + sizeof(EventLogHeader));
+        numRecords = static_cast<long long>((size - sizeof(EventLogHeader)) / sizeof(EventRecord));
+        position = 0;
+        return true;
+    }
+#endif
+
+    // Streaming: records are read block by block into the buffer
+    file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    EventLogHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 || !validHeader(header)) {
+        close();
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long size = std::ftell(file);
+    std::fseek(file, sizeof(EventLogHeader), SEEK_SET);
+    numRecords = (size - static_cast<long>(sizeof(EventLogHeader))) / static_cast<long>(sizeof(EventRecord));
+    position = 0;
+    return true;
+}
+
+int EventLogReader::next(const EventRecord** outRecords, int maxCount) {
+    long long remaining = numRecords - position;
+    if (remaining <= 0 || maxCount <= 0) {
+        return 0;
+    }
+    int count = (remaining < maxCount) ? static_cast<int>(remaining) : maxCount;
+
+    if (mappedRecords != nullptr) {
+        *outRecords = mappedRecords + position;
+        position += count;
+        return count;
+    }
+
+    if (file == nullptr) {
+        return 0;
+    }
+    if (count > BUFFER_RECORDS) {
+        count = BUFFER_RECORDS;
+    }
+    int read = static_cast<int>(std::fread(buffer, sizeof(EventRecord), count, file));
+    *outRecords = buffer;
+    position += read;
+    if (read < count) {
+        position = numRecords;  // Truncated file: stop after what was read
+    }
+    return read;
+}
+
+void EventLogReader::close() {
+#if defined(EVENT_LOG_HAS_MMAP)
+    if (mapping != nullptr) {
+        munmap(mapping, mappingSize);
+    }
+#endif
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+    file = nullptr;
+    mapping = nullptr;
+    mappingSize = 0;
+    mappedRecords = nullptr;
+    numRecords = 0;
+    position = 0;
+}
+
+long long EventLogReader::getNumRecords() const {
+    return numRecords;
+}
+
+bool EventLogReader::isMapped() const {
+    return mappedRecords != nullptr;
+}
@@ -0,0 +1,142 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <cstdio>
+
+// Compact binary log of gate events, for replaying a day of traffic through
+// ParkingSystem (see EventReplayer).
+//
+// File layout: a 16-byte header followed by fixed-width 20-byte records in
+// native byte order. Every record has the same size, so a reader can map
+// the file and walk the records as one flat array, and the number of
+// records follows from the file size.
+//
+// Requests are numbered by their position in the log: the n-th REQUEST
+// event creates request index n, and the other events refer to it.
+
+// One log record (20 bytes)
+struct EventRecord {
+    enum Type {
+        REQUEST = 1,   // New request: id, vehicleID = value1, zone = value2, time
+        ALLOCATE = 2,  // allocateForRequest(request)
+        OCCUPY = 3,    // occupyRequest(request)
+        RELEASE = 4,   // releaseRequest(request, time)
+        CANCEL = 5,    // cancelRequest(request)
+        ROLLBACK = 6   // rollbackLastK(value1)
+    };
+
+    int type;     // Type of the event
+    int request;  // Request index (REQUEST: requestID)
+    int value1;   // REQUEST: vehicleID, ROLLBACK: number of allocations
+    int value2;   // REQUEST: requested zone
+    int time;     // Event time (REQUEST: request time, RELEASE: exit time)
+};
+
+static_assert(sizeof(EventRecord) == 20, "EventRecord must stay 20 bytes");
+
+// File header (16 bytes)
+struct EventLogHeader {
+    char magic[4];   // "PKEV"
+    int version;     // Format version (EventLogHeader::VERSION)
+    int recordSize;  // sizeof(EventRecord) when written
+    int reserved;    // Always 0
+
+    static const int VERSION = 1;
+};
+
+static_assert(sizeof(EventLogHeader) == 16, "EventLogHeader must stay 16 bytes");
+
+// Appends records to a log file through a fixed in-memory buffer, so
+// logging an event never allocates
+class EventLogWriter {
+private:
+    static const int BUFFER_RECORDS = 4096;  // Records buffered before a write
+
+    FILE* file;                          // Open log file (nullptr if closed)
+    EventRecord buffer[BUFFER_RECORDS];  // Records not yet written
+    int buffered;                        // Number of records in buffer
+    long long numWritten;                // Records appended since open
+
+public:
+    // Constructor: No file open
+    EventLogWriter();
+
+    // Destructor: Flushes and closes the file
+    ~EventLogWriter();
+
+    // A writer owns its file, so it is not copyable
+    EventLogWriter(const EventLogWriter& other) = delete;
+    EventLogWriter& operator=(const EventLogWriter& other) = delete;
+
+    // Create (or truncate) a log file and write its header
+    bool open(const char* path);
+
+    // Append one record. Returns false if no file is open or a write failed
+    bool append(const EventRecord& record);
+
+    // Convenience appenders for each event type
+    bool logRequest(int requestID, int vehicleID, int requestedZone, int requestTime);
+    bool logAllocate(int requestIndex, int time);
+    bool logOccupy(int requestIndex, int time);
+    bool logRelease(int requestIndex, int exitTime);
+    bool logCancel(int requestIndex, int time);
+    bool logRollback(int k, int time);
+
+    // Write buffered records to the file
+    bool flush();
+
+    // Flush and close the file
+    bool close();
+
+    // Getter for records appended since open
+    long long getNumWritten() const;
+};
+
+// Reads a log file either by memory-mapping it (records are used in place)
+// or by streaming it through a fixed buffer. Either way, reading never
+// allocates per record
+class EventLogReader {
+private:
+    static const int BUFFER_RECORDS = 4096;  // Records per streamed block
+
+    bool useMapping;                     // Map the file when the platform supports it
+    FILE* file;                          // Streamed file (nullptr when mapped or closed)
+    void* mapping;                       // Mapped file (nullptr when streamed or closed)
+    size_t mappingSize;                  // Bytes mapped
+    const EventRecord* mappedRecords;    // First record in the mapping
+    long long numRecords;                // Records in the file
+    long long position;                  // Records handed out so far
+    EventRecord buffer[BUFFER_RECORDS];  // Streaming buffer
+
+public:
+    // Constructor: mapped selects memory mapping (falls back to streaming
+    // where mapping is unavailable)
+    EventLogReader(bool mapped = true);
+
+    // Destructor: Closes the file
+    ~EventLogReader();
+
+    // A reader owns its file or mapping, so it is not copyable
+    EventLogReader(const EventLogReader& other) = delete;
+    EventLogReader& operator=(const EventLogReader& other) = delete;
+
+    // Open a log file and check its header. Returns false if the file is
+    // missing, not an event log, or of another version or record size
+    bool open(const char* path);
+
+    // Next block of records: points outRecords at up to maxCount records
+    // and returns how many (0 at the end). The block stays valid until the
+    // next call (mapped: until close)
+    int next(const EventRecord** outRecords, int maxCount);
+
+    // Close the file or mapping
+    void close();
+
+    // Getter for number of records in the file
+    long long getNumRecords() const;
+
+    // Check if the open file is memory-mapped
+    bool isMapped() const;
+};
+
+#endif // EVENT_LOG_H
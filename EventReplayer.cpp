@@ -0,0 +1,75 @@
+#include "EventReplayer.h"
+#include <chrono>
+
+EventReplayer::EventReplayer(ParkingSystem* target) {
+    system = target;
+    firstRequest = target->getNumRequests();
+    numLogged = 0;
+}
+
+int EventReplayer::apply(const EventRecord& record) {
+    if (record.type == EventRecord::REQUEST) {
+        ParkingRequest req;
+        req.setRequestID(record.request);
+        req.setVehicleID(record.value1);
+        req.setRequestedZone(record.value2);
+        req.setRequestTime(record.time);
+        system->addRequest(req);
+        numLogged++;
+        return 1;
+    }
+    if (record.type == EventRecord::ROLLBACK) {
+        if (record.value1 < 0) {
+            return -1;
+        }
+        int before = system->getRollbackHistorySize();
+        system->rollbackLastK(record.value1);
+        return (system->getRollbackHistorySize() < before) ? 1 : 0;
+    }
+
+    // Every other event refers to a request logged earlier
+    if (record.request < 0 || record.request >= numLogged) {
+        return -1;
+    }
+    int requestIndex = firstRequest + record.request;
+    switch (record.type) {
+        case EventRecord::ALLOCATE:
+            return (system->allocateForRequest(requestIndex) != -1) ? 1 : 0;
+        case EventRecord::OCCUPY:
+            return system->occupyRequest(requestIndex) ? 1 : 0;
+        case EventRecord::RELEASE:
+            return system->releaseRequest(requestIndex, record.time) ? 1 : 0;
+        case EventRecord::CANCEL:
+            return system->cancelRequest(requestIndex) ? 1 : 0;
+        default:
+            return -1;  // Unknown event type
+    }
+}
+
+ReplayStats EventReplayer::replay(EventLogReader& reader) {
+    ReplayStats stats;
+    stats.events = 0;
+    stats.applied = 0;
+    stats.rejected = 0;
+    stats.invalid = 0;
+
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    const EventRecord* block = nullptr;
+    int count;
+    while ((count = reader.next(&block, BLOCK_RECORDS)) > 0) {
+        for (int i = 0; i < count; i++) {
+            int result = apply(block[i]);
+            if (result > 0) {
+                stats.applied++;
+            } else if (result == 0) {
+                stats.rejected++;
+            } else {
+                stats.invalid++;
+            }
+        }
+        stats.events += count;
+    }
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    stats.seconds = elapsed.count();
+    return stats;
+}
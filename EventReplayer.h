@@ -0,0 +1,43 @@
+#ifndef EVENT_REPLAYER_H
+#define EVENT_REPLAYER_H
+
+#include "EventLog.h"
+#include "ParkingSystem.h"
+
+// Result of one replay run
+struct ReplayStats {
+    long long events;    // Records read
+    long long applied;   // Events that took effect (allocation found a slot, transition applied)
+    long long rejected;  // Valid events that had no effect (no slot, invalid transition)
+    long long invalid;   // Records with an unknown type or request index
+    double seconds;      // Wall time spent replaying
+};
+
+// Drives a ParkingSystem from an event log: REQUEST events become
+// addRequest calls, the others call allocateForRequest, the request
+// lifecycle calls and rollbackLastK. Records are consumed in blocks
+// straight from the reader, so replay does no per-event allocation
+// (request storage still grows geometrically).
+
+class EventReplayer {
+private:
+    static const int BLOCK_RECORDS = 4096;  // Records requested from the reader at a time
+
+    ParkingSystem* system;  // System the events are applied to (not owned)
+    int firstRequest;       // Request index of the log's first REQUEST event
+    int numLogged;          // REQUEST events replayed so far
+
+    // Apply one record. Returns 1 if applied, 0 if rejected, -1 if invalid
+    int apply(const EventRecord& record);
+
+public:
+    // Constructor: Replays into a system. Logged request numbers start at
+    // the system's current request count, so a log can continue a system
+    // that already holds requests
+    EventReplayer(ParkingSystem* target);
+
+    // Replay every remaining record of an open reader
+    ReplayStats replay(EventLogReader& reader);
+};
+
+#endif // EVENT_REPLAYER_H
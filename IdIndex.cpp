@@ -0,0 +1,378 @@
+#include "IdIndex.h"
+#include <climits>
+
+IdIndex::IdIndex() {
+    table = nullptr;
+    keys = nullptr;
+    baseID = 0;
+    size = 0;
+    numMapped = 0;
+    arena = nullptr;
+}
+
+IdIndex::IdIndex(const IdIndex& other) {
+    baseID = other.baseID;
+    size = other.size;
+    numMapped = other.numMapped;
+    arena = nullptr;  // Copies live on the heap
+    table = nullptr;
+    keys = nullptr;
+    if (size > 0) {
+        table = new int[size];
+        for (int i = 0; i < size; i++) {
+            table[i] = other.table[i];
+        }
+        if (other.keys != nullptr) {
+            keys = new int[size];
+            for (int i = 0; i < size; i++) {
+                keys[i] = other.keys[i];
+            }
+        }
+    }
+}
+
+IdIndex& IdIndex::operator=(const IdIndex& other) {
+    if (this != &other) {
+        releaseTable();
+        baseID = other.baseID;
+        size = other.size;
+        numMapped = other.numMapped;
+        table = nullptr;
+        keys = nullptr;
+        if (size > 0) {
+            table = allocateTable(size);
+            for (int i = 0; i < size; i++) {
+                table[i] = other.table[i];
+            }
+            if (other.keys != nullptr) {
+                keys = allocateTable(size);
+                for (int i = 0; i < size; i++) {
+                    keys[i] = other.keys[i];
+                }
+            }
+        }
+    }
+    return *this;
+}
+
+IdIndex::IdIndex(IdIndex&& other) {
+    table = other.table;
+    keys = other.keys;
+    baseID = other.baseID;
+    size = other.size;
+    numMapped = other.numMapped;
+    arena = other.arena;
+    other.table = nullptr;
+    other.keys = nullptr;
+    other.size = 0;
+    other.numMapped = 0;
+}
+
+IdIndex& IdIndex::operator=(IdIndex&& other) {
+    if (this != &other) {
+        releaseTable();
+        table = other.table;
+        keys = other.keys;
+        baseID = other.baseID;
+        size = other.size;
+        numMapped = other.numMapped;
+        arena = other.arena;
+        other.table = nullptr;
+        other.keys = nullptr;
+        other.size = 0;
+        other.numMapped = 0;
+    }
+    return *this;
+}
+
+IdIndex::~IdIndex() {
+    releaseTable();
+    table = nullptr;
+    keys = nullptr;
+}
+
+int* IdIndex::allocateTable(int count) {
+    if (arena != nullptr) {
+        return arena->allocateArray<int>(count);
+    }
+    return new int[count];
+}
+
+void IdIndex::releaseTable() {
+    if (arena == nullptr) {
+        delete[] table;
+        delete[] keys;
+        return;
+    }
+    arena->releaseArray(table, size);  // Both arrays have size entries
+    arena->releaseArray(keys, size);
+}
+
+void IdIndex::moveToArena(Arena* target) {
+    if (target == arena) {
+        return;
+    }
+    int* newTable = nullptr;
+    int* newKeys = nullptr;
+    if (size > 0) {
+        newTable = (target != nullptr) ? target->allocateArray<int>(size) : new int[size];
+        for (int i = 0; i < size; i++) {
+            newTable[i] = table[i];
+        }
+        if (keys != nullptr) {
+            newKeys = (target != nullptr) ? target->allocateArray<int>(size) : new int[size];
+            for (int i = 0; i < size; i++) {
+                newKeys[i] = keys[i];
+            }
+        }
+    }
+    releaseTable();
+    arena = target;
+    table = newTable;
+    keys = newKeys;
+}
+
+int IdIndex::homeBucket(int id) const {
+    // Fibonacci hashing: multiply, then fold the high bits down
+    unsigned int h = static_cast<unsigned int>(id) * 2654435769u;
+    h ^= h >> 16;
+    return static_cast<int>(h & static_cast<unsigned int>(size - 1));
+}
+
+int IdIndex::findBucket(int id) const {
+    int mask = size - 1;
+    for (int b = homeBucket(id); table[b] != -1; b = (b + 1) & mask) {
+        if (keys[b] == id) {
+            return b;
+        }
+    }
+    return -1;
+}
+
+void IdIndex::rehash(int minBuckets) {
+    int buckets = 16;
+    while (buckets < minBuckets) {
+        buckets *= 2;
+    }
+    int* oldTable = table;
+    int* oldKeys = keys;
+    int oldSize = size;
+    int oldBase = baseID;
+    table = allocateTable(buckets);
+    keys = allocateTable(buckets);
+    size = buckets;
+    for (int b = 0; b < buckets; b++) {
+        table[b] = -1;
+    }
+    int mask = buckets - 1;
+    for (int i = 0; i < oldSize; i++) {
+        if (oldTable[i] == -1) {
+            continue;
+        }
+        int id = (oldKeys != nullptr) ? oldKeys[i] : oldBase + i;
+        int b = homeBucket(id);
+        while (table[b] != -1) {
+            b = (b + 1) & mask;
+        }
+        keys[b] = id;
+        table[b] = oldTable[i];
+    }
+    if (arena == nullptr) {
+        delete[] oldTable;
+        delete[] oldKeys;
+    } else {
+        arena->releaseArray(oldTable, oldSize);
+        arena->releaseArray(oldKeys, oldSize);
+    }
+}
+
+void IdIndex::resizeDirect(long long low, long long high) {
+    int newBase = static_cast<int>(low);
+    int newSize = static_cast<int>(high - low + 1);
+    int* newTable = allocateTable(newSize);
+    for (int i = 0; i < newSize; i++) {
+        newTable[i] = -1;
+    }
+    int offset = baseID - newBase;
+    for (int i = 0; i < size; i++) {
+        newTable[offset + i] = table[i];
+    }
+    releaseTable();
+    table = newTable;
+    baseID = newBase;
+    size = newSize;
+}
+
+void IdIndex::cover(int id) {
+    if (size == 0) {
+        // First ID: start a small window at this ID
+        size = 16;
+        baseID = id;
+        if (static_cast<long long>(baseID) + size - 1 > INT_MAX) {
+            baseID = INT_MAX - size + 1;
+        }
+        table = allocateTable(size);
+        for (int i = 0; i < size; i++) {
+            table[i] = -1;
+        }
+        return;
+    }
+
+    // Double the covered range (at least) towards the new ID
+    long long low = baseID;
+    long long high = static_cast<long long>(baseID) + size - 1;
+    if (id < low) {
+        low = low - size;
+        if (id < low) {
+            low = id;
+        }
+        if (low < INT_MIN) {
+            low = INT_MIN;
+        }
+    } else {
+        high = high + size;
+        if (id > high) {
+            high = id;
+        }
+        if (high > INT_MAX) {
+            high = INT_MAX;
+        }
+    }
+
+    // Too sparse for a direct table: hash the mapped IDs instead
+    if (high - low + 1 > static_cast<long long>(MAX_SPAN_PER_ID) * (numMapped + 1) + MIN_SPAN) {
+        rehash(2 * (numMapped + 1));
+        return;
+    }
+    resizeDirect(low, high);
+}
+
+void IdIndex::reserve(int minID, int maxID, int count) {
+    if (minID > maxID || count <= 0) {
+        return;
+    }
+    if (keys != nullptr) {
+        if (2 * (numMapped + count) > size) {
+            rehash(2 * (numMapped + count));
+        }
+        return;
+    }
+    long long low = (size > 0 && baseID < minID) ? baseID : minID;
+    long long high = (size > 0 && static_cast<long long>(baseID) + size - 1 > maxID)
+                         ? static_cast<long long>(baseID) + size - 1
+                         : maxID;
+    if (high - low + 1 > static_cast<long long>(MAX_SPAN_PER_ID) * (numMapped + count) + MIN_SPAN) {
+        rehash(2 * (numMapped + count));  // Also takes over any direct entries
+    } else if (size == 0 || low < baseID || high - baseID >= size) {
+        resizeDirect(low, high);
+    }
+}
+
+bool IdIndex::isHashed() const {
+    return keys != nullptr;
+}
+
+void IdIndex::set(int id, int value) {
+    if (keys == nullptr && (size == 0 || id < baseID || static_cast<long long>(id) - baseID >= size)) {
+        cover(id);
+    }
+    if (keys == nullptr) {
+        if (table[id - baseID] == -1) {
+            numMapped++;
+        }
+        table[id - baseID] = value;
+        return;
+    }
+
+    // Hashed: overwrite in place, or insert (keeping the buckets at most half full)
+    int b = findBucket(id);
+    if (b == -1) {
+        if (2 * (numMapped + 1) > size) {
+            rehash(2 * size);
+        }
+        b = homeBucket(id);
+        while (table[b] != -1) {
+            b = (b + 1) & (size - 1);
+        }
+        keys[b] = id;
+        numMapped++;
+    }
+    table[b] = value;
+}
+
+bool IdIndex::add(int id, int value) {
+    if (keys == nullptr && (size == 0 || id < baseID || static_cast<long long>(id) - baseID >= size)) {
+        cover(id);
+    }
+    if (keys == nullptr) {
+        if (table[id - baseID] != -1) {
+            return false;
+        }
+        table[id - baseID] = value;
+        numMapped++;
+        return true;
+    }
+
+    // Hashed: the probe for the ID ends at the bucket it would go to
+    if (2 * (numMapped + 1) > size) {
+        rehash(2 * size);
+    }
+    int mask = size - 1;
+    int b = homeBucket(id);
+    while (table[b] != -1) {
+        if (keys[b] == id) {
+            return false;
+        }
+        b = (b + 1) & mask;
+    }
+    keys[b] = id;
+    table[b] = value;
+    numMapped++;
+    return true;
+}
+
+void IdIndex::remove(int id) {
+    if (keys == nullptr) {
+        if (size > 0 && id >= baseID && static_cast<long long>(id) - baseID < size && table[id - baseID] != -1) {
+            table[id - baseID] = -1;
+            numMapped--;
+        }
+        return;
+    }
+    int hole = findBucket(id);
+    if (hole == -1) {
+        return;
+    }
+    // Backward-shift deletion: move later entries of the probe run into the
+    // hole unless they already sit between their home bucket and the hole
+    int mask = size - 1;
+    for (int b = (hole + 1) & mask; table[b] != -1; b = (b + 1) & mask) {
+        int home = homeBucket(keys[b]);
+        bool movable = (b > hole) ? (home <= hole || home > b) : (home <= hole && home > b);
+        if (movable) {
+            keys[hole] = keys[b];
+            table[hole] = table[b];
+            hole = b;
+        }
+    }
+    table[hole] = -1;
+    numMapped--;
+}
+
+int IdIndex::find(int id) const {
+    if (keys != nullptr) {
+        int b = findBucket(id);
+        return (b == -1) ? -1 : table[b];
+    }
+    if (size == 0 || id < baseID || static_cast<long long>(id) - baseID >= size) {
+        return -1;
+    }
+    return table[id - baseID];
+}
+
+void IdIndex::clear() {
+    for (int i = 0; i < size; i++) {
+        table[i] = -1;
+    }
+    numMapped = 0;
+}
@@ -0,0 +1,100 @@
+#ifndef ID_INDEX_H
+#define ID_INDEX_H
+
+#include "Arena.h"
+
+// Integer ID -> array position map.
+// IDs do not need to be contiguous (e.g. 101, 102, 201): while they are
+// dense enough, a direct-address table covers the range [baseID, baseID +
+// size) and grows geometrically in either direction, so lookups are a single
+// array read. A table wider than MAX_SPAN_PER_ID covered IDs per mapped ID
+// (e.g. IDs 1 and 1500000000) would cost more than a hash, so the index
+// switches to an open-addressing hash table (linear probing, at most half
+// full) and stays hashed. Unmapped IDs return -1.
+
+class IdIndex {
+private:
+    int* table;   // Direct: table[id - baseID] = mapped value or -1. Hashed: value per bucket (-1 = empty)
+    int* keys;    // Hashed: ID in each bucket (nullptr while direct)
+    int baseID;   // Direct: smallest ID covered by the table
+    int size;     // Direct: number of IDs covered; hashed: number of buckets (a power of two)
+    int numMapped;  // Number of mapped IDs
+    Arena* arena; // Arena the arrays come from (nullptr = heap)
+
+    // Allocate and release arrays from the arena or the heap
+    int* allocateTable(int count);
+    void releaseTable();
+
+    // Grow the table so that it covers the given ID (or switch to hashing if
+    // that table would be too sparse)
+    void cover(int id);
+
+    // Make the direct table cover exactly [low, high] (a superset of the
+    // current range), keeping the mapped entries
+    void resizeDirect(long long low, long long high);
+
+    // Replace the direct table (or the current buckets) with a hash table
+    // of at least the given number of buckets
+    void rehash(int minBuckets);
+
+    // Bucket an ID hashes to
+    int homeBucket(int id) const;
+
+    // Bucket holding an ID (-1 if not mapped); hashed mode only
+    int findBucket(int id) const;
+
+public:
+    // Direct tables never need to cover more than this many IDs per mapped
+    // ID (plus MIN_SPAN): a hash bucket pair costs 8 bytes and the buckets
+    // are at most half full, so beyond 4 covered IDs (16 bytes) per mapped
+    // ID the hash is smaller
+    static const int MAX_SPAN_PER_ID = 4;
+    static const int MIN_SPAN = 64;
+
+    // Constructor: Creates an empty index
+    IdIndex();
+
+    // Copy constructor
+    IdIndex(const IdIndex& other);
+
+    // Copy assignment operator
+    IdIndex& operator=(const IdIndex& other);
+
+    // Move constructor (takes over the table, leaves other empty)
+    IdIndex(IdIndex&& other);
+
+    // Move assignment operator
+    IdIndex& operator=(IdIndex&& other);
+
+    // Destructor
+    ~IdIndex();
+
+    // Map an ID to a value (>= 0; overwrites any previous mapping)
+    void set(int id, int value);
+
+    // Map an ID to a value (>= 0) unless it is mapped already, in one probe.
+    // Returns false (keeping the old mapping) if the ID was mapped
+    bool add(int id, int value);
+
+    // Remove the mapping for an ID
+    void remove(int id);
+
+    // Look up the value mapped to an ID (-1 if not mapped)
+    int find(int id) const;
+
+    // Remove all mappings
+    void clear();
+
+    // Prepare for a bulk load of count IDs in [minID, maxID]: a direct table
+    // covering the range up front if it is dense enough, otherwise a hash
+    // table with room for count IDs, so the load never grows step by step
+    void reserve(int minID, int maxID, int count);
+
+    // True once the index has switched to hashing
+    bool isHashed() const;
+
+    // Move the table into an arena (nullptr = heap); later growth also uses it
+    void moveToArena(Arena* target);
+};
+
+#endif // ID_INDEX_H
@@ -0,0 +1,145 @@
+#include "Instrumentation.h"
+
+static const char* const OPERATION_NAMES[OP_COUNT] = {
+    "allocate_same_zone", "allocate_cross_zone", "allocate_failed", "allocate_batch",
+    "occupy", "release", "cancel", "rollback", "redo", "advance_time",
+    "query_counters", "query_zone", "query_peak", "query_duration"
+};
+
+const char* operationName(int operation) {
+    if (operation < 0 || operation >= OP_COUNT) {
+        return "unknown";
+    }
+    return OPERATION_NAMES[operation];
+}
+
+// Position of the highest set bit (value > 0)
+static int highestBit(unsigned long long value) {
+#if defined(__GNUC__) || defined(__clang__)
+    return 63 - __builtin_clzll(value);
+#else
+    int bit = 0;
+    while (value >>= 1) {
+        bit++;
+    }
+    return bit;
+#endif
+}
+
+int HistogramSnapshot::bucketOf(unsigned long long value) {
+    if (value < static_cast<unsigned long long>(LINEAR_LIMIT)) {
+        return static_cast<int>(value);
+    }
+    unsigned long long cap = (1ULL << MAX_EXPONENT) - 1;
+    if (value > cap) {
+        value = cap;
+    }
+    int exponent = highestBit(value);
+    int sub = static_cast<int>((value >> (exponent - SUB_BUCKET_BITS)) & ((1 << SUB_BUCKET_BITS) - 1));
+    return LINEAR_LIMIT + (exponent - SUB_BUCKET_BITS - 1) * (1 << SUB_BUCKET_BITS) + sub;
+}
+
+unsigned long long HistogramSnapshot::bucketLimit(int bucket) {
+    if (bucket < LINEAR_LIMIT) {
+        return static_cast<unsigned long long>(bucket);
+    }
+    int exponent = (bucket - LINEAR_LIMIT) / (1 << SUB_BUCKET_BITS) + SUB_BUCKET_BITS + 1;
+    int sub = (bucket - LINEAR_LIMIT) % (1 << SUB_BUCKET_BITS);
+    int shift = exponent - SUB_BUCKET_BITS;
+    unsigned long long lower = static_cast<unsigned long long>((1 << SUB_BUCKET_BITS) + sub) << shift;
+    return lower + (1ULL << shift) - 1;
+}
+
+unsigned long long HistogramSnapshot::percentile(double p) const {
+    if (count == 0) {
+        return 0;
+    }
+    // Nearest rank, as in bench_macro
+    unsigned long long rank = static_cast<unsigned long long>(p / 100.0 * count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    unsigned long long seen = 0;
+    for (int b = 0; b < BUCKETS; b++) {
+        seen += counts[b];
+        if (seen >= rank) {
+            unsigned long long limit = bucketLimit(b);
+            return (limit < max) ? limit : max;
+        }
+    }
+    return max;
+}
+
+double HistogramSnapshot::mean() const {
+    return (count > 0) ? static_cast<double>(sum) / count : 0.0;
+}
+
+LatencyHistogram::LatencyHistogram() {
+    reset();
+}
+
+void LatencyHistogram::record(unsigned long long nanoseconds) {
+    counts[HistogramSnapshot::bucketOf(nanoseconds)].fetch_add(1, std::memory_order_relaxed);
+    sum.fetch_add(nanoseconds, std::memory_order_relaxed);
+    // Min and max only change on a new extreme, so the compare-exchange
+    // loops rarely run
+    unsigned long long seen = min.load(std::memory_order_relaxed);
+    while (nanoseconds < seen && !min.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+    seen = max.load(std::memory_order_relaxed);
+    while (nanoseconds > seen && !max.compare_exchange_weak(seen, nanoseconds, std::memory_order_relaxed)) {
+    }
+}
+
+void LatencyHistogram::snapshot(HistogramSnapshot* out) const {
+    out->count = 0;
+    for (int b = 0; b < HistogramSnapshot::BUCKETS; b++) {
+        out->counts[b] = counts[b].load(std::memory_order_relaxed);
+        out->count += out->counts[b];
+    }
+    out->sum = sum.load(std::memory_order_relaxed);
+    out->min = (out->count > 0) ? min.load(std::memory_order_relaxed) : 0;
+    out->max = max.load(std::memory_order_relaxed);
+}
+
+void LatencyHistogram::reset() {
+    for (int b = 0; b < HistogramSnapshot::BUCKETS; b++) {
+        counts[b].store(0, std::memory_order_relaxed);
+    }
+    sum.store(0, std::memory_order_relaxed);
+    min.store(~0ULL, std::memory_order_relaxed);
+    max.store(0, std::memory_order_relaxed);
+}
+
+void InstrumentationSnapshot::dump(std::ostream& out) const {
+    out << "operation\tcalls\tmean_ns\tp50_ns\tp90_ns\tp99_ns\tp999_ns\tmax_ns\n";
+    for (int op = 0; op < OP_COUNT; op++) {
+        const HistogramSnapshot& h = operations[op];
+        if (h.count == 0) {
+            continue;
+        }
+        out << operationName(op) << "\t" << h.count << "\t" << static_cast<unsigned long long>(h.mean())
+            << "\t" << h.percentile(50.0) << "\t" << h.percentile(90.0) << "\t" << h.percentile(99.0)
+            << "\t" << h.percentile(99.9) << "\t" << h.max << "\n";
+    }
+}
+
+void Instrumentation::record(int operation, Clock::time_point start, Clock::time_point end) {
+    long long elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+    histograms[operation].record(elapsed > 0 ? static_cast<unsigned long long>(elapsed) : 0);
+}
+
+void Instrumentation::snapshot(InstrumentationSnapshot* out) const {
+    for (int op = 0; op < OP_COUNT; op++) {
+        histograms[op].snapshot(&out->operations[op]);
+    }
+}
+
+void Instrumentation::reset() {
+    for (int op = 0; op < OP_COUNT; op++) {
+        histograms[op].reset();
+    }
+}
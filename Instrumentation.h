@@ -0,0 +1,158 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+#include <atomic>
+#include <chrono>
+#include <ostream>
+
+// Optional latency instrumentation for ParkingSystem's hot operations.
+//
+// Built with PARKING_INSTRUMENTATION defined, ParkingSystem times every
+// instrumented call and records it in a per-operation latency histogram
+// (call count, sum, min, max and log-bucketed latencies). Without it the
+// timing macros expand to nothing and no clock is read, so the fast path
+// pays nothing; the snapshot/reset/dump API then reports "disabled".
+//
+// Histograms are HDR-style: values below 32 ns get one bucket each, and
+// every power of two above that is split into 16 equal sub-buckets, so any
+// recorded value is off by at most 1/16 (6.25%) while the whole range up to
+// 2^40 ns (about 18 minutes) fits in 592 counters. Recording is two clock
+// reads, a bit scan and two relaxed atomic increments (the call count is
+// the sum of the buckets), so several threads can record concurrently
+// without a lock.
+
+// Instrumented operations
+enum InstrumentedOperation {
+    OP_ALLOCATE_SAME_ZONE = 0,  // Allocation served by the requested zone
+    OP_ALLOCATE_CROSS_ZONE,     // Allocation served by another zone (penalty)
+    OP_ALLOCATE_FAILED,         // Allocation that found no slot
+    OP_ALLOCATE_BATCH,          // allocateBatch (one sample per batch)
+    OP_OCCUPY,                  // occupyRequest
+    OP_RELEASE,                 // releaseRequest
+    OP_CANCEL,                  // cancelRequest
+    OP_ROLLBACK,                // rollbackLastK (and rollbackLast)
+    OP_REDO,                    // redoLastK
+    OP_ADVANCE_TIME,            // advanceTime (request timers)
+    OP_QUERY_COUNTERS,          // Slot and request counter getters
+    OP_QUERY_ZONE,              // getZoneUtilization
+    OP_QUERY_PEAK,              // getPeakUsageZone and getTopUsageZones
+    OP_QUERY_DURATION,          // getAverageParkingDuration
+    OP_COUNT                    // Number of operations
+};
+
+// Name of an operation, as printed by the text dump
+const char* operationName(int operation);
+
+// Plain copy of one histogram, taken by LatencyHistogram::snapshot
+struct HistogramSnapshot {
+    static const int SUB_BUCKET_BITS = 4;                          // 16 sub-buckets per power of two
+    static const int LINEAR_LIMIT = 2 << SUB_BUCKET_BITS;          // Values below this get their own bucket
+    static const int MAX_EXPONENT = 40;                            // Values are capped below 2^40 ns
+    static const int BUCKETS = LINEAR_LIMIT + (MAX_EXPONENT - SUB_BUCKET_BITS - 1) * (1 << SUB_BUCKET_BITS);
+
+    unsigned long long counts[BUCKETS];  // Samples per bucket
+    unsigned long long count;            // Samples recorded
+    unsigned long long sum;              // Sum of all samples (ns)
+    unsigned long long min;              // Smallest sample (ns), 0 if none
+    unsigned long long max;              // Largest sample (ns)
+
+    // Bucket that holds a value
+    static int bucketOf(unsigned long long value);
+
+    // Largest value that falls into a bucket
+    static unsigned long long bucketLimit(int bucket);
+
+    // Value at a percentile (0-100): the upper limit of the bucket holding
+    // that rank, capped at max. 0 if no samples
+    unsigned long long percentile(double p) const;
+
+    // Mean sample (ns), 0 if no samples
+    double mean() const;
+};
+
+// Log-bucketed latency histogram that threads can record into concurrently
+class LatencyHistogram {
+private:
+    std::atomic<unsigned long long> counts[HistogramSnapshot::BUCKETS];  // Samples per bucket (their sum is the count)
+    std::atomic<unsigned long long> sum;    // Sum of all samples
+    std::atomic<unsigned long long> min;    // Smallest sample (~0 if none)
+    std::atomic<unsigned long long> max;    // Largest sample
+
+public:
+    // Constructor: Empty histogram
+    LatencyHistogram();
+
+    // Record one sample (ns), O(1)
+    void record(unsigned long long nanoseconds);
+
+    // Copy the current counts (not atomic as a whole: samples recorded
+    // during the copy may be partly included)
+    void snapshot(HistogramSnapshot* out) const;
+
+    // Forget every sample
+    void reset();
+};
+
+// Histograms of every operation, as returned by ParkingSystem::getInstrumentation
+struct InstrumentationSnapshot {
+    HistogramSnapshot operations[OP_COUNT];  // Indexed by InstrumentedOperation
+
+    // Text dump: one line per operation that was called, with count, mean,
+    // p50/p90/p99/p99.9 and max in ns
+    void dump(std::ostream& out) const;
+};
+
+// One histogram per instrumented operation
+class Instrumentation {
+private:
+    LatencyHistogram histograms[OP_COUNT];  // Indexed by InstrumentedOperation
+
+public:
+    typedef std::chrono::steady_clock Clock;
+
+    // Record one call of an operation
+    void record(int operation, Clock::time_point start, Clock::time_point end);
+
+    // Copy every histogram
+    void snapshot(InstrumentationSnapshot* out) const;
+
+    // Forget every sample
+    void reset();
+};
+
+// Times a scope and records it on exit (the operation can be changed before
+// then, e.g. once an allocation knows whether it crossed zones)
+class OperationTimer {
+private:
+    Instrumentation* target;           // Where the sample goes
+    int operation;                     // Operation recorded on exit
+    Instrumentation::Clock::time_point start;  // Time the scope was entered
+
+public:
+    OperationTimer(Instrumentation* instrumentation, int op)
+        : target(instrumentation), operation(op), start(Instrumentation::Clock::now()) {}
+
+    ~OperationTimer() {
+        target->record(operation, start, Instrumentation::Clock::now());
+    }
+
+    OperationTimer(const OperationTimer& other) = delete;
+    OperationTimer& operator=(const OperationTimer& other) = delete;
+
+    // Change the operation recorded on exit
+    void setOperation(int op) {
+        operation = op;
+    }
+};
+
+// Timing hooks used inside ParkingSystem. Compiled out unless
+// PARKING_INSTRUMENTATION is defined
+#if defined(PARKING_INSTRUMENTATION)
+#define PARKING_TIME_OPERATION(op) OperationTimer parkingOperationTimer(instrumentation, op)
+#define PARKING_SET_OPERATION(op) parkingOperationTimer.setOperation(op)
+#else
+#define PARKING_TIME_OPERATION(op) ((void)0)
+#define PARKING_SET_OPERATION(op) ((void)0)
+#endif
+
+#endif // INSTRUMENTATION_H
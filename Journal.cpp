@@ -0,0 +1,276 @@
+#include "Journal.h"
+#include <chrono>
+#include <cstring>
+
+#if defined(_WIN32)
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
+
+static const char JOURNAL_MAGIC[4] = {'P', 'K', 'J', 'N'};
+
+// Flush stdio buffers and force the file's data to disk
+static bool syncFile(FILE* file) {
+    if (std::fflush(file) != 0) {
+        return false;
+    }
+#if defined(_WIN32)
+    return _commit(_fileno(file)) == 0;
+#elif defined(__linux__)
+    return fdatasync(fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+Journal::Journal(int groupSize, int commitInterval) {
+    file = nullptr;
+    path = nullptr;
+    groupRecords = (groupSize > 0) ? groupSize : 1;
+    commitMicros = (commitInterval > 0) ? commitInterval : 1;
+    buffers[0] = new JournalRecord[groupRecords];
+    buffers[1] = new JournalRecord[groupRecords];
+    active = 0;
+    activeCount = 0;
+    nextSequence = 1;
+    durableSequence = 0;
+    numCommits = 0;
+    syncRequested = false;
+    committing = false;
+    stopping = false;
+    failed = false;
+}
+
+Journal::~Journal() {
+    close();
+    delete[] buffers[0];
+    delete[] buffers[1];
+}
+
+bool Journal::writeHeader(long long firstSequence) {
+    JournalHeader header;
+    std::memcpy(header.magic, JOURNAL_MAGIC, 4);
+    header.version = JournalHeader::VERSION;
+    header.recordSize = sizeof(JournalRecord);
+    header.reserved = 0;
+    header.firstSequence = firstSequence;
+    return std::fwrite(&header, sizeof(header), 1, file) == 1 && syncFile(file);
+}
+
+bool Journal::open(const char* journalPath, long long firstSequence) {
+    close();
+    file = std::fopen(journalPath, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    path = new char[std::strlen(journalPath) + 1];
+    std::strcpy(path, journalPath);
+    nextSequence = (firstSequence > 0) ? firstSequence : 1;
+    durableSequence = nextSequence - 1;
+    activeCount = 0;
+    numCommits = 0;
+    syncRequested = false;
+    stopping = false;
+    failed = false;
+    if (!writeHeader(nextSequence)) {
+        close();
+        return false;
+    }
+    committer = std::thread(&Journal::commitLoop, this);
+    return true;
+}
+
+void Journal::commitLoop() {
+    std::unique_lock<std::mutex> guard(lock);
+    while (true) {
+        wakeCommitter.wait_for(guard, std::chrono::microseconds(commitMicros), [this] {
+            return stopping || syncRequested || activeCount == groupRecords;
+        });
+        syncRequested = false;
+        if (activeCount == 0) {
+            if (stopping) {
+                break;
+            }
+            continue;
+        }
+
+        // Take the filled buffer; appends continue into the other one
+        JournalRecord* group = buffers[active];
+        int count = activeCount;
+        long long last = nextSequence - 1;
+        active = 1 - active;
+        activeCount = 0;
+
+        // Write and sync the whole group with one fsync, outside the lock
+        committing = true;
+        FILE* target = file;
+        guard.unlock();
+        bool ok = target != nullptr &&
+                  std::fwrite(group, sizeof(JournalRecord), count, target) == static_cast<size_t>(count) &&
+                  syncFile(target);
+        guard.lock();
+        committing = false;
+        if (ok && !failed) {
+            durableSequence = last;
+        } else {
+            failed = true;
+        }
+        numCommits++;
+        committed.notify_all();
+    }
+}
+
+long long Journal::append(JournalRecord& record) {
+    std::unique_lock<std::mutex> guard(lock);
+    if (file == nullptr) {
+        return 0;
+    }
+    // Both buffers full: wait for the group being synced
+    while (activeCount == groupRecords) {
+        wakeCommitter.notify_one();
+        committed.wait(guard);
+    }
+    record.sequence = nextSequence++;
+    buffers[active][activeCount++] = record;
+    if (activeCount == groupRecords) {
+        wakeCommitter.notify_one();
+    }
+    return record.sequence;
+}
+
+bool Journal::sync() {
+    std::unique_lock<std::mutex> guard(lock);
+    if (file == nullptr) {
+        return !failed;
+    }
+    long long target = nextSequence - 1;
+    while (durableSequence < target && !failed) {
+        syncRequested = true;
+        wakeCommitter.notify_one();
+        committed.wait(guard);
+    }
+    return !failed;
+}
+
+bool Journal::truncate() {
+    if (!sync()) {
+        return false;
+    }
+    std::unique_lock<std::mutex> guard(lock);
+    while (committing) {
+        committed.wait(guard);
+    }
+    if (file == nullptr) {
+        return false;
+    }
+    // Appends made since sync() returned are discarded with the rest: the
+    // caller holds every lock that appends run under
+    activeCount = 0;
+    durableSequence = nextSequence - 1;
+    file = std::freopen(path, "wb", file);
+    if (file == nullptr || !writeHeader(nextSequence)) {
+        failed = true;
+        return false;
+    }
+    return true;
+}
+
+bool Journal::close() {
+    if (committer.joinable()) {
+        {
+            std::unique_lock<std::mutex> guard(lock);
+            stopping = true;
+            wakeCommitter.notify_one();
+        }
+        // The committer commits what is left before it stops
+        committer.join();
+    }
+    bool ok = !failed;
+    if (file != nullptr) {
+        ok = (std::fclose(file) == 0) && ok;
+        file = nullptr;
+    }
+    delete[] path;
+    path = nullptr;
+    return ok;
+}
+
+long long Journal::getNextSequence() {
+    std::unique_lock<std::mutex> guard(lock);
+    return nextSequence;
+}
+
+long long Journal::getDurableSequence() {
+    std::unique_lock<std::mutex> guard(lock);
+    return durableSequence;
+}
+
+long long Journal::getNumCommits() {
+    std::unique_lock<std::mutex> guard(lock);
+    return numCommits;
+}
+
+bool Journal::hasFailed() {
+    std::unique_lock<std::mutex> guard(lock);
+    return failed;
+}
+
+JournalReader::JournalReader() {
+    file = nullptr;
+    expectedSequence = 1;
+    ended = true;
+}
+
+JournalReader::~JournalReader() {
+    close();
+}
+
+bool JournalReader::open(const char* path) {
+    close();
+    file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    JournalHeader header;
+    if (std::fread(&header, sizeof(header), 1, file) != 1 ||
+        std::memcmp(header.magic, JOURNAL_MAGIC, 4) != 0 || header.version != JournalHeader::VERSION ||
+        header.recordSize != static_cast<int>(sizeof(JournalRecord)) || header.firstSequence < 1) {
+        close();
+        return false;
+    }
+    expectedSequence = header.firstSequence;
+    ended = false;
+    return true;
+}
+
+int JournalReader::next(const JournalRecord** outRecords, int maxCount) {
+    if (file == nullptr || ended || maxCount <= 0) {
+        return 0;
+    }
+    int count = (maxCount < BUFFER_RECORDS) ? maxCount : BUFFER_RECORDS;
+    int read = static_cast<int>(std::fread(buffer, sizeof(JournalRecord), count, file));
+    if (read < count) {
+        ended = true;  // End of file (a partial last record is ignored)
+    }
+    // Keep the records up to the first one that breaks the sequence
+    int valid = 0;
+    while (valid < read && buffer[valid].sequence == expectedSequence &&
+           buffer[valid].type >= JournalRecord::REQUEST && buffer[valid].type <= JournalRecord::VEHICLE) {
+        expectedSequence++;
+        valid++;
+    }
+    if (valid < read) {
+        ended = true;  // Torn tail
+    }
+    *outRecords = buffer;
+    return valid;
+}
+
+void JournalReader::close() {
+    if (file != nullptr) {
+        std::fclose(file);
+    }
+    file = nullptr;
+    ended = true;
+}
@@ -0,0 +1,173 @@
+#ifndef JOURNAL_H
+#define JOURNAL_H
+
+#include <cstdio>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+// Write-ahead journal of the changes ParkingSystem makes between snapshots:
+// new vehicles and requests, allocations (with the slot taken), request transitions and
+// rollback/redo calls. Recovery loads the last snapshot and replays the
+// journal records it does not already contain (see
+// ParkingSystem::recover).
+//
+// File layout: a 24-byte header followed by fixed-width 40-byte records in
+// native byte order. Records carry consecutive sequence numbers starting at
+// the header's firstSequence; a torn or zero-filled tail left by a crash
+// breaks the sequence, and reading stops there.
+//
+// Group commit: appends go to an in-memory group buffer. A background
+// thread writes and fsyncs a whole group at once, when the group is full
+// or when the commit interval has passed since the last commit, so the
+// cost of one fsync is shared by every record in the group. While a group
+// is being synced, appends fill the other buffer; only when both are full
+// does an append wait. sync() waits until everything appended so far is on
+// disk.
+
+// One journal record (40 bytes)
+struct JournalRecord {
+    enum Type {
+        REQUEST = 1,   // addRequest: requestID, vehicleID, zone, request time, state, vehicle class
+        ALLOCATE = 2,  // Slot taken for a request: area index, slotID
+        OCCUPY = 3,    // occupyRequest
+        RELEASE = 4,   // releaseRequest: exit time
+        CANCEL = 5,    // cancelRequest
+        ROLLBACK = 6,  // rollbackLastK: k
+        REDO = 7,      // redoLastK: k
+        VEHICLE = 8    // addVehicle: vehicleID, preferred zone, vehicle class
+    };
+
+    long long sequence;  // Position in the journal (1, 2, 3, ...)
+    int type;            // Type of the change
+    int request;         // Request index (VEHICLE: vehicle index, ROLLBACK/REDO: -1)
+    int value1;          // REQUEST/VEHICLE: ID, ALLOCATE: area index, RELEASE: exit time, ROLLBACK/REDO: k
+    int value2;          // REQUEST: vehicleID, VEHICLE: preferred zone, ALLOCATE: slotID
+    int value3;          // REQUEST: requested zone, VEHICLE: vehicle class
+    int value4;          // REQUEST: request time
+    int value5;          // REQUEST: state the request was added in
+    int value6;          // REQUEST: vehicle class (0, the standard class, in journals written before it was recorded)
+};
+
+static_assert(sizeof(JournalRecord) == 40, "JournalRecord must stay 40 bytes");
+
+// File header (24 bytes)
+struct JournalHeader {
+    char magic[4];            // "PKJN"
+    int version;              // Format version (JournalHeader::VERSION)
+    int recordSize;           // sizeof(JournalRecord) when written
+    int reserved;             // Always 0
+    long long firstSequence;  // Sequence number of the first record
+
+    static const int VERSION = 1;
+};
+
+static_assert(sizeof(JournalHeader) == 24, "JournalHeader must stay 24 bytes");
+
+// Appends records with group commit (see above). append() and sync() may
+// be called from several threads
+class Journal {
+private:
+    FILE* file;                    // Open journal file (nullptr if closed)
+    char* path;                    // Path of the open file (for truncate)
+    int groupRecords;              // Records per group buffer
+    int commitMicros;              // Longest wait before a partial group is committed
+
+    JournalRecord* buffers[2];     // Group buffers: one filling, one being synced
+    int active;                    // Buffer appends go to
+    int activeCount;               // Records in the active buffer
+    long long nextSequence;        // Sequence of the next record appended
+    long long durableSequence;     // Last sequence written and synced
+    long long numCommits;          // Groups written and synced since open
+    bool syncRequested;            // sync() is waiting: commit without waiting for a full group
+    bool committing;               // The committer is writing a group (outside the lock)
+    bool stopping;                 // close() asked the committer to finish
+    bool failed;                   // A write or sync failed (records after it are not durable)
+
+    std::mutex lock;                       // Guards everything above
+    std::condition_variable wakeCommitter; // Group full, sync requested or stopping
+    std::condition_variable committed;     // A group was committed
+    std::thread committer;                 // Background commit thread
+
+    // Background loop: commit full (or timed-out) groups until stopped
+    void commitLoop();
+
+    // Write the file header for a journal starting at firstSequence
+    bool writeHeader(long long firstSequence);
+
+public:
+    static const int DEFAULT_GROUP_RECORDS = 16384;  // Default group size (640 KB)
+    static const int DEFAULT_COMMIT_MICROS = 2000;  // Default commit interval (2 ms)
+
+    // Constructor: groupSize records per group, commitInterval microseconds
+    // at most between a record being appended and its group being committed
+    Journal(int groupSize = DEFAULT_GROUP_RECORDS, int commitInterval = DEFAULT_COMMIT_MICROS);
+
+    // Destructor: Commits what is buffered and closes the file
+    ~Journal();
+
+    // A journal owns its file and thread, so it is not copyable
+    Journal(const Journal& other) = delete;
+    Journal& operator=(const Journal& other) = delete;
+
+    // Create (or truncate) a journal whose first record gets firstSequence
+    // and start the commit thread
+    bool open(const char* journalPath, long long firstSequence);
+
+    // Append one record (its sequence field is assigned here). Returns the
+    // sequence number, or 0 if no journal is open
+    long long append(JournalRecord& record);
+
+    // Commit everything appended so far and wait until it is on disk.
+    // Returns false if a write or sync failed
+    bool sync();
+
+    // Discard every record, keeping the sequence numbering (after a
+    // checkpoint snapshot made them redundant). Syncs first
+    bool truncate();
+
+    // Commit what is buffered, stop the commit thread and close the file
+    bool close();
+
+    // Getters
+    long long getNextSequence();     // Sequence the next record will get
+    long long getDurableSequence();  // Last sequence known to be on disk
+    long long getNumCommits();       // Groups committed (one fsync each) since open
+    bool hasFailed();                // True once a write or sync failed
+};
+
+// Reads a journal sequentially through a fixed buffer
+class JournalReader {
+private:
+    static const int BUFFER_RECORDS = 4096;  // Records per block read
+
+    FILE* file;                          // Open journal file (nullptr if closed)
+    long long expectedSequence;          // Sequence the next valid record must carry
+    bool ended;                          // Torn tail or end of file reached
+    JournalRecord buffer[BUFFER_RECORDS];  // Block buffer
+
+public:
+    // Constructor: No file open
+    JournalReader();
+
+    // Destructor: Closes the file
+    ~JournalReader();
+
+    // A reader owns its file, so it is not copyable
+    JournalReader(const JournalReader& other) = delete;
+    JournalReader& operator=(const JournalReader& other) = delete;
+
+    // Open a journal and check its header. Returns false if the file is
+    // missing, not a journal, or of another version or record size
+    bool open(const char* path);
+
+    // Next block of valid records: points outRecords at up to maxCount
+    // records and returns how many (0 at the end). Stops at the first
+    // record that is out of sequence or of unknown type (a torn tail)
+    int next(const JournalRecord** outRecords, int maxCount);
+
+    // Close the file
+    void close();
+};
+
+#endif // JOURNAL_H
@@ -1,11 +1,17 @@
 #include "ParkingArea.h"
+#include <utility>  // For std::move
 
 ParkingArea::ParkingArea() {
     areaID = 0;
     zoneID = 0;
     capacity = 10;  // Default capacity
     numSlots = 0;
-    slots = new ParkingSlot[capacity];
+    store = new SlotStore(capacity);
+    ownsStore = true;
+    first = store->reserve(capacity);
+    numFree = 0;
+    growthFactor = Arena::DEFAULT_GROWTH_FACTOR;
+    recountTypes();
 }
 
 ParkingArea::ParkingArea(int initialCapacity) {
@@ -13,51 +19,221 @@ ParkingArea::ParkingArea(int initialCapacity) {
     zoneID = 0;
     capacity = initialCapacity;
     numSlots = 0;
-    slots = nullptr;
-    slots = new ParkingSlot[capacity];
+    store = new SlotStore(capacity);
+    ownsStore = true;
+    first = store->reserve(capacity);
+    numFree = 0;
+    growthFactor = Arena::DEFAULT_GROWTH_FACTOR;
+    recountTypes();
 }
 
-ParkingArea::ParkingArea(const ParkingArea& other) {
+ParkingArea::ParkingArea(SlotStore* target, int initialCapacity) {
+    areaID = 0;
+    zoneID = 0;
+    capacity = initialCapacity;
+    numSlots = 0;
+    store = target;
+    ownsStore = false;
+    first = store->reserve(capacity);
+    numFree = 0;
+    growthFactor = Arena::DEFAULT_GROWTH_FACTOR;
+    recountTypes();
+    slotIndex.moveToArena(store->getArena());
+}
+
+void ParkingArea::copyFrom(const ParkingArea& other) {
+    spatialIndex.clear();  // Rebuilt on the copy's first nearest-slot query
+    typeIndex.clear();
     areaID = other.areaID;
     zoneID = other.zoneID;
     capacity = other.capacity;
     numSlots = other.numSlots;
-    slots = new ParkingSlot[capacity];
-    for (int i = 0; i < numSlots; i++) {
-        slots[i] = other.slots[i];
+    store = new SlotStore(capacity);
+    ownsStore = true;
+    first = store->reserve(capacity);
+    if (numSlots > 0) {
+        store->copySlots(first, *other.store, other.first, numSlots);
     }
+    numFree = other.numFree;
+    growthFactor = other.growthFactor;
+    slotIndex = IdIndex(other.slotIndex);  // Heap copy, like the private store
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        typeSlots[t] = other.typeSlots[t];
+        typeFree[t] = other.typeFree[t];
+    }
+}
+
+ParkingArea::ParkingArea(const ParkingArea& other) {
+    copyFrom(other);
 }
 
 ParkingArea& ParkingArea::operator=(const ParkingArea& other) {
     if (this != &other) {
-        if (slots != nullptr) {
-            delete[] slots;
+        SlotStore* oldStore = ownsStore ? store : nullptr;
+        copyFrom(other);
+        delete oldStore;
+    }
+    return *this;
+}
+
+ParkingArea::ParkingArea(ParkingArea&& other) : slotIndex(std::move(other.slotIndex)) {
+    areaID = other.areaID;
+    zoneID = other.zoneID;
+    store = other.store;
+    ownsStore = other.ownsStore;
+    first = other.first;
+    numSlots = other.numSlots;
+    capacity = other.capacity;
+    numFree = other.numFree;
+    growthFactor = other.growthFactor;
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        typeSlots[t] = other.typeSlots[t];
+        typeFree[t] = other.typeFree[t];
+    }
+    other.store = nullptr;
+    other.ownsStore = false;
+    other.numSlots = 0;
+    other.capacity = 0;
+    other.numFree = 0;
+    other.recountTypes();
+}
+
+ParkingArea& ParkingArea::operator=(ParkingArea&& other) {
+    if (this != &other) {
+        if (ownsStore) {
+            delete store;
         }
         areaID = other.areaID;
         zoneID = other.zoneID;
-        capacity = other.capacity;
+        store = other.store;
+        ownsStore = other.ownsStore;
+        first = other.first;
         numSlots = other.numSlots;
-        slots = new ParkingSlot[capacity];
-        for (int i = 0; i < numSlots; i++) {
-            slots[i] = other.slots[i];
+        capacity = other.capacity;
+        numFree = other.numFree;
+        growthFactor = other.growthFactor;
+        slotIndex = std::move(other.slotIndex);
+        spatialIndex.clear();  // Rebuilt on the first nearest-slot query
+        typeIndex.clear();     // Rebuilt on the first typed search
+        for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+            typeSlots[t] = other.typeSlots[t];
+            typeFree[t] = other.typeFree[t];
         }
+        other.store = nullptr;
+        other.ownsStore = false;
+        other.numSlots = 0;
+        other.capacity = 0;
+        other.numFree = 0;
+        other.recountTypes();
     }
     return *this;
 }
 
 ParkingArea::~ParkingArea() {
-    if (slots != nullptr) {
-        delete[] slots;
-        slots = nullptr;
+    if (ownsStore) {
+        delete store;
     }
+    store = nullptr;
 }
 
 void ParkingArea::addSlot(const ParkingSlot& slot) {
-    if (numSlots < capacity) {
-        slots[numSlots] = slot;
-        numSlots++;
+    if (store == nullptr) {
+        return;  // Moved-from area
+    }
+    if (numSlots == capacity) {
+        growRange(Arena::grownCapacity(capacity, numSlots + 1, growthFactor));
     }
-    // If capacity is full, do nothing
+    store->setSlot(first + numSlots, slot.getSlotID(), slot.getZoneID(), slot.getIsAvailable());
+    store->setCoordinates(first + numSlots, slot.getX(), slot.getY(), slot.getLevel());
+    store->setSlotType(first + numSlots, slot.getSlotType());
+    spatialIndex.clear();  // Stale once the area has a new slot
+    typeIndex.clear();
+    slotIndex.add(slot.getSlotID(), numSlots);  // First slot with an ID wins
+    typeSlots[slot.getSlotType()]++;
+    if (slot.getIsAvailable()) {
+        numFree++;
+        typeFree[slot.getSlotType()]++;
+    }
+    numSlots++;
+}
+
+void ParkingArea::growRange(int newCapacity) {
+    // The last range in the store grows in place; any other moves to a new
+    // range and gives the old one back for reuse
+    if (!store->extendRange(first, capacity, newCapacity)) {
+        int newFirst = store->reserve(newCapacity);
+        if (numSlots > 0) {
+            store->copySlots(newFirst, *store, first, numSlots);
+        }
+        store->releaseRange(first, capacity);
+        first = newFirst;
+    }
+    capacity = newCapacity;
+}
+
+void ParkingArea::setGrowthFactor(double factor) {
+    growthFactor = factor;
+}
+
+double ParkingArea::getGrowthFactor() const {
+    return growthFactor;
+}
+
+void ParkingArea::attachToStore(SlotStore* target) {
+    if (target == store) {
+        return;
+    }
+    // Reserve only the slots in use: spare capacity is not carried over, and
+    // addSlot grows the range again if needed
+    int newFirst = target->reserve(numSlots);
+    if (numSlots > 0) {
+        target->copySlots(newFirst, *store, first, numSlots);
+    }
+    if (ownsStore) {
+        delete store;
+    }
+    store = target;
+    ownsStore = false;
+    first = newFirst;
+    capacity = numSlots;
+    slotIndex.moveToArena(target->getArena());
+    spatialIndex.clear();  // Rebuilt from the new store (and its arena) on demand
+    typeIndex.clear();
+}
+
+void ParkingArea::restoreRange(int firstPosition, int count, int rangeCapacity) {
+    first = firstPosition;
+    numSlots = count;
+    capacity = rangeCapacity;
+    numFree = store->countFree(first, count);
+    slotIndex.clear();
+    spatialIndex.clear();
+    typeIndex.clear();
+    recountTypes();
+    int minID = 0;
+    int maxID = -1;
+    for (int i = 0; i < count; i++) {
+        int slotID = store->getSlotID(first + i);
+        minID = (i == 0 || slotID < minID) ? slotID : minID;
+        maxID = (i == 0 || slotID > maxID) ? slotID : maxID;
+    }
+    slotIndex.reserve(minID, maxID, count);
+    for (int i = 0; i < count; i++) {
+        int slotID = store->getSlotID(first + i);
+        slotIndex.add(slotID, i);  // First slot with an ID wins
+    }
+}
+
+int ParkingArea::getCapacity() const {
+    return capacity;
+}
+
+const SlotStore* ParkingArea::getStore() const {
+    return store;
+}
+
+int ParkingArea::getFirstPosition() const {
+    return first;
 }
 
 int ParkingArea::getAreaID() const {
@@ -78,34 +254,155 @@ void ParkingArea::setZoneID(int id) {
 
 // Find the first available slot by returning its slotID, or -1 if none available
 int ParkingArea::findFirstAvailableSlot() const {
-    for (int i = 0; i < numSlots; i++) {
-        if (slots[i].getIsAvailable()) {
-            return slots[i].getSlotID();
-        }
+    if (numFree == 0) {
+        return -1;  // No available slot found
+    }
+    int position = store->findFree(first, numSlots);
+    if (position == -1) {
+        return -1;  // No available slot found
+    }
+    return store->getSlotID(position);
+}
+
+// Find the first free slot of a type, or -1 if none available
+int ParkingArea::findFirstAvailableSlotOfType(int slotType) {
+    if (!isValidSlotType(slotType) || typeFree[slotType] == 0) {
+        return -1;  // No free slot of this type
+    }
+    if (typeSlots[slotType] == numSlots) {
+        return findFirstAvailableSlot();  // Every slot has this type: the store bitmap is its free structure
+    }
+    if (!typeIndex.isBuilt()) {
+        typeIndex.build(store, first, numSlots, store->getArena());
+    }
+    int offset = typeIndex.findFirst(slotType);
+    return (offset == -1) ? -1 : store->getSlotID(first + offset);
+}
+
+// Find the free slot nearest to a reference point, or -1 if none available
+int ParkingArea::findNearestAvailableSlot(int x, int y, int level) {
+    if (numFree == 0 || store == nullptr) {
+        return -1;
+    }
+    if (!spatialIndex.isBuilt()) {
+        buildSpatialIndex();
+    }
+    int offset = spatialIndex.findNearest(x, y, level);
+    return (offset == -1) ? -1 : store->getSlotID(first + offset);
+}
+
+// Find the free slot of a type nearest to a reference point, or -1 if none available
+int ParkingArea::findNearestAvailableSlotOfType(int x, int y, int level, int slotType, long long* levelGap,
+                                                long long* planarDistance) {
+    if (getAvailableSlotsOfType(slotType) == 0 || store == nullptr) {
+        return -1;
+    }
+    if (!spatialIndex.isBuilt()) {
+        buildSpatialIndex();
+    }
+    // Every slot has this type: no need to check each candidate's type
+    const unsigned char* types =
+        (typeSlots[slotType] == numSlots) ? nullptr : store->getSlotTypeColumn() + first;
+    int offset = spatialIndex.findNearestOfType(x, y, level, types, slotType, levelGap, planarDistance);
+    return (offset == -1) ? -1 : store->getSlotID(first + offset);
+}
+
+void ParkingArea::buildSpatialIndex() {
+    if (store != nullptr) {
+        spatialIndex.build(store, first, numSlots, store->getArena());
+    }
+}
+
+void ParkingArea::buildSearchIndexes() {
+    if (store == nullptr || numSlots == 0) {
+        return;
+    }
+    bool mixed = true;
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        mixed = mixed && typeSlots[t] != numSlots;
+    }
+    if (mixed && !typeIndex.isBuilt()) {
+        typeIndex.build(store, first, numSlots, store->getArena());
+    }
+    if (!spatialIndex.isBuilt()) {
+        buildSpatialIndex();
     }
-    return -1;  // No available slot found
 }
 
 // Mark a specific slot as occupied (not available)
-void ParkingArea::occupySlot(int slotID) {
-    for (int i = 0; i < numSlots; i++) {
-        if (slots[i].getSlotID() == slotID) {
-            slots[i].setIsAvailable(false);
-            return;
-        }
+bool ParkingArea::occupySlot(int slotID) {
+    int i = slotIndex.find(slotID);
+    if (i == -1 || !store->isFree(first + i)) {
+        return false;  // Unknown slot or already occupied
     }
-    // If slotID not found, do nothing
+    store->setFree(first + i, false);
+    numFree--;
+    onTypedOccupied(i);
+    if (spatialIndex.isBuilt()) {
+        spatialIndex.onOccupied(i);
+    }
+    return true;
 }
 
 // Mark a specific slot as free (available)
-void ParkingArea::freeSlot(int slotID) {
-    for (int i = 0; i < numSlots; i++) {
-        if (slots[i].getSlotID() == slotID) {
-            slots[i].setIsAvailable(true);
-            return;
+bool ParkingArea::freeSlot(int slotID) {
+    int i = slotIndex.find(slotID);
+    if (i == -1 || store->isFree(first + i)) {
+        return false;  // Unknown slot or already free
+    }
+    store->setFree(first + i, true);
+    numFree++;
+    onTypedFreed(i);
+    if (spatialIndex.isBuilt()) {
+        spatialIndex.onFreed(i);
+    }
+    return true;
+}
+
+bool ParkingArea::isSlotAvailable(int slotID) const {
+    int i = slotIndex.find(slotID);
+    return i != -1 && store->isFree(first + i);
+}
+
+int ParkingArea::claimFreeSlots(int maxCount, int* outSlotIDs) {
+    // Claim positions first, then translate them to slotIDs in place
+    int claimed = store->claimFree(first, numSlots, maxCount, outSlotIDs);
+    for (int k = 0; k < claimed; k++) {
+        onTypedOccupied(outSlotIDs[k] - first);
+        if (spatialIndex.isBuilt()) {
+            spatialIndex.onOccupied(outSlotIDs[k] - first);
         }
+        outSlotIDs[k] = store->getSlotID(outSlotIDs[k]);
     }
-    // If slotID not found, do nothing
+    numFree -= claimed;
+    return claimed;
+}
+
+int ParkingArea::claimFreeSlotsOfType(int slotType, int maxCount, int* outSlotIDs) {
+    if (!isValidSlotType(slotType) || typeFree[slotType] == 0) {
+        return 0;
+    }
+    if (typeSlots[slotType] == numSlots) {
+        return claimFreeSlots(maxCount, outSlotIDs);  // Single-type area: one pass over the store bitmap
+    }
+    if (!typeIndex.isBuilt()) {
+        typeIndex.build(store, first, numSlots, store->getArena());
+    }
+    int claimed = 0;
+    while (claimed < maxCount) {
+        int offset = typeIndex.findFirst(slotType);
+        if (offset == -1) {
+            break;
+        }
+        store->setFree(first + offset, false);
+        numFree--;
+        onTypedOccupied(offset);
+        if (spatialIndex.isBuilt()) {
+            spatialIndex.onOccupied(offset);
+        }
+        outSlotIDs[claimed++] = store->getSlotID(first + offset);
+    }
+    return claimed;
 }
 
 int ParkingArea::getNumSlots() const {
@@ -113,11 +410,70 @@ int ParkingArea::getNumSlots() const {
 }
 
 int ParkingArea::getAvailableSlots() const {
-    int count = 0;
+    return numFree;
+}
+
+int ParkingArea::getSlotsOfType(int slotType) const {
+    return isValidSlotType(slotType) ? typeSlots[slotType] : 0;
+}
+
+int ParkingArea::getAvailableSlotsOfType(int slotType) const {
+    return isValidSlotType(slotType) ? typeFree[slotType] : 0;
+}
+
+int ParkingArea::getSlotType(int slotID) const {
+    int i = slotIndex.find(slotID);
+    return (i == -1) ? -1 : store->getSlotType(first + i);
+}
+
+void ParkingArea::recountTypes() {
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        typeSlots[t] = 0;
+        typeFree[t] = 0;
+    }
     for (int i = 0; i < numSlots; i++) {
-        if (slots[i].getIsAvailable()) {
-            count++;
+        int type = store->getSlotType(first + i);
+        typeSlots[type]++;
+        if (store->isFree(first + i)) {
+            typeFree[type]++;
         }
     }
-    return count;
-}
\ No newline at end of file
+}
+
+void ParkingArea::onTypedOccupied(int offset) {
+    int type = store->getSlotType(first + offset);
+    typeFree[type]--;
+    if (typeIndex.isBuilt()) {
+        typeIndex.onOccupied(offset, type);
+    }
+}
+
+void ParkingArea::onTypedFreed(int offset) {
+    int type = store->getSlotType(first + offset);
+    typeFree[type]++;
+    if (typeIndex.isBuilt()) {
+        typeIndex.onFreed(offset, type);
+    }
+}
+
+bool ParkingArea::verifyTypeCounters() const {
+    int slots[NUM_SLOT_TYPES];
+    int free[NUM_SLOT_TYPES];
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        slots[t] = 0;
+        free[t] = 0;
+    }
+    for (int i = 0; i < numSlots; i++) {
+        int type = store->getSlotType(first + i);
+        slots[type]++;
+        if (store->isFree(first + i)) {
+            free[type]++;
+        }
+    }
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        if (slots[t] != typeSlots[t] || free[t] != typeFree[t]) {
+            return false;
+        }
+    }
+    return true;
+}
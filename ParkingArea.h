@@ -2,14 +2,53 @@
 #define PARKING_AREA_H
 
 #include "ParkingSlot.h"
+#include "SlotStore.h"
+#include "IdIndex.h"
+#include "SpatialGrid.h"
+#include "SlotTypeIndex.h"
+
+// A parking area is a view over a range of positions in a SlotStore.
+// A standalone area (built before being added to a ParkingSystem) owns a
+// private store; ParkingSystem::addArea moves its slots into the
+// facility-wide store, where the area's zone sees the same positions.
+// An area attached to an arena-backed store keeps its slot index (and its
+// spatial and slot-type indexes) in that arena too, so it owns no heap memory.
+//
+// Slots and free slots are also counted per slot type. Typed searches go
+// straight to a free slot of the wanted type: through the store's bitmap
+// when every slot of the area has that type, otherwise through a per-type
+// free index built on the first typed search.
 
 class ParkingArea {
 private:
     int areaID;
     int zoneID;
-    ParkingSlot* slots;  // Array of ParkingSlot objects
+    SlotStore* store;    // Slot columns holding this area's slots
+    bool ownsStore;      // True if store is private to this area
+    int first;           // Store position of the area's first slot
     int numSlots;        // Current number of slots
-    int capacity;        // Maximum capacity
+    int capacity;        // Maximum capacity (positions reserved in the store)
+    int numFree;         // Number of free slots (maintained counter)
+    double growthFactor; // Factor by which capacity grows when addSlot finds it full
+    IdIndex slotIndex;   // slotID -> offset from first, built by addSlot (hashed for sparse IDs)
+    SpatialGrid spatialIndex;  // Grid over slot coordinates, built by the first nearest-slot query
+    int typeSlots[NUM_SLOT_TYPES];  // Slots of each SlotType
+    int typeFree[NUM_SLOT_TYPES];   // Free slots of each SlotType (maintained counters)
+    SlotTypeIndex typeIndex;   // Per-type free bitmaps, built by the first typed search in a mixed-type area
+
+    // Move the slots to a larger range of the same store (offsets, and so
+    // slotIndex, are unchanged; the old range is cleared)
+    void growRange(int newCapacity);
+
+    // Become a standalone copy of another area with a private store
+    void copyFrom(const ParkingArea& other);
+
+    // Recount the per-type counters from the store
+    void recountTypes();
+
+    // Keep the per-type counters and index in step with one slot changing state
+    void onTypedOccupied(int offset);
+    void onTypedFreed(int offset);
 
 public:
     // Default constructor
@@ -18,18 +57,52 @@ public:
     // Constructor with initial capacity
     ParkingArea(int initialCapacity);
 
+    // Constructor that reserves the area's slots directly in an existing
+    // store (used by ParkingSystem::emplaceArea; the store is not owned)
+    ParkingArea(SlotStore* target, int initialCapacity);
+
     // Copy constructor
     ParkingArea(const ParkingArea& other);
 
     // Copy assignment operator
     ParkingArea& operator=(const ParkingArea& other);
 
+    // Move constructor (takes over the slots, leaves other empty)
+    ParkingArea(ParkingArea&& other);
+
+    // Move assignment operator
+    ParkingArea& operator=(ParkingArea&& other);
+
     // Destructor
     ~ParkingArea();
 
-    // Function to add a parking slot
+    // Function to add a parking slot (grows the capacity when full)
     void addSlot(const ParkingSlot& slot);
 
+    // Growth factor used when addSlot finds the area full (values <= 1 grow
+    // one slot at a time)
+    void setGrowthFactor(double factor);
+    double getGrowthFactor() const;
+
+    // Move this area's slots into a range of another store (e.g. the
+    // facility-wide store) and view that range from now on; the new range
+    // holds exactly the current slots
+    void attachToStore(SlotStore* target);
+
+    // Snapshot support: view count slots of the current store starting at
+    // firstPosition, with room for rangeCapacity (recounts free slots and
+    // rebuilds the index)
+    void restoreRange(int firstPosition, int count, int rangeCapacity);
+
+    // Getter for capacity (positions reserved in the store)
+    int getCapacity() const;
+
+    // Getter for the store holding this area's slots
+    const SlotStore* getStore() const;
+
+    // Getter for the store position of the area's first slot
+    int getFirstPosition() const;
+
     // Getter for areaID
     int getAreaID() const;
 
@@ -43,19 +116,77 @@ public:
     void setZoneID(int id);
 
     // Function to find the first available slot ID (-1 if none)
+    // Scans the store's availability bitmap one 64-bit word at a time
     int findFirstAvailableSlot() const;
 
-    // Function to mark a slot as occupied
-    void occupySlot(int slotID);
-
-    // Function to mark a slot as free
-    void freeSlot(int slotID);
+    // Function to find the first available slot of a slot type (-1 if none),
+    // without visiting slots of other types. Builds the per-type index on
+    // first use in an area that mixes slot types
+    int findFirstAvailableSlotOfType(int slotType);
+
+    // Function to find the free slot nearest to a reference point (e.g. the
+    // entrance or a lift), -1 if none. The fewest levels away wins, then the
+    // smallest planar distance, then the lowest position. Builds the spatial
+    // index on first use (and after slots were added), then answers from it
+    // without scanning the area
+    int findNearestAvailableSlot(int x, int y, int level);
+
+    // Function to find the free slot of a slot type nearest to a reference
+    // point that is strictly nearer than *levelGap / *planarDistance
+    // (LLONG_MAX: no bound), -1 if none. Stores the slot's level gap and
+    // squared planar distance there, so the nearest slot of several areas
+    // can be found by passing the same bound to each
+    int findNearestAvailableSlotOfType(int x, int y, int level, int slotType, long long* levelGap,
+                                       long long* planarDistance);
+
+    // Build (or rebuild) the spatial index now instead of on the first query
+    void buildSpatialIndex();
+
+    // Build the indexes searches would otherwise build on first use (the
+    // slot type index, in an area that mixes slot types, and the spatial
+    // index), so that later searches never allocate from the store's arena.
+    // ParkingSystem calls this for every area before concurrent searches start
+    void buildSearchIndexes();
+
+    // Function to mark a slot as occupied (O(1) via the slotID index)
+    // Returns true if the slot was free and is now occupied
+    bool occupySlot(int slotID);
+
+    // Function to mark a slot as free (O(1) via the slotID index)
+    // Returns true if the slot was occupied and is now free
+    bool freeSlot(int slotID);
+
+    // Function to check if a specific slot is available by slotID
+    bool isSlotAvailable(int slotID) const;
+
+    // Function to occupy up to maxCount free slots in one pass over the bitmap,
+    // lowest positions first (the same slots repeated findFirstAvailableSlot +
+    // occupySlot calls would pick). Writes their IDs to outSlotIDs and
+    // returns how many were occupied
+    int claimFreeSlots(int maxCount, int* outSlotIDs);
+
+    // Function to occupy up to maxCount free slots of one slot type, lowest
+    // positions first (the slots repeated findFirstAvailableSlotOfType +
+    // occupySlot calls would pick). Writes their IDs to outSlotIDs and
+    // returns how many were occupied
+    int claimFreeSlotsOfType(int slotType, int maxCount, int* outSlotIDs);
 
     // Getter for number of slots
     int getNumSlots() const;
 
-    // Getter for number of available slots
+    // Getter for number of available slots (O(1), maintained counter)
     int getAvailableSlots() const;
+
+    // Getters for the slots and available slots of a slot type (O(1),
+    // maintained counters; 0 for values outside SlotType)
+    int getSlotsOfType(int slotType) const;
+    int getAvailableSlotsOfType(int slotType) const;
+
+    // Function to get the type of a slot by slotID (-1 if unknown)
+    int getSlotType(int slotID) const;
+
+    // Self-check: recount the per-type counters from the store and compare
+    bool verifyTypeCounters() const;
 };
 
 #endif // PARKING_AREA_H
\ No newline at end of file
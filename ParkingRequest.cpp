@@ -1,57 +1,68 @@
 #include "ParkingRequest.h"
-#include <iostream>
+
+// Out-of-class definition of the table (C++11 needs it once the table is
+// indexed at run time)
+constexpr signed char ParkingRequest::TRANSITIONS[ParkingRequest::NUM_TRANSITIONS][ParkingRequest::NUM_STATES];
 
 ParkingRequest::ParkingRequest() {
     requestID = 0;
     vehicleID = 0;
     requestedZone = 0;
     requestTime = 0;
+    vehicleClass = VEHICLE_STANDARD;
     exitTime = 0;  // Not set until RELEASED
     currentState = REQUESTED;
+    allocatedArea = -1;
+    allocatedSlotID = -1;
 }
 
 ParkingRequest::~ParkingRequest() {
     // Destructor - no special cleanup needed
 }
 
-void ParkingRequest::allocate() {
-    // Transition from REQUESTED to ALLOCATED
-    // Valid only if current state is REQUESTED
-    if (currentState == REQUESTED) {
-        currentState = ALLOCATED;
-    } else {
-        std::cout << "Error: Can only allocate from REQUESTED state" << std::endl;
+ParkingRequest::TransitionStatus ParkingRequest::apply(Transition transition) {
+    int next = TRANSITIONS[transition][currentState];
+    if (next < 0) {
+        return TRANSITION_INVALID;
     }
+    currentState = static_cast<State>(next);
+    return TRANSITION_OK;
 }
 
-void ParkingRequest::occupy() {
-    // Transition from ALLOCATED to OCCUPIED
-    // Valid only if current state is ALLOCATED
-    if (currentState == ALLOCATED) {
-        currentState = OCCUPIED;
-    } else {
-        std::cout << "Error: Can only occupy from ALLOCATED state" << std::endl;
-    }
+ParkingRequest::TransitionStatus ParkingRequest::allocate() {
+    // REQUESTED -> ALLOCATED
+    return apply(ALLOCATE);
 }
 
-void ParkingRequest::release() {
-    // Transition from OCCUPIED to RELEASED
-    // Valid only if current state is OCCUPIED
-    if (currentState == OCCUPIED) {
-        currentState = RELEASED;
-    } else {
-        std::cout << "Error: Can only release from OCCUPIED state" << std::endl;
-    }
+ParkingRequest::TransitionStatus ParkingRequest::occupy() {
+    // ALLOCATED -> OCCUPIED
+    return apply(OCCUPY);
 }
 
-void ParkingRequest::cancel() {
-    // Transition to CANCELLED from REQUESTED or ALLOCATED
-    // Valid only if current state is REQUESTED or ALLOCATED
-    if (currentState == REQUESTED || currentState == ALLOCATED) {
-        currentState = CANCELLED;
-    } else {
-        std::cout << "Error: Can only cancel from REQUESTED or ALLOCATED state" << std::endl;
-    }
+ParkingRequest::TransitionStatus ParkingRequest::release() {
+    // OCCUPIED -> RELEASED
+    return apply(RELEASE);
+}
+
+ParkingRequest::TransitionStatus ParkingRequest::cancel() {
+    // REQUESTED or ALLOCATED -> CANCELLED
+    return apply(CANCEL);
+}
+
+ParkingRequest::TransitionStatus ParkingRequest::reinstate() {
+    // CANCELLED -> ALLOCATED, only used to redo an allocation that a
+    // rollback cancelled
+    return apply(REINSTATE);
+}
+
+const char* ParkingRequest::stateName(int state) {
+    static const char* const NAMES[NUM_STATES] = {"REQUESTED", "ALLOCATED", "OCCUPIED", "RELEASED", "CANCELLED"};
+    return (state >= 0 && state < NUM_STATES) ? NAMES[state] : "UNKNOWN";
+}
+
+const char* ParkingRequest::transitionName(int transition) {
+    static const char* const NAMES[NUM_TRANSITIONS] = {"allocate", "occupy", "release", "cancel", "reinstate"};
+    return (transition >= 0 && transition < NUM_TRANSITIONS) ? NAMES[transition] : "unknown";
 }
 
 ParkingRequest::State ParkingRequest::getState() const {
@@ -74,6 +85,10 @@ void ParkingRequest::setRequestTime(int time) {
     requestTime = time;
 }
 
+void ParkingRequest::setVehicleClass(int vehicleClassValue) {
+    vehicleClass = isValidVehicleClass(vehicleClassValue) ? vehicleClassValue : VEHICLE_STANDARD;
+}
+
 int ParkingRequest::getRequestID() const {
     return requestID;
 }
@@ -90,10 +105,36 @@ int ParkingRequest::getRequestTime() const {
     return requestTime;
 }
 
+int ParkingRequest::getVehicleClass() const {
+    return vehicleClass;
+}
+
 int ParkingRequest::getExitTime() const {
     return exitTime;
 }
 
 void ParkingRequest::setExitTime(int time) {
     exitTime = time;
-}
\ No newline at end of file
+}
+
+void ParkingRequest::setAllocation(int areaIndex, int slotID) {
+    allocatedArea = areaIndex;
+    allocatedSlotID = slotID;
+}
+
+void ParkingRequest::clearAllocation() {
+    allocatedArea = -1;
+    allocatedSlotID = -1;
+}
+
+int ParkingRequest::getAllocatedArea() const {
+    return allocatedArea;
+}
+
+int ParkingRequest::getAllocatedSlotID() const {
+    return allocatedSlotID;
+}
+
+void ParkingRequest::restoreState(State state) {
+    currentState = state;
+}
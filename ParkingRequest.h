@@ -1,6 +1,8 @@
 #ifndef PARKING_REQUEST_H
 #define PARKING_REQUEST_H
 
+#include "SlotType.h"
+
 class ParkingRequest {
 public:
     // Enum for parking request states
@@ -12,13 +14,87 @@ public:
         CANCELLED   // The request has been cancelled before completion
     };
 
+    // Enum for state transitions (indexes the transition error counters)
+    enum Transition {
+        ALLOCATE,        // REQUESTED -> ALLOCATED
+        OCCUPY,          // ALLOCATED -> OCCUPIED
+        RELEASE,         // OCCUPIED -> RELEASED
+        CANCEL,          // REQUESTED or ALLOCATED -> CANCELLED
+        REINSTATE,       // CANCELLED -> ALLOCATED
+        NUM_TRANSITIONS  // Number of transitions
+    };
+
+    // Result of a transition. Transitions never print: callers count or
+    // log failures (see Analytics::onTransitionError and TransitionLog).
+    // Only transitions made through ParkingSystem (and its rollback) are
+    // counted; a failed call made directly on a ParkingRequest is reported
+    // to its caller alone
+    enum TransitionStatus {
+        TRANSITION_OK,      // State changed
+        TRANSITION_INVALID  // Not allowed from the current state; state unchanged
+    };
+
+    static const int NUM_STATES = 5;  // Number of State values
+
+    // Legal edges of the lifecycle: TRANSITIONS[transition][state] is the
+    // state a transition leads to from that state, or -1 if it is not
+    // allowed there. The transition methods only look this table up; the
+    // static_asserts below the class check it at compile time
+    static constexpr signed char TRANSITIONS[NUM_TRANSITIONS][NUM_STATES] = {
+        // REQUESTED  ALLOCATED  OCCUPIED  RELEASED  CANCELLED
+        {ALLOCATED,   -1,        -1,       -1,       -1},         // ALLOCATE
+        {-1,          OCCUPIED,  -1,       -1,       -1},         // OCCUPY
+        {-1,          -1,        RELEASED, -1,       -1},         // RELEASE
+        {CANCELLED,   CANCELLED, -1,       -1,       -1},         // CANCEL
+        {-1,          -1,        -1,       -1,       ALLOCATED}   // REINSTATE
+    };
+
+    // State a transition leads to from a state (-1 if not allowed)
+    static constexpr int transitionTarget(int transition, int state) {
+        return TRANSITIONS[transition][state];
+    }
+
+    // Check if a transition is allowed from a state
+    static constexpr bool canTransition(int transition, int state) {
+        return TRANSITIONS[transition][state] >= 0;
+    }
+
+    // Number of transitions allowed from a state (compile-time checks)
+    static constexpr int edgesFrom(int state, int transition = 0) {
+        return (transition == NUM_TRANSITIONS) ? 0
+               : (canTransition(transition, state) ? 1 : 0) + edgesFrom(state, transition + 1);
+    }
+
+    // Number of states a transition is allowed from (compile-time checks)
+    static constexpr int edgesOf(int transition, int state = 0) {
+        return (state == NUM_STATES) ? 0
+               : (canTransition(transition, state) ? 1 : 0) + edgesOf(transition, state + 1);
+    }
+
+    // Check that every table entry is -1 or another valid state (no self
+    // loops), starting at flat index cell (compile-time checks)
+    static constexpr bool tableWellFormed(int cell = 0) {
+        return cell == NUM_TRANSITIONS * NUM_STATES ||
+               ((TRANSITIONS[cell / NUM_STATES][cell % NUM_STATES] == -1 ||
+                 (TRANSITIONS[cell / NUM_STATES][cell % NUM_STATES] >= 0 &&
+                  TRANSITIONS[cell / NUM_STATES][cell % NUM_STATES] < NUM_STATES &&
+                  TRANSITIONS[cell / NUM_STATES][cell % NUM_STATES] != cell % NUM_STATES)) &&
+                tableWellFormed(cell + 1));
+    }
+
 private:
     int requestID;
     int vehicleID;
     int requestedZone;
     int requestTime;
+    int vehicleClass;  // VehicleClass of the vehicle (decides which slot types fit)
     int exitTime;  // Time when vehicle exits (when state becomes RELEASED)
     State currentState;
+    int allocatedArea;    // Index of the area holding the allocated slot (-1 if none)
+    int allocatedSlotID;  // Allocated slotID (-1 if none)
+
+    // Apply a transition through the table
+    TransitionStatus apply(Transition transition);
 
 public:
     // Constructor
@@ -27,11 +103,20 @@ public:
     // Destructor
     ~ParkingRequest();
 
-    // Functions to change state
-    void allocate();    // Change state to ALLOCATED
-    void occupy();      // Change state to OCCUPIED
-    void release();     // Change state to RELEASED
-    void cancel();      // Change state to CANCELLED
+    // Functions to change state, O(1). A rejected call is not counted by
+    // Analytics unless it went through the ParkingSystem facade
+    TransitionStatus allocate();    // Change state to ALLOCATED
+    TransitionStatus occupy();      // Change state to OCCUPIED
+    TransitionStatus release();     // Change state to RELEASED
+    TransitionStatus cancel();      // Change state to CANCELLED
+    TransitionStatus reinstate();   // Change state back to ALLOCATED (redo of a rolled-back allocation)
+
+    // Names of states and transitions (for logs and exported counters)
+    static const char* stateName(int state);
+    static const char* transitionName(int transition);
+
+    // Put back a state saved in a snapshot (no transition check)
+    void restoreState(State state);
 
     // Getter for current state
     State getState() const;
@@ -41,14 +126,41 @@ public:
     void setVehicleID(int id);
     void setRequestedZone(int zone);
     void setRequestTime(int time);
+    void setVehicleClass(int vehicleClassValue);  // Values outside VehicleClass become VEHICLE_STANDARD
 
     // Getters for attributes
     int getRequestID() const;
     int getVehicleID() const;
     int getRequestedZone() const;
     int getRequestTime() const;
+    int getVehicleClass() const;
     int getExitTime() const;
     void setExitTime(int time);
+
+    // Slot assignment (set by ParkingSystem on allocation, cleared when the slot is freed)
+    void setAllocation(int areaIndex, int slotID);
+    void clearAllocation();
+    int getAllocatedArea() const;
+    int getAllocatedSlotID() const;
 };
 
+// Compile-time checks of the transition table
+static_assert(ParkingRequest::tableWellFormed(), "Transition targets must be valid states other than the source");
+static_assert(ParkingRequest::transitionTarget(ParkingRequest::ALLOCATE, ParkingRequest::REQUESTED) == ParkingRequest::ALLOCATED &&
+              ParkingRequest::transitionTarget(ParkingRequest::OCCUPY, ParkingRequest::ALLOCATED) == ParkingRequest::OCCUPIED &&
+              ParkingRequest::transitionTarget(ParkingRequest::RELEASE, ParkingRequest::OCCUPIED) == ParkingRequest::RELEASED,
+              "The main lifecycle is REQUESTED -> ALLOCATED -> OCCUPIED -> RELEASED");
+static_assert(ParkingRequest::edgesOf(ParkingRequest::ALLOCATE) == 1 && ParkingRequest::edgesOf(ParkingRequest::OCCUPY) == 1 &&
+              ParkingRequest::edgesOf(ParkingRequest::RELEASE) == 1,
+              "Allocate, occupy and release each have exactly one source state");
+static_assert(ParkingRequest::edgesOf(ParkingRequest::CANCEL) == 2 &&
+              ParkingRequest::canTransition(ParkingRequest::CANCEL, ParkingRequest::REQUESTED) &&
+              ParkingRequest::canTransition(ParkingRequest::CANCEL, ParkingRequest::ALLOCATED),
+              "Only requests without a parked vehicle can be cancelled");
+static_assert(ParkingRequest::edgesOf(ParkingRequest::REINSTATE) == 1 &&
+              ParkingRequest::transitionTarget(ParkingRequest::REINSTATE, ParkingRequest::CANCELLED) == ParkingRequest::ALLOCATED,
+              "Reinstate (redo of a rolled-back allocation) is the only edge out of CANCELLED");
+static_assert(ParkingRequest::edgesFrom(ParkingRequest::RELEASED) == 0, "RELEASED is final");
+static_assert(ParkingRequest::edgesFrom(ParkingRequest::CANCELLED) == 1, "CANCELLED only leaves through reinstate");
+
 #endif // PARKING_REQUEST_H
\ No newline at end of file
@@ -4,6 +4,10 @@ ParkingSlot::ParkingSlot() {
     slotID = 0;
     zoneID = 0;
     isAvailable = true;
+    x = 0;
+    y = 0;
+    level = 0;
+    slotType = SLOT_STANDARD;
 }
 
 ParkingSlot::~ParkingSlot() {
@@ -32,4 +36,30 @@ bool ParkingSlot::getIsAvailable() const {
 
 void ParkingSlot::setIsAvailable(bool available) {
     isAvailable = available;
+}
+
+int ParkingSlot::getX() const {
+    return x;
+}
+
+int ParkingSlot::getY() const {
+    return y;
+}
+
+int ParkingSlot::getLevel() const {
+    return level;
+}
+
+void ParkingSlot::setCoordinates(int slotX, int slotY, int slotLevel) {
+    x = slotX;
+    y = slotY;
+    level = slotLevel;
+}
+
+int ParkingSlot::getSlotType() const {
+    return slotType;
+}
+
+void ParkingSlot::setSlotType(int type) {
+    slotType = isValidSlotType(type) ? type : SLOT_STANDARD;
 }
\ No newline at end of file
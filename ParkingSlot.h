@@ -1,11 +1,17 @@
 #ifndef PARKING_SLOT_H
 #define PARKING_SLOT_H
 
+#include "SlotType.h"
+
 class ParkingSlot {
 private:
     int slotID;
     int zoneID;
     bool isAvailable;
+    int x;      // Position within the facility (any consistent unit, e.g. meters)
+    int y;
+    int level;  // Deck / floor
+    int slotType;  // SlotType (SLOT_STANDARD unless set)
 
 public:
     // Constructor
@@ -31,6 +37,20 @@ public:
 
     // Setter for isAvailable
     void setIsAvailable(bool available);
+
+    // Getters for coordinates (0, 0, 0 unless set)
+    int getX() const;
+    int getY() const;
+    int getLevel() const;
+
+    // Setter for coordinates
+    void setCoordinates(int slotX, int slotY, int slotLevel);
+
+    // Getter for slotType
+    int getSlotType() const;
+
+    // Setter for slotType (values outside SlotType become SLOT_STANDARD)
+    void setSlotType(int type);
 };
 
 #endif // PARKING_SLOT_H
\ No newline at end of file
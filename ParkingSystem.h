@@ -1,62 +1,360 @@
 #ifndef PARKING_SYSTEM_H
 #define PARKING_SYSTEM_H
 
+#include <mutex>
 #include "Zone.h"
 #include "Vehicle.h"
 #include "ParkingRequest.h"
 #include "ParkingArea.h"
+#include "SlotStore.h"
+#include "Arena.h"
+#include "IdIndex.h"
 #include "AllocationEngine.h"
 #include "RollbackManager.h"
+#include "ZoneIndex.h"
+#include "Analytics.h"
+#include "Journal.h"
+#include "TimerWheel.h"
+#include "Instrumentation.h"
+
+// Feature macros for APIs added after the core build/allocate/release/
+// rollback interface, so tools built against older trees (bench_macro)
+// can leave out what those trees lack
+#define PARKING_HAS_SNAPSHOT 1    // saveSnapshot / loadSnapshot
+#define PARKING_HAS_JOURNAL 1     // Journal, attachJournal, getJournalSequence
+#define PARKING_HAS_NEAREST 1     // Slot coordinates, findNearestAvailableSlot
+#define PARKING_HAS_SLOT_TYPES 1  // Slot types, findFirstAvailableSlotOfType
+
+class ParkingSystem;
+
+// Called by advanceTime for an OCCUPIED request past its maximum stay.
+// Runs outside the system's locks, so it may call releaseRequest
+typedef void (*OverstayHandler)(ParkingSystem* system, int requestIndex, void* context);
 
 class ParkingSystem {
 private:
-    Zone* zones;                    // Array of zones
+    Arena* arena;                   // Backs all entity arrays and slot storage
+    double growthFactor;            // Factor by which a full entity array grows
+
+    Zone* zones;                    // Zone storage in the arena (constructed in place up to numZones)
     int numZones;                   // Current number of zones
-    int maxZones;                   // Maximum zones capacity
+    int zoneCapacity;               // Capacity of the zones array
+    IdIndex zonePositions;          // zoneID -> index in zones (first zone with an ID)
 
-    Vehicle* vehicles;              // Array of vehicles
+    Vehicle* vehicles;              // Vehicle storage in the arena
     int numVehicles;                // Current number of vehicles
-    int maxVehicles;                // Maximum vehicles capacity
+    int vehicleCapacity;            // Capacity of the vehicles array
+    IdIndex vehiclePositions;       // vehicleID -> index in vehicles (first vehicle with an ID)
 
-    ParkingRequest* requests;       // Array of parking requests
+    ParkingRequest* requests;       // Request storage in the arena
     int numRequests;                // Current number of requests
-    int maxRequests;                // Maximum requests capacity
+    int requestCapacity;            // Capacity of the requests array
 
-    ParkingArea* areas;             // Array of parking areas
+    ParkingArea* areas;             // Area storage in the arena (constructed in place up to numAreas)
     int numAreas;                   // Current number of areas
-    int maxAreas;                   // Maximum areas capacity
+    int areaCapacity;               // Capacity of the areas array
+
+    SlotStore* slotStore;           // Facility-wide slot columns (in the arena) viewed by zones and areas
+
+    ZoneIndex* zoneIndex;           // Zone -> area index, kept in sync by addArea
+    Analytics* analytics;           // Running counters behind the analytics getters
 
     AllocationEngine* allocEngine;  // Engine for slot allocation
     RollbackManager* rollbackMgr;   // Manager for rollback operations
 
+    // Concurrent mode (see enableConcurrentAllocation)
+    bool concurrentMode;            // True once concurrent allocation is enabled
+    std::mutex* zoneLocks;          // One lock per zone bucket: guards that zone's areas
+    int numZoneLocks;               // Number of zone locks
+    mutable std::mutex statsLock;   // Guards analytics, rollback stack and request states
+
+    Journal* journal;               // Write-ahead journal (not owned, nullptr if none)
+    long long journalSequence;      // Last journal record reflected in this state
+
+    // Request timers (see setNoShowGrace / setMaxStay), keyed on request index
+    TimerWheel* noShowTimers;       // ALLOCATED requests: requestTime + noShowGrace
+    TimerWheel* stayTimers;         // OCCUPIED requests: requestTime + maxStay
+    int noShowGrace;                // Grace period before a no-show expires (0 = off)
+    int maxStay;                    // Longest stay before the overstay handler runs (0 = off)
+    OverstayHandler overstayHandler;  // Called for each overstay (nullptr: only counted)
+    void* overstayContext;          // Passed to overstayHandler
+    long long expiredNoShows;       // Requests cancelled by the no-show timer
+    long long overstays;            // Overstays reported by the max-stay timer
+
+    Instrumentation* instrumentation;  // Per-operation latency histograms (nullptr unless
+                                       // built with PARKING_INSTRUMENTATION)
+
+    TransitionLog* transitionLog;   // Buffered log of rejected transitions (nullptr unless enabled)
+
+    // Move the first count objects of a full entity array into a larger
+    // arena array (growthFactor times the capacity). Indices are unchanged;
+    // the old array is given back to the arena, so pointers into it die
+    template <typename T>
+    void growArray(T*& array, int count, int& capacity);
+
+    // Make room for one more zone / area (re-pointing the allocation engine
+    // when the areas array moves)
+    void reserveZone();
+    void reserveArea();
+
+    // Finish registering the zone just constructed at zones[numZones]
+    void registerZone();
+
+    // Finish registering the area just constructed at areas[numAreas]
+    void registerArea();
+
+    // Free a slot (under its zone lock in concurrent mode) and update the counters
+    void freeAreaSlot(int areaIndex, int slotID);
+
+    // Give back a slot claimed for a request that could not take it (the
+    // caller runs serially or holds every lock)
+    void returnClaimedSlot(int areaIndex, int slotID);
+
+    // Start the no-show / max-stay timer of a request entering ALLOCATED / OCCUPIED
+    void startNoShowTimer(int requestIndex);
+    void startStayTimer(int requestIndex);
+
+    // Lock the analytics/rollback/request state (no-op unless in concurrent mode)
+    std::unique_lock<std::mutex> statsGuard() const;
+
+    // Stop-the-world locking for rollback and batches in concurrent mode:
+    // every zone lock in bucket order, then the stats lock
+    void lockAll();
+    void unlockAll();
+
+    // Apply the ALLOCATED transition after a slot was taken for a request
+    // Returns false (and counts the error) if the request was not REQUESTED
+    bool markAllocated(ParkingRequest& req, int areaIndex, int slotID);
+
+    // Count (and log, if enabled) a transition rejected in the request's
+    // current state. Returns false so callers can return it directly
+    bool rejectTransition(ParkingRequest::Transition transition, const ParkingRequest& req);
+
+    // Append a change to the journal, if one is attached. Called under the
+    // lock that guards the change, so journal order matches the order the
+    // changes were applied in
+    void journalChange(int type, int requestIndex, int value1 = 0, int value2 = 0);
+
+    // Recovery: take a journaled slot for a REQUESTED request (no search)
+    bool applyAllocation(int requestIndex, int areaIndex, int slotID);
+
+    // Apply one journal record during recovery. Returns false if it does
+    // not fit the current state
+    bool applyJournalRecord(const JournalRecord& record);
+
+    // Write the snapshot sections (locks already held)
+    bool writeSnapshot(const char* path);
+
+    // Debug self-check: when built with PARKING_SELF_CHECK, assert that the
+    // running counters match a full recount after every mutation
+    void selfCheck() const;
+
 public:
-    // Constructor: Initializes the system with maximum capacities
-    ParkingSystem(int maxZ, int maxV, int maxR, int maxA, int maxOps);
+    // Constructor: Initializes the system with initial capacities for zones,
+    // vehicles, requests and areas (each array grows by growth when full, so
+    // these only size the first allocation) and the rollback history budget
+    ParkingSystem(int maxZ, int maxV, int maxR, int maxA, int maxOps,
+                  double growth = Arena::DEFAULT_GROWTH_FACTOR);
+
+    // Capacity growth: factor by which a full zone, vehicle, request or area
+    // array grows, also used by registered zones for their range and adjacency
+    // lists. Any factor > 1 keeps adds amortized O(1); a smaller factor
+    // tracks the real load more closely at the cost of more frequent copies
+    void setGrowthFactor(double factor);
+    double getGrowthFactor() const;
 
     // Destructor
     ~ParkingSystem();
 
     // Manage zones: Add a zone to the system
+    // The zone's slots move into the facility-wide slot store, and the zone
+    // views the slots of every area registered under its zoneID
     void addZone(const Zone& zone);
 
+    // Manage zones: Add a zone by moving it into the system (no deep copy
+    // of its adjacency list)
+    void addZone(Zone&& zone);
+
+    // Manage zones: Construct a zone (without slots of its own) directly in
+    // system storage. Returns its index
+    int emplaceZone(int zoneID, const char* zoneName);
+
+    // Memory: The arena backing entity and slot storage (for memory stats)
+    const Arena& getArena() const;
+
+    // Manage zones: Find a registered zone by ID (nullptr if unknown)
+    // The pointer is valid until the next zone is added (the zones array may
+    // grow); zone indices never change
+    const Zone* getZone(int zoneID) const;
+
+    // Manage zones: Record that two registered zones are adjacent (both directions)
+    // Cross-zone allocation searches zones in increasing hop distance
+    void addZoneAdjacency(int zoneA, int zoneB);
+
     // Manage vehicles: Add a vehicle to the system
     void addVehicle(const Vehicle& vehicle);
 
-    // Manage requests: Add a parking request to the system
+    // Manage requests: Add a parking request to the system. A request for
+    // a registered vehicle takes that vehicle's class (deciding which slot
+    // types it may be given); otherwise it keeps its own
     void addRequest(const ParkingRequest& request);
 
-    // Manage areas: Add a parking area to the system
+    // Manage requests: Number of requests added so far (request indices
+    // run from 0 to getNumRequests() - 1)
+    int getNumRequests() const;
+
+    // Manage requests: Request at an index (nullptr if out of range). The
+    // pointer is valid until the next request is added
+    const ParkingRequest* getRequest(int requestIndex) const;
+
+    // Manage areas: Add a parking area to the system (also indexes it by zone)
+    // Its slots move into the facility-wide slot store, shared with its zone
     void addArea(const ParkingArea& area);
 
+    // Manage areas: Add an area by moving it into the system (its slots are
+    // copied once, into the slot store)
+    void addArea(ParkingArea&& area);
+
+    // Manage areas: Construct an area directly in system storage, with its
+    // slots written straight into the facility-wide slot store (no
+    // temporary ParkingArea). Returns the area index
+    int emplaceArea(int areaID, int zoneID, const ParkingSlot* slots, int numSlots);
+
     // Coordinate allocation: Allocate a slot for a specific request
     int allocateForRequest(int requestIndex);
 
+    // Nearest-slot query: slotID of the free slot in an area (index in the
+    // order areas were added) nearest to a reference point such as the
+    // entrance, or -1. Does not allocate. See ParkingArea::findNearestAvailableSlot
+    int findNearestFreeSlot(int areaIndex, int x, int y, int level);
+
+    // Name of the allocation policy this build uses (chosen at compile time
+    // with -DPARKING_ALLOCATION_POLICY=<policy>, see AllocationPolicy.h)
+    const char* getAllocationPolicyName() const;
+
+    // Concurrency: Switch to concurrent mode. Call once after configuration
+    // (zones, areas, adjacency) is complete and again after any later change;
+    // the add* calls themselves are never thread-safe.
+    // In concurrent mode allocateForRequest, allocateConcurrent, allocateBatch,
+    // the request lifecycle calls, rollback and the analytics getters may be
+    // called from several threads. Allocations in different zones search their
+    // zones in parallel under per-zone locks; only the short bookkeeping step
+    // (rollback record, counters, request state) is serialized. Each request
+    // index must be driven by one thread at a time.
+    void enableConcurrentAllocation();
+
+    // Concurrency: Thread-safe allocation for one request. The slot, area and
+    // penalty come back in the result instead of engine-global "last" state.
+    // Fails (slotID -1) if concurrent mode is not enabled or the configuration
+    // changed since it was enabled
+    AllocationResult allocateConcurrent(int requestIndex);
+
+    // Coordinate allocation: Allocate slots for many requests at once
+    // Requests are grouped by requested zone and each zone's group takes its
+    // slots in one pass over the zone's free slots; from the first request
+    // whose zone would run out, the remaining requests go through the normal
+    // one-by-one path. Results match calling allocateForRequest on each index
+    // in order. Rollback records are pushed as one contiguous block.
+    // outSlotIDs[i] receives the slotID (-1 on failure) and outPenalties[i]
+    // whether a cross-zone penalty applied. Returns the number allocated
+    int allocateBatch(const int* requestIndices, int count, int* outSlotIDs, bool* outPenalties);
+
+    // Cross-zone penalty of the last successful allocation:
+    // hop distance from the requested zone (0 = same zone)
+    int getLastAllocationPenalty() const;
+
+    // Request lifecycle: Vehicle arrives at its allocated slot (ALLOCATED -> OCCUPIED)
+    // Returns true if the transition was applied
+    bool occupyRequest(int requestIndex);
+
+    // Request lifecycle: Vehicle leaves (OCCUPIED -> RELEASED), records the exit
+    // time and frees the slot. Returns true if the transition was applied
+    bool releaseRequest(int requestIndex, int exitTime);
+
+    // Request lifecycle: Cancel a REQUESTED or ALLOCATED request, freeing its
+    // slot if one was allocated. Returns true if the transition was applied
+    bool cancelRequest(int requestIndex);
+
+    // Request timers: Cancel ALLOCATED requests whose vehicle has not
+    // arrived grace time units after their requestTime (0 turns it off).
+    // Requests already ALLOCATED get a timer now, so this also re-arms the
+    // timers of a restored system
+    void setNoShowGrace(int grace);
+
+    // Request timers: Report OCCUPIED requests still parked maxStayTime
+    // units after their requestTime (occupy time is not recorded) to the
+    // handler, or only count them if it is nullptr (0 turns it off).
+    // Requests already OCCUPIED get a timer now
+    void setMaxStay(int maxStayTime, OverstayHandler handler = nullptr, void* context = nullptr);
+
+    // Request timers: Move the clock to now and fire every timer due at or
+    // before it: no-shows are cancelled through cancelRequest (freeing the
+    // slot), overstays go to the handler. Time must not go backwards. A
+    // timer whose request has left the state in the meantime (occupied,
+    // cancelled, rolled back) is dropped. O(1) amortized per timer and tick.
+    // Returns the number of timers that took effect
+    int advanceTime(int now);
+
+    // Request timers: Requests cancelled as no-shows and overstays reported
+    long long getExpiredNoShows() const;
+    long long getOverstays() const;
+
+    // Instrumentation: Copy the per-operation latency histograms and call
+    // counts (allocations split into same-zone, cross-zone and failed).
+    // Returns false, leaving out untouched, unless built with
+    // PARKING_INSTRUMENTATION
+    bool getInstrumentation(InstrumentationSnapshot* out) const;
+
+    // Instrumentation: Forget every recorded sample
+    void resetInstrumentation();
+
+    // Instrumentation: Text dump of the histograms (one line per operation
+    // called: count, mean, p50/p90/p99/p99.9, max)
+    void dumpInstrumentation(std::ostream& out) const;
+
+    // Transition errors: Rejected lifecycle calls (allocate, occupy,
+    // release, cancel, rollback's cancel) per transition, from any state or
+    // from one state. Counted always, O(1)
+    long long getTransitionErrors(ParkingRequest::Transition transition) const;
+    long long getTransitionErrors(ParkingRequest::Transition transition, ParkingRequest::State from) const;
+
+    // Transition errors: Export the non-zero counters as tab-separated
+    // lines (transition, from_state, errors) under a header
+    void exportTransitionErrors(std::ostream& out) const;
+
+    // Transition errors: Zero the counters
+    void resetTransitionErrors();
+
+    // Transition errors: Opt-in verbose log. With capacity > 0, every
+    // rejected transition is also buffered in memory (the newest capacity
+    // entries are kept) until flushTransitionLog writes them out; 0 turns
+    // the log off and discards it. Off by default
+    void enableTransitionLog(int capacity);
+
+    // Transition errors: Write and empty the buffered log, returns entries written
+    int flushTransitionLog(std::ostream& out);
+
     // Coordinate rollback: Undo the last allocation
     void rollbackLast();
 
     // Coordinate rollback: Undo the last k allocations
     void rollbackLastK(int k);
 
+    // Coordinate redo: Replay up to k rolled-back allocations in their original
+    // order, on the same slots and without running allocation again.
+    // Returns the number redone (records whose slot was taken meanwhile are
+    // skipped); any new allocation clears the redo history
+    int redoLastK(int k);
+
+    // Rollback history: records currently undoable, records that can be
+    // redone, and records evicted because the history budget was full
+    int getRollbackHistorySize() const;
+    int getRedoHistorySize() const;
+    long long getRollbackEvictions() const;
+
+    // Analytics counters below are maintained incrementally and served in O(1)
+    // (except average duration)
+
     // Analytics: Get total number of parking slots across all areas
     int getTotalSlots() const;
 
@@ -66,21 +364,99 @@ public:
     // Analytics: Get number of active requests
     int getActiveRequests() const;
 
+    // Analytics: Get total / available slots of one slot type across all
+    // areas (0 for an invalid type)
+    int getTotalSlotsByType(int slotType) const;
+    int getAvailableSlotsByType(int slotType) const;
+
+    // Analytics: Get available slots of one slot type in a zone
+    int getZoneAvailableSlotsByType(int zoneID, int slotType) const;
+
     // Analytics: Get utilization percentage for a specific zone
     // Formula: (occupied slots / total slots) * 100
     double getZoneUtilization(int zoneID) const;
 
-    // Analytics: Get average parking duration (placeholder - duration not currently tracked)
+    // Analytics: Get average parking duration of released requests, O(released requests)
     double getAverageParkingDuration() const;
 
+    // Per-state lists: First request index in a state (the one that entered
+    // it longest ago), -1 if none, O(1). With getNextRequestInState this
+    // walks one state in O(count in that state); not safe while other
+    // threads change request states (use listRequestsInState then)
+    int getFirstRequestInState(ParkingRequest::State state) const;
+
+    // Per-state lists: Next request index in the same state, -1 at the end, O(1)
+    int getNextRequestInState(int requestIndex) const;
+
+    // Per-state lists: Write up to maxCount indices of requests in a state
+    // (oldest entry first). Returns the number written, O(written)
+    int listRequestsInState(ParkingRequest::State state, int* outIndices, int maxCount) const;
+
+    // Per-state lists: Write up to maxCount indices of active requests
+    // (REQUESTED, then ALLOCATED, then OCCUPIED). Returns the number written, O(written)
+    int listActiveRequests(int* outIndices, int maxCount) const;
+
     // Analytics: Get number of cancelled requests
     int getCancelledRequests() const;
 
     // Analytics: Get number of completed requests (those that reached RELEASED state)
     int getCompletedRequests() const;
 
-    // Analytics: Get the zone with peak/highest utilization
+    // Analytics: Get the zone with peak/highest utilization (O(1))
     int getPeakUsageZone() const;
+
+    // Analytics: Write the k most utilized zoneIDs (highest first) into outZoneIDs
+    // Returns the number of zones written
+    int getTopUsageZones(int k, int* outZoneIDs) const;
+
+    // Debug: Recompute the running counters from scratch and compare
+    // Returns true if they agree with the areas and requests
+    bool verifyCounters() const;
+
+    // Persistence: Write the whole system state (zones, adjacency, areas,
+    // slots, vehicles, requests, rollback history and redo stack) to a
+    // versioned binary snapshot in one sequential pass. Stops the world in
+    // concurrent mode. Returns false if the file could not be written
+    bool saveSnapshot(const char* path);
+
+    // Persistence: Rebuild a system from a snapshot. The file is memory-mapped
+    // and its flat arrays are read in place: slot columns are bulk-copied,
+    // indexes and counters rebuilt in one pass. Returns nullptr if the file
+    // is missing, of another version or inconsistent. The restored system
+    // starts in serial mode
+    static ParkingSystem* loadSnapshot(const char* path);
+
+    // Durability: Attach a write-ahead journal (nullptr detaches). From then
+    // on addRequest, every allocation (with the slot taken), the request
+    // transitions and rollback/redo calls append a record. Zones, areas and
+    // adjacency are not journaled: checkpoint after changing them. The
+    // journal must continue this state's numbering, i.e. be opened with
+    // getJournalSequence() + 1; returns false otherwise
+    bool attachJournal(Journal* target);
+
+    // Durability: Last journal record reflected in this state (saved in
+    // snapshots, so recovery knows which records to skip)
+    long long getJournalSequence() const;
+
+    // Durability: Write a snapshot that covers every journaled change, then
+    // empty the journal. The snapshot is written to a temporary file and
+    // renamed over snapshotPath, so a crash leaves either the old snapshot
+    // with the full journal or the new one. Stops the world in concurrent
+    // mode. Returns false if the snapshot or journal could not be written
+    bool checkpoint(const char* snapshotPath);
+
+    // Durability: Re-apply the records of a journal that are newer than
+    // getJournalSequence(), stopping at a torn tail. Call on a system
+    // restored from the matching snapshot, in serial mode and with no
+    // journal attached. Returns the number of records applied, or -1 if the
+    // journal cannot be read or a record does not fit the state
+    long long replayJournal(const char* path);
+
+    // Durability: Crash recovery: load the snapshot and replay the journal
+    // on top of it (a missing journal means nothing happened since the
+    // snapshot). Returns nullptr if the snapshot cannot be loaded or the
+    // journal does not fit it
+    static ParkingSystem* recover(const char* snapshotPath, const char* journalPath);
 };
 
 #endif // PARKING_SYSTEM_H
\ No newline at end of file
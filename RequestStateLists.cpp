@@ -0,0 +1,82 @@
+#include "RequestStateLists.h"
+
+RequestStateLists::RequestStateLists() {
+    for (int s = 0; s < ParkingRequest::NUM_STATES; s++) {
+        heads[s] = -1;
+        tails[s] = -1;
+    }
+    nextInList = nullptr;
+    prevInList = nullptr;
+    capacity = 0;
+}
+
+RequestStateLists::~RequestStateLists() {
+    delete[] nextInList;
+    delete[] prevInList;
+}
+
+void RequestStateLists::grow(int requestIndex) {
+    int newCapacity = (capacity > 0) ? capacity : 64;
+    while (newCapacity <= requestIndex) {
+        newCapacity *= 2;
+    }
+    int* newNext = new int[newCapacity];
+    int* newPrev = new int[newCapacity];
+    for (int i = 0; i < capacity; i++) {
+        newNext[i] = nextInList[i];
+        newPrev[i] = prevInList[i];
+    }
+    delete[] nextInList;
+    delete[] prevInList;
+    nextInList = newNext;
+    prevInList = newPrev;
+    capacity = newCapacity;
+}
+
+void RequestStateLists::link(int requestIndex, int state) {
+    nextInList[requestIndex] = -1;
+    prevInList[requestIndex] = tails[state];
+    if (tails[state] != -1) {
+        nextInList[tails[state]] = requestIndex;
+    } else {
+        heads[state] = requestIndex;
+    }
+    tails[state] = requestIndex;
+}
+
+void RequestStateLists::unlink(int requestIndex, int state) {
+    int before = prevInList[requestIndex];
+    int after = nextInList[requestIndex];
+    if (before != -1) {
+        nextInList[before] = after;
+    } else {
+        heads[state] = after;
+    }
+    if (after != -1) {
+        prevInList[after] = before;
+    } else {
+        tails[state] = before;
+    }
+}
+
+void RequestStateLists::add(int requestIndex, int state) {
+    if (requestIndex >= capacity) {
+        grow(requestIndex);
+    }
+    link(requestIndex, state);
+}
+
+void RequestStateLists::move(int requestIndex, int from, int to) {
+    if (from != to) {
+        unlink(requestIndex, from);
+        link(requestIndex, to);
+    }
+}
+
+int RequestStateLists::getFirst(int state) const {
+    return heads[state];
+}
+
+int RequestStateLists::getNext(int requestIndex) const {
+    return nextInList[requestIndex];
+}
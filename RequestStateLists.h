@@ -0,0 +1,59 @@
+#ifndef REQUEST_STATE_LISTS_H
+#define REQUEST_STATE_LISTS_H
+
+#include "ParkingRequest.h"
+
+// One intrusive doubly linked list of request indices per request state.
+//
+// Analytics moves a request between lists on every state change it is told
+// about, so the requests in one state (the active ones, the allocated but
+// not yet occupied ones, ...) can be walked in O(count in that state)
+// instead of scanning every request ever submitted. Each list keeps its
+// requests in the order they entered the state (oldest first).
+//
+// The links live in two arrays indexed by request index, so a move is
+// O(1) and never allocates (except to grow the arrays when a larger index
+// shows up).
+
+class RequestStateLists {
+private:
+    int heads[ParkingRequest::NUM_STATES];  // First request index per state (-1 if empty)
+    int tails[ParkingRequest::NUM_STATES];  // Last request index per state (-1 if empty)
+    int* nextInList;                        // Next request in the same list (-1 at the end)
+    int* prevInList;                        // Previous request in the same list (-1 at the head)
+    int capacity;                           // Size of the per-request arrays
+
+    // Grow the per-request arrays to cover requestIndex
+    void grow(int requestIndex);
+
+    // Append a request to the tail of a state's list
+    void link(int requestIndex, int state);
+
+    // Remove a request from a state's list
+    void unlink(int requestIndex, int state);
+
+public:
+    // Constructor: Every list empty
+    RequestStateLists();
+
+    // Destructor
+    ~RequestStateLists();
+
+    // The lists own their arrays, so they are not copyable
+    RequestStateLists(const RequestStateLists& other) = delete;
+    RequestStateLists& operator=(const RequestStateLists& other) = delete;
+
+    // Add a new request in its initial state, O(1) amortized
+    void add(int requestIndex, int state);
+
+    // Move a request from one state's list to another's tail, O(1)
+    void move(int requestIndex, int from, int to);
+
+    // First (oldest) request index in a state, -1 if none
+    int getFirst(int state) const;
+
+    // Next request index in the same state's list, -1 at the end
+    int getNext(int requestIndex) const;
+};
+
+#endif // REQUEST_STATE_LISTS_H
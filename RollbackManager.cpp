@@ -1,40 +1,85 @@
 #include "RollbackManager.h"
 
-RollbackManager::RollbackManager(int maxOperations) {
-    capacity = maxOperations;
+RollbackManager::RollbackManager(int maxOperations, Analytics* stats) {
+    capacity = (maxOperations > 0) ? maxOperations : 1;
+    analytics = stats;
     stack = new AllocationRecord[capacity];
-    top = -1;
+    first = 0;
+    count = 0;
+    evictions = 0;
+    // Every redo record was undone from the history, so the history and the
+    // redo stack never hold more than capacity records between them
+    redoStack = new AllocationRecord[capacity];
+    redoTop = -1;
 }
 
 RollbackManager::~RollbackManager() {
     delete[] stack;
+    delete[] redoStack;
 }
 
-void RollbackManager::recordAllocation(int areaIndex, int slotID, int requestID) {
-    if (top < capacity - 1) {
-        top++;
-        stack[top].areaIndex = areaIndex;
-        stack[top].slotID = slotID;
-        stack[top].requestID = requestID;
+void RollbackManager::push(const AllocationRecord& rec) {
+    if (count == capacity) {
+        // History full: evict the oldest record
+        first = (first + 1) % capacity;
+        count--;
+        evictions++;
+    }
+    stack[(first + count) % capacity] = rec;
+    count++;
+}
+
+void RollbackManager::recordAllocation(int areaIndex, int slotID, int requestIndex) {
+    AllocationRecord rec;
+    rec.areaIndex = areaIndex;
+    rec.slotID = slotID;
+    rec.requestIndex = requestIndex;
+    push(rec);
+    redoTop = -1;  // A new allocation invalidates the undone ones
+}
+
+void RollbackManager::recordAllocations(const int* areaIndices, const int* slotIDs, const int* requestIndices, int numRecords) {
+    for (int i = 0; i < numRecords; i++) {
+        recordAllocation(areaIndices[i], slotIDs[i], requestIndices[i]);
     }
-    // If stack is full, do nothing (could add overflow handling)
 }
 
 void RollbackManager::undoLast(ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests) {
-    if (top >= 0) {
+    if (count > 0) {
         // Step 1: Pop the last allocation record from the stack
-        AllocationRecord rec = stack[top];
-        top--;
-
-        // Step 2: Restore slot availability by freeing the slot
-        areas[rec.areaIndex].freeSlot(rec.slotID);
-
-        // Step 3: Restore request state by cancelling the associated request
-        for (int i = 0; i < numRequests; i++) {
-            if (requests[i].getRequestID() == rec.requestID) {
-                requests[i].cancel();
-                break;
-            }
+        AllocationRecord rec = stack[(first + count - 1) % capacity];
+        count--;
+
+        // Step 2: Reach the request directly through its recorded position
+        // and check that it is still ALLOCATED on the recorded slot; a request
+        // that has been occupied keeps its slot, and one that has given the
+        // slot up leaves it alone (it may belong to another request)
+        if (rec.requestIndex < 0 || rec.requestIndex >= numRequests) {
+            return;
+        }
+        ParkingRequest& req = requests[rec.requestIndex];
+        ParkingRequest::State before = req.getState();
+        if (before != ParkingRequest::ALLOCATED || req.getAllocatedArea() != rec.areaIndex ||
+            req.getAllocatedSlotID() != rec.slotID) {
+            analytics->onTransitionError(ParkingRequest::CANCEL, before, req.getRequestID());
+            return;
+        }
+
+        // Step 3: Restore slot availability by freeing the slot
+        bool freed = areas[rec.areaIndex].freeSlot(rec.slotID);
+        if (freed) {
+            analytics->onSlotFreed(areas[rec.areaIndex].getZoneID(), areas[rec.areaIndex].getSlotType(rec.slotID));
+        }
+
+        // Step 4: Restore request state by cancelling the request (cannot
+        // fail: it was checked to be ALLOCATED)
+        req.cancel();
+        analytics->onStateChange(rec.requestIndex, before, ParkingRequest::CANCELLED);
+        req.clearAllocation();
+
+        // Step 5: Keep the record for redo if this undo really freed the slot
+        if (freed) {
+            redoStack[++redoTop] = rec;
         }
     }
 }
@@ -46,10 +91,104 @@ void RollbackManager::undoLastK(int k, ParkingArea* areas, int numAreas, Parking
     }
 }
 
+bool RollbackManager::redoLast(ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests) {
+    if (redoTop < 0) {
+        return false;
+    }
+
+    // Step 1: Pop the most recently undone record
+    AllocationRecord rec = redoStack[redoTop];
+    redoTop--;
+    if (rec.areaIndex >= numAreas || rec.requestIndex >= numRequests ||
+        requests[rec.requestIndex].getState() != ParkingRequest::CANCELLED) {
+        return false;
+    }
+    ParkingRequest& req = requests[rec.requestIndex];
+
+    // Step 2: Take the same slot again (fails if it was allocated meanwhile)
+    if (!areas[rec.areaIndex].occupySlot(rec.slotID)) {
+        return false;
+    }
+    analytics->onSlotOccupied(areas[rec.areaIndex].getZoneID(), areas[rec.areaIndex].getSlotType(rec.slotID));
+
+    // Step 3: Restore the request to ALLOCATED on that slot
+    req.reinstate();  // Cannot fail: the request was checked to be CANCELLED
+    analytics->onStateChange(rec.requestIndex, ParkingRequest::CANCELLED, ParkingRequest::ALLOCATED);
+    req.setAllocation(rec.areaIndex, rec.slotID);
+
+    // Step 4: The allocation is back in the history (redo stack kept)
+    push(rec);
+    return true;
+}
+
+int RollbackManager::redoLastK(int k, ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests) {
+    int redone = 0;
+    for (int i = 0; i < k && redoTop >= 0; i++) {
+        if (redoLast(areas, numAreas, requests, numRequests)) {
+            redone++;
+        }
+    }
+    return redone;
+}
+
 bool RollbackManager::isEmpty() const {
-    return top == -1;
+    return count == 0;
 }
 
 int RollbackManager::size() const {
-    return top + 1;
-}
\ No newline at end of file
+    return count;
+}
+
+int RollbackManager::redoSize() const {
+    return redoTop + 1;
+}
+
+long long RollbackManager::getEvictions() const {
+    return evictions;
+}
+
+int RollbackManager::getCapacity() const {
+    return capacity;
+}
+
+int RollbackManager::peekRequest(int k) const {
+    if (k < 0 || k >= count) {
+        return -1;
+    }
+    return stack[(first + count - 1 - k) % capacity].requestIndex;
+}
+
+void RollbackManager::exportRecords(int* history, int* redo) const {
+    for (int i = 0; i < count; i++) {
+        const AllocationRecord& rec = stack[(first + i) % capacity];
+        history[3 * i] = rec.areaIndex;
+        history[3 * i + 1] = rec.slotID;
+        history[3 * i + 2] = rec.requestIndex;
+    }
+    for (int i = 0; i <= redoTop; i++) {
+        redo[3 * i] = redoStack[i].areaIndex;
+        redo[3 * i + 1] = redoStack[i].slotID;
+        redo[3 * i + 2] = redoStack[i].requestIndex;
+    }
+}
+
+void RollbackManager::importRecords(const int* history, int numHistory, const int* redo, int numRedo,
+                                    long long evictionCount) {
+    int skip = (numHistory > capacity) ? numHistory - capacity : 0;
+    first = 0;
+    count = 0;
+    for (int i = skip; i < numHistory; i++) {
+        stack[count].areaIndex = history[3 * i];
+        stack[count].slotID = history[3 * i + 1];
+        stack[count].requestIndex = history[3 * i + 2];
+        count++;
+    }
+    evictions = evictionCount + skip;
+    redoTop = -1;
+    for (int i = 0; i < numRedo && redoTop + 1 < capacity; i++) {
+        redoTop++;
+        redoStack[redoTop].areaIndex = redo[3 * i];
+        redoStack[redoTop].slotID = redo[3 * i + 1];
+        redoStack[redoTop].requestIndex = redo[3 * i + 2];
+    }
+}
@@ -3,44 +3,102 @@
 
 #include "ParkingArea.h"
 #include "ParkingRequest.h"
+#include "Analytics.h"
 
 // Stack is used because allocation operations follow LIFO (Last In, First Out) order,
 // allowing us to undo the most recent allocations first, which is essential for
 // rollback functionality in parking systems.
+//
+// The history is a ring buffer of maxOperations records allocated once up
+// front: when it is full, recording a new allocation evicts the oldest
+// record (counted in getEvictions()) instead of dropping the new one.
+// Undone records move to a redo stack so they can be replayed without
+// running allocation again; recording a new allocation clears it.
 
 class RollbackManager {
 private:
     struct AllocationRecord {
         int areaIndex;
         int slotID;
-        int requestID;
+        int requestIndex;  // Position in the ParkingSystem requests array
     };
 
-    AllocationRecord* stack;  // Array-based stack for allocation records
-    int top;                  // Index of the top element in the stack
-    int capacity;             // Maximum capacity of the stack
+    AllocationRecord* stack;      // Ring buffer of allocation records
+    int first;                    // Ring position of the oldest record
+    int count;                    // Number of records in the history
+    int capacity;                 // Maximum number of records kept
+    long long evictions;          // Records evicted because the history was full
+
+    AllocationRecord* redoStack;  // Undone records, most recently undone on top
+    int redoTop;                  // Index of the top element in the redo stack
+
+    Analytics* analytics;         // Running counters owned by ParkingSystem
+
+    // Push a record onto the history, evicting the oldest one if full
+    void push(const AllocationRecord& rec);
 
 public:
-    // Constructor: Initializes the stack with given capacity
-    RollbackManager(int maxOperations);
+    // Constructor: Initializes the history with given capacity and the analytics
+    // counters to update when a slot is freed or a request is cancelled
+    RollbackManager(int maxOperations, Analytics* stats);
 
     // Destructor
     ~RollbackManager();
 
-    // Record a parking allocation on the stack
-    void recordAllocation(int areaIndex, int slotID, int requestID);
+    // Record a parking allocation on the stack. Requests are only ever
+    // appended, so the request's array position stays valid and undo reaches
+    // the request directly instead of searching by requestID
+    void recordAllocation(int areaIndex, int slotID, int requestIndex);
 
-    // Undo the last allocation: free the slot and restore request state
+    // Record a batch of allocations as one contiguous block (in allocation
+    // order, so the last one is undone first)
+    void recordAllocations(const int* areaIndices, const int* slotIDs, const int* requestIndices, int numRecords);
+
+    // Undo the last allocation: free the slot and restore request state, O(1).
+    // A record whose request is no longer ALLOCATED on the recorded slot
+    // (occupied, released or cancelled since) is dropped without freeing it
     void undoLast(ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests);
 
-    // Undo the last k allocations: free slots and restore request states
+    // Undo the last k allocations: free slots and restore request states, O(k)
     void undoLastK(int k, ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests);
 
+    // Redo the most recently undone allocation: occupy the same slot again and
+    // move the request from CANCELLED back to ALLOCATED, O(1).
+    // Returns false if there is nothing to redo or the record can no longer be
+    // replayed (slot taken again); such a record is discarded
+    bool redoLast(ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests);
+
+    // Redo up to k undone allocations in their original order
+    // Returns the number actually redone, O(k)
+    int redoLastK(int k, ParkingArea* areas, int numAreas, ParkingRequest* requests, int numRequests);
+
     // Check if stack is empty
     bool isEmpty() const;
 
     // Get current number of recorded allocations
     int size() const;
+
+    // Get number of undone allocations that can be redone
+    int redoSize() const;
+
+    // Get number of records evicted because the history was full
+    long long getEvictions() const;
+
+    // Get maximum number of records kept
+    int getCapacity() const;
+
+    // Get the request index of the k-th newest history record (0 = newest),
+    // or -1 if there are not that many
+    int peekRequest(int k) const;
+
+    // Snapshot support: copy the history (oldest first) and the redo stack
+    // (bottom first) as flat triples (areaIndex, slotID, requestIndex)
+    void exportRecords(int* history, int* redo) const;
+
+    // Snapshot support: replace the history and redo stack with exported
+    // records (the oldest history records are dropped if over capacity)
+    void importRecords(const int* history, int numHistory, const int* redo, int numRedo,
+                       long long evictionCount);
 };
 
-#endif // ROLLBACK_MANAGER_H
\ No newline at end of file
+#endif // ROLLBACK_MANAGER_H
@@ -0,0 +1,450 @@
+#include "SlotStore.h"
+#include <cstring>  // For memcpy
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit of a non-zero word
+static int countTrailingZeros(unsigned long long word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+// Number of set bits in a word
+static int countBits(unsigned long long word) {
+#if defined(_MSC_VER)
+    return static_cast<int>(__popcnt64(word));
+#else
+    return __builtin_popcountll(word);
+#endif
+}
+
+// Bits of bitmap word w that fall inside the position range [first, end)
+static unsigned long long rangeMask(int w, int first, int end) {
+    unsigned long long mask = ~0ULL;
+    int low = first - (w << 6);
+    int high = end - (w << 6);
+    if (low > 0) {
+        mask &= ~0ULL << low;
+    }
+    if (high < 64) {
+        mask &= (1ULL << high) - 1;
+    }
+    return mask;
+}
+
+// Read a bitmap word that other threads may be updating (other bits of it)
+static unsigned long long loadWord(const unsigned long long* word) {
+#if defined(_MSC_VER)
+    return *static_cast<const volatile unsigned long long*>(word);
+#else
+    return __atomic_load_n(word, __ATOMIC_RELAXED);
+#endif
+}
+
+// Round a position count up to a whole number of bitmap words
+static int roundToWord(int positions) {
+    return (positions + 63) & ~63;
+}
+
+SlotStore::SlotStore() {
+    init(nullptr, 64);  // Default capacity: one bitmap word
+}
+
+SlotStore::SlotStore(int initialCapacity) {
+    init(nullptr, initialCapacity);
+}
+
+SlotStore::SlotStore(Arena* columnArena, int initialCapacity) {
+    init(columnArena, initialCapacity);
+}
+
+void SlotStore::init(Arena* columnArena, int initialCapacity) {
+    capacity = roundToWord(initialCapacity > 0 ? initialCapacity : 1);
+    size = 0;
+    shared = false;
+    arena = columnArena;
+    freeRangeFirst = nullptr;
+    freeRangeCount = nullptr;
+    numFreeRanges = 0;
+    freeRangeCapacity = 0;
+    allocateColumns(capacity, &slotIDs, &zoneIDs, &coordinates, &slotTypes, &freeBits);
+}
+
+SlotStore::~SlotStore() {
+    releaseColumns();
+    if (arena == nullptr) {
+        delete[] freeRangeFirst;
+        delete[] freeRangeCount;
+    } else {
+        arena->releaseArray(freeRangeFirst, freeRangeCapacity);
+        arena->releaseArray(freeRangeCount, freeRangeCapacity);
+    }
+}
+
+void SlotStore::allocateColumns(int columnCapacity, int** outSlotIDs, int** outZoneIDs, SlotCoordinates** outCoordinates,
+                                unsigned char** outSlotTypes, unsigned long long** outFreeBits) {
+    int words = columnCapacity / 64;
+    if (arena != nullptr) {
+        *outSlotIDs = arena->allocateArray<int>(columnCapacity);
+        *outZoneIDs = arena->allocateArray<int>(columnCapacity);
+        *outCoordinates = arena->allocateArray<SlotCoordinates>(columnCapacity);
+        *outSlotTypes = arena->allocateArray<unsigned char>(columnCapacity);
+        *outFreeBits = arena->allocateArray<unsigned long long>(words);
+    } else {
+        *outSlotIDs = new int[columnCapacity];
+        *outZoneIDs = new int[columnCapacity];
+        *outCoordinates = new SlotCoordinates[columnCapacity];
+        *outSlotTypes = new unsigned char[columnCapacity];
+        *outFreeBits = new unsigned long long[words];
+    }
+    for (int w = 0; w < words; w++) {
+        (*outFreeBits)[w] = 0;
+    }
+}
+
+void SlotStore::releaseColumns() {
+    if (arena == nullptr) {
+        delete[] slotIDs;
+        delete[] zoneIDs;
+        delete[] coordinates;
+        delete[] slotTypes;
+        delete[] freeBits;
+        return;
+    }
+    arena->releaseArray(slotIDs, capacity);
+    arena->releaseArray(zoneIDs, capacity);
+    arena->releaseArray(coordinates, capacity);
+    arena->releaseArray(slotTypes, capacity);
+    arena->releaseArray(freeBits, capacity / 64);
+}
+
+void SlotStore::grow(int needed) {
+    int newCapacity = capacity * 2;
+    while (newCapacity < needed) {
+        newCapacity *= 2;
+    }
+    int* newSlotIDs;
+    int* newZoneIDs;
+    SlotCoordinates* newCoordinates;
+    unsigned char* newSlotTypes;
+    unsigned long long* newFreeBits;
+    allocateColumns(newCapacity, &newSlotIDs, &newZoneIDs, &newCoordinates, &newSlotTypes, &newFreeBits);
+    for (int p = 0; p < size; p++) {
+        newSlotIDs[p] = slotIDs[p];
+        newZoneIDs[p] = zoneIDs[p];
+        newCoordinates[p] = coordinates[p];
+        newSlotTypes[p] = slotTypes[p];
+    }
+    for (int w = 0; w < capacity / 64; w++) {
+        newFreeBits[w] = freeBits[w];
+    }
+    releaseColumns();
+    slotIDs = newSlotIDs;
+    zoneIDs = newZoneIDs;
+    coordinates = newCoordinates;
+    slotTypes = newSlotTypes;
+    freeBits = newFreeBits;
+    capacity = newCapacity;
+}
+
+void SlotStore::clearPositions(int first, int end) {
+    for (int p = first; p < end; p++) {
+        slotIDs[p] = -1;
+        zoneIDs[p] = -1;
+        coordinates[p].x = 0;
+        coordinates[p].y = 0;
+        coordinates[p].level = 0;
+        slotTypes[p] = SLOT_STANDARD;
+    }
+}
+
+int SlotStore::reserve(int count) {
+    // Step 1: Reuse the first released range that is long enough
+    for (int r = 0; count > 0 && r < numFreeRanges; r++) {
+        if (freeRangeCount[r] >= count) {
+            int first = freeRangeFirst[r];
+            freeRangeFirst[r] += count;
+            freeRangeCount[r] -= count;
+            if (freeRangeCount[r] == 0) {
+                numFreeRanges--;
+                freeRangeFirst[r] = freeRangeFirst[numFreeRanges];
+                freeRangeCount[r] = freeRangeCount[numFreeRanges];
+            }
+            clearPositions(first, first + count);
+            return first;
+        }
+    }
+
+    // Step 2: Otherwise pack the new range right after the last one
+    int first = size;
+    int end = first + (count > 0 ? count : 0);
+    if (end > capacity) {
+        grow(end);
+    }
+    clearPositions(first, end);
+    size = end;
+    return first;
+}
+
+void SlotStore::addFreeRange(int first, int count) {
+    if (numFreeRanges == freeRangeCapacity) {
+        int newCapacity = Arena::grownCapacity(freeRangeCapacity, 4, Arena::DEFAULT_GROWTH_FACTOR);
+        int* newFirst = (arena != nullptr) ? arena->allocateArray<int>(newCapacity) : new int[newCapacity];
+        int* newCount = (arena != nullptr) ? arena->allocateArray<int>(newCapacity) : new int[newCapacity];
+        for (int r = 0; r < numFreeRanges; r++) {
+            newFirst[r] = freeRangeFirst[r];
+            newCount[r] = freeRangeCount[r];
+        }
+        if (arena == nullptr) {
+            delete[] freeRangeFirst;
+            delete[] freeRangeCount;
+        } else {
+            arena->releaseArray(freeRangeFirst, freeRangeCapacity);
+            arena->releaseArray(freeRangeCount, freeRangeCapacity);
+        }
+        freeRangeFirst = newFirst;
+        freeRangeCount = newCount;
+        freeRangeCapacity = newCapacity;
+    }
+    freeRangeFirst[numFreeRanges] = first;
+    freeRangeCount[numFreeRanges] = count;
+    numFreeRanges++;
+}
+
+void SlotStore::releaseRange(int first, int count) {
+    if (count <= 0) {
+        return;
+    }
+    // Bits of positions that are not handed out stay clear, so reused and
+    // appended positions start not free without touching the bitmap
+    clearPositions(first, first + count);
+    for (int p = first; p < first + count; p++) {
+        setFree(p, false);
+    }
+
+    // Merge with released neighbours, so a later larger range fits
+    for (int r = 0; r < numFreeRanges; r++) {
+        if (freeRangeFirst[r] + freeRangeCount[r] == first || first + count == freeRangeFirst[r]) {
+            if (freeRangeFirst[r] < first) {
+                first = freeRangeFirst[r];
+            }
+            count += freeRangeCount[r];
+            numFreeRanges--;
+            freeRangeFirst[r] = freeRangeFirst[numFreeRanges];
+            freeRangeCount[r] = freeRangeCount[numFreeRanges];
+            r = -1;  // Rescan: the merged range may touch another one
+        }
+    }
+
+    // The last range just shrinks the store; any other is kept for reuse
+    if (first + count == size) {
+        size = first;
+    } else {
+        addFreeRange(first, count);
+    }
+}
+
+bool SlotStore::extendRange(int first, int count, int newCount) {
+    if (first + count != size || newCount < count) {
+        return false;
+    }
+    int end = first + newCount;
+    if (end > capacity) {
+        grow(end);
+    }
+    clearPositions(size, end);
+    size = end;
+    return true;
+}
+
+void SlotStore::setSlot(int position, int slotID, int zoneID, bool available) {
+    slotIDs[position] = slotID;
+    zoneIDs[position] = zoneID;
+    setFree(position, available);
+}
+
+void SlotStore::setCoordinates(int position, int x, int y, int level) {
+    coordinates[position].x = x;
+    coordinates[position].y = y;
+    coordinates[position].level = level;
+}
+
+void SlotStore::setSlotType(int position, int slotType) {
+    slotTypes[position] = static_cast<unsigned char>(slotType);
+}
+
+void SlotStore::copySlots(int toFirst, const SlotStore& from, int fromFirst, int count) {
+    for (int i = 0; i < count; i++) {
+        setSlot(toFirst + i, from.slotIDs[fromFirst + i], from.zoneIDs[fromFirst + i],
+                from.isFree(fromFirst + i));
+        coordinates[toFirst + i] = from.coordinates[fromFirst + i];
+        slotTypes[toFirst + i] = from.slotTypes[fromFirst + i];
+    }
+}
+
+int SlotStore::getSlotID(int position) const {
+    return slotIDs[position];
+}
+
+int SlotStore::getZoneID(int position) const {
+    return zoneIDs[position];
+}
+
+bool SlotStore::isFree(int position) const {
+    return (loadWord(&freeBits[position >> 6]) >> (position & 63)) & 1ULL;
+}
+
+const SlotCoordinates& SlotStore::getCoordinates(int position) const {
+    return coordinates[position];
+}
+
+int SlotStore::getSlotType(int position) const {
+    return slotTypes[position];
+}
+
+void SlotStore::clearBits(int word, unsigned long long mask) {
+    if (!shared) {
+        freeBits[word] &= ~mask;
+        return;
+    }
+#if defined(_MSC_VER)
+    _InterlockedAnd64(reinterpret_cast<volatile __int64*>(&freeBits[word]), static_cast<__int64>(~mask));
+#else
+    __atomic_fetch_and(&freeBits[word], ~mask, __ATOMIC_RELAXED);
+#endif
+}
+
+void SlotStore::setBits(int word, unsigned long long mask) {
+    if (!shared) {
+        freeBits[word] |= mask;
+        return;
+    }
+#if defined(_MSC_VER)
+    _InterlockedOr64(reinterpret_cast<volatile __int64*>(&freeBits[word]), static_cast<__int64>(mask));
+#else
+    __atomic_fetch_or(&freeBits[word], mask, __ATOMIC_RELAXED);
+#endif
+}
+
+void SlotStore::setFree(int position, bool available) {
+    unsigned long long mask = 1ULL << (position & 63);
+    if (available) {
+        setBits(position >> 6, mask);
+    } else {
+        clearBits(position >> 6, mask);
+    }
+}
+
+int SlotStore::findFree(int first, int count) const {
+    int end = first + count;
+    for (int w = first >> 6; (w << 6) < end; w++) {
+        unsigned long long word = loadWord(&freeBits[w]) & rangeMask(w, first, end);
+        if (word != 0) {
+            return (w << 6) + countTrailingZeros(word);
+        }
+    }
+    return -1;  // No free position in the range
+}
+
+int SlotStore::claimFree(int first, int count, int maxCount, int* outPositions) {
+    int claimed = 0;
+    int end = first + count;
+    for (int w = first >> 6; (w << 6) < end && claimed < maxCount; w++) {
+        unsigned long long word = loadWord(&freeBits[w]) & rangeMask(w, first, end);
+        unsigned long long taken = 0;
+        while (word != 0 && claimed < maxCount) {
+            taken |= word & (~word + 1);
+            outPositions[claimed++] = (w << 6) + countTrailingZeros(word);
+            word &= word - 1;  // Clear lowest set bit
+        }
+        if (taken != 0) {
+            clearBits(w, taken);  // One update per word
+        }
+    }
+    return claimed;
+}
+
+int SlotStore::countFree(int first, int count) const {
+    int free = 0;
+    int end = first + count;
+    for (int w = first >> 6; (w << 6) < end; w++) {
+        free += countBits(loadWord(&freeBits[w]) & rangeMask(w, first, end));
+    }
+    return free;
+}
+
+int SlotStore::getSize() const {
+    return size;
+}
+
+void SlotStore::setShared(bool concurrent) {
+    shared = concurrent;
+}
+
+Arena* SlotStore::getArena() const {
+    return arena;
+}
+
+const int* SlotStore::getSlotIDColumn() const {
+    return slotIDs;
+}
+
+const int* SlotStore::getZoneIDColumn() const {
+    return zoneIDs;
+}
+
+const SlotCoordinates* SlotStore::getCoordinatesColumn() const {
+    return coordinates;
+}
+
+const unsigned char* SlotStore::getSlotTypeColumn() const {
+    return slotTypes;
+}
+
+const unsigned long long* SlotStore::getFreeBitsColumn() const {
+    return freeBits;
+}
+
+int SlotStore::getNumFreeRanges() const {
+    return numFreeRanges;
+}
+
+void SlotStore::exportFreeRanges(int* outFirsts, int* outCounts) const {
+    for (int r = 0; r < numFreeRanges; r++) {
+        outFirsts[r] = freeRangeFirst[r];
+        outCounts[r] = freeRangeCount[r];
+    }
+}
+
+void SlotStore::restoreFreeRanges(const int* firsts, const int* counts, int count) {
+    numFreeRanges = 0;
+    for (int r = 0; r < count; r++) {
+        addFreeRange(firsts[r], counts[r]);
+    }
+}
+
+void SlotStore::restoreColumns(int count, const int* fromSlotIDs, const int* fromZoneIDs,
+                               const SlotCoordinates* fromCoordinates, const unsigned char* fromSlotTypes,
+                               const unsigned long long* fromFreeBits) {
+    if (count > capacity) {
+        grow(count);
+    }
+    int words = roundToWord(count) / 64;
+    std::memcpy(slotIDs, fromSlotIDs, sizeof(int) * count);
+    std::memcpy(zoneIDs, fromZoneIDs, sizeof(int) * count);
+    std::memcpy(coordinates, fromCoordinates, sizeof(SlotCoordinates) * count);
+    std::memcpy(slotTypes, fromSlotTypes, count);
+    std::memcpy(freeBits, fromFreeBits, sizeof(unsigned long long) * words);
+    for (int w = words; w < capacity / 64; w++) {
+        freeBits[w] = 0;
+    }
+    size = count;
+    numFreeRanges = 0;  // Until restoreFreeRanges
+}
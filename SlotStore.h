@@ -0,0 +1,171 @@
+#ifndef SLOT_STORE_H
+#define SLOT_STORE_H
+
+#include "Arena.h"
+#include "SlotType.h"
+
+// Location of a slot, kept together because distance queries read all three
+struct SlotCoordinates {
+    int x;
+    int y;
+    int level;
+};
+
+// Facility-wide columnar (structure-of-arrays) slot storage.
+// Instead of an array of ParkingSlot records per area and per zone, every
+// slot lives at one position in five parallel columns: slotIDs, zoneIDs,
+// coordinates, slot types and an availability bitmap (the state column).
+// Areas and zones reserve ranges
+// of positions and act as views over them, so an area and its zone always
+// see the same availability bit, and availability scans read only the
+// bitmap, 64 slots per word.
+//
+// Ranges are packed back to back, so neighbouring ranges (possibly of
+// different zones) can share a bitmap word. Once the store is shared
+// between threads (setShared), availability bits are updated with atomic
+// read-modify-writes, so zones can still update their bits under different
+// locks; serial use keeps plain updates.
+// Positions never move, even when the columns grow. A range given back with
+// releaseRange is reused by a later reserve (first fit), and the last range
+// can be extended in place, so views that grow do not leave dead positions
+// behind.
+
+class SlotStore {
+private:
+    int* slotIDs;                  // slotID at each position (-1 for unused positions)
+    int* zoneIDs;                  // zoneID at each position (-1 for unused positions)
+    SlotCoordinates* coordinates;  // Location at each position (0, 0, 0 unless set)
+    unsigned char* slotTypes;      // SlotType at each position (SLOT_STANDARD unless set)
+    unsigned long long* freeBits;  // Availability bitmap: bit p set when position p is free
+    int size;                      // Positions handed out so far
+    int capacity;                  // Capacity of the columns (multiple of 64)
+    bool shared;                   // True when several threads update the bitmap (atomic updates)
+    Arena* arena;                  // Arena the columns come from (nullptr = heap)
+    int* freeRangeFirst;           // Released ranges below size: first position of each
+    int* freeRangeCount;           // Released ranges below size: length of each
+    int numFreeRanges;             // Number of released ranges
+    int freeRangeCapacity;         // Capacity of the released-range arrays
+
+    // Set up the members shared by every constructor
+    void init(Arena* columnArena, int initialCapacity);
+
+    // Reset the columns of positions [first, end) to unused (the bitmap is
+    // left alone: bits of positions not in use are always clear)
+    void clearPositions(int first, int end);
+
+    // Remember a released range for reuse
+    void addFreeRange(int first, int count);
+
+    // Clear or set bits of one bitmap word (atomically when shared)
+    void clearBits(int word, unsigned long long mask);
+    void setBits(int word, unsigned long long mask);
+
+    // Allocate the columns for a capacity, from the arena or the heap
+    void allocateColumns(int columnCapacity, int** outSlotIDs, int** outZoneIDs, SlotCoordinates** outCoordinates,
+                         unsigned char** outSlotTypes, unsigned long long** outFreeBits);
+
+    // Release the current columns (to the heap or the arena)
+    void releaseColumns();
+
+    // Grow the columns (geometrically) to hold at least the given positions
+    void grow(int needed);
+
+public:
+    // Constructor: Creates an empty store
+    SlotStore();
+
+    // Constructor with initial capacity (in slots)
+    SlotStore(int initialCapacity);
+
+    // Constructor for a store whose columns come from an arena. Views
+    // attached to this store keep their own buffers in the same arena
+    SlotStore(Arena* columnArena, int initialCapacity);
+
+    // Destructor
+    ~SlotStore();
+
+    // Views refer to positions in one store, so the store is not copyable
+    SlotStore(const SlotStore& other) = delete;
+    SlotStore& operator=(const SlotStore& other) = delete;
+
+    // Reserve a range of count positions and return its first position
+    // Reserved positions start unused: slotID -1, zoneID -1, at (0, 0, 0),
+    // SLOT_STANDARD, not free
+    int reserve(int count);
+
+    // Give a range back for reuse by later reserves. Its positions become
+    // unused; a view must not refer to them afterwards
+    void releaseRange(int first, int count);
+
+    // Extend the range [first, first + count) to newCount positions in place
+    // if it is the last range in the store. Returns false (and changes
+    // nothing) otherwise
+    bool extendRange(int first, int count, int newCount);
+
+    // Write one slot at a position
+    void setSlot(int position, int slotID, int zoneID, bool available);
+
+    // Set the location of the slot at a position
+    void setCoordinates(int position, int x, int y, int level);
+
+    // Set the type of the slot at a position (a SlotType value)
+    void setSlotType(int position, int slotType);
+
+    // Copy count slots (with their locations and types) from another store
+    // (or another range of this one)
+    void copySlots(int toFirst, const SlotStore& from, int fromFirst, int count);
+
+    // Getters for one position
+    int getSlotID(int position) const;
+    int getZoneID(int position) const;
+    bool isFree(int position) const;
+    const SlotCoordinates& getCoordinates(int position) const;
+    int getSlotType(int position) const;
+
+    // Set or clear the availability bit of one position
+    void setFree(int position, bool available);
+
+    // First free position in [first, first + count) (-1 if none)
+    int findFree(int first, int count) const;
+
+    // Mark up to maxCount free positions in [first, first + count) as
+    // occupied, lowest first, writing them to outPositions
+    // Returns how many were claimed
+    int claimFree(int first, int count, int maxCount, int* outPositions);
+
+    // Number of free positions in [first, first + count)
+    int countFree(int first, int count) const;
+
+    // Getter for number of positions handed out
+    int getSize() const;
+
+    // Switch bitmap updates to atomic read-modify-writes, for threads that
+    // update ranges sharing a bitmap word under different locks
+    void setShared(bool concurrent);
+
+    // Getter for the arena backing this store (nullptr if heap-allocated)
+    Arena* getArena() const;
+
+    // Snapshot support: the raw columns (getSize() positions, and
+    // getSize() rounded up to 64 bits in the bitmap)
+    const int* getSlotIDColumn() const;
+    const int* getZoneIDColumn() const;
+    const SlotCoordinates* getCoordinatesColumn() const;
+    const unsigned char* getSlotTypeColumn() const;
+    const unsigned long long* getFreeBitsColumn() const;
+
+    // Snapshot support: the released ranges kept for reuse (getNumFreeRanges()
+    // of them), and restoring them after restoreColumns
+    int getNumFreeRanges() const;
+    void exportFreeRanges(int* outFirsts, int* outCounts) const;
+    void restoreFreeRanges(const int* firsts, const int* counts, int count);
+
+    // Snapshot support: replace the contents with count positions copied
+    // in bulk from flat columns (e.g. a mapped snapshot). Released ranges
+    // are forgotten until restoreFreeRanges
+    void restoreColumns(int count, const int* fromSlotIDs, const int* fromZoneIDs,
+                        const SlotCoordinates* fromCoordinates, const unsigned char* fromSlotTypes,
+                        const unsigned long long* fromFreeBits);
+};
+
+#endif // SLOT_STORE_H
@@ -0,0 +1,11 @@
+#include "SlotType.h"
+
+const char* slotTypeName(int slotType) {
+    static const char* const NAMES[NUM_SLOT_TYPES] = {"STANDARD", "COMPACT", "EV", "ACCESSIBLE", "MOTORCYCLE"};
+    return isValidSlotType(slotType) ? NAMES[slotType] : "UNKNOWN";
+}
+
+const char* vehicleClassName(int vehicleClass) {
+    static const char* const NAMES[NUM_VEHICLE_CLASSES] = {"STANDARD", "COMPACT", "EV", "ACCESSIBLE", "MOTORCYCLE"};
+    return isValidVehicleClass(vehicleClass) ? NAMES[vehicleClass] : "UNKNOWN";
+}
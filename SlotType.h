@@ -0,0 +1,97 @@
+#ifndef SLOT_TYPE_H
+#define SLOT_TYPE_H
+
+// Slot types, vehicle classes and the rules for which slot types a vehicle
+// class may park in.
+//
+// Slots and vehicles both default to STANDARD, so a facility that never
+// sets a type allocates exactly as before. Each vehicle class accepts an
+// ordered list of slot types: its own type first, then fallbacks. Reserved
+// bays (EV chargers, accessible bays) accept only their own class, so a
+// standard car never takes one, while the smaller classes may fall back to
+// larger bays. The allocation engine walks the list in order and takes a
+// slot of the first type that has one free in a zone.
+
+enum SlotType {
+    SLOT_STANDARD = 0,  // Regular car bay
+    SLOT_COMPACT,       // Small-car bay
+    SLOT_EV,            // Bay with an EV charger
+    SLOT_ACCESSIBLE,    // Accessible bay (permit holders only)
+    SLOT_MOTORCYCLE,    // Motorcycle bay
+    NUM_SLOT_TYPES      // Number of slot types
+};
+
+enum VehicleClass {
+    VEHICLE_STANDARD = 0,  // Regular car
+    VEHICLE_COMPACT,       // Small car
+    VEHICLE_EV,            // Electric vehicle (prefers a charger)
+    VEHICLE_ACCESSIBLE,    // Car with an accessible-parking permit
+    VEHICLE_MOTORCYCLE,    // Motorcycle
+    NUM_VEHICLE_CLASSES    // Number of vehicle classes
+};
+
+// Slot types each vehicle class accepts, best first, ending at -1
+constexpr signed char SLOT_PREFERENCES[NUM_VEHICLE_CLASSES][NUM_SLOT_TYPES + 1] = {
+    {SLOT_STANDARD,   -1,            -1,            -1, -1, -1},  // VEHICLE_STANDARD
+    {SLOT_COMPACT,    SLOT_STANDARD, -1,            -1, -1, -1},  // VEHICLE_COMPACT
+    {SLOT_EV,         SLOT_STANDARD, -1,            -1, -1, -1},  // VEHICLE_EV
+    {SLOT_ACCESSIBLE, SLOT_STANDARD, -1,            -1, -1, -1},  // VEHICLE_ACCESSIBLE
+    {SLOT_MOTORCYCLE, SLOT_COMPACT,  SLOT_STANDARD, -1, -1, -1}   // VEHICLE_MOTORCYCLE
+};
+
+// Slot type a vehicle class tries at a rank (0 = best), -1 past the end
+constexpr int preferredSlotType(int vehicleClass, int rank) {
+    return SLOT_PREFERENCES[vehicleClass][rank];
+}
+
+// Number of slot types a vehicle class accepts
+constexpr int compatibleTypeCount(int vehicleClass, int rank = 0) {
+    return (SLOT_PREFERENCES[vehicleClass][rank] < 0) ? 0 : 1 + compatibleTypeCount(vehicleClass, rank + 1);
+}
+
+// Check if a vehicle class may park in a slot type
+constexpr bool isCompatible(int vehicleClass, int slotType, int rank = 0) {
+    return SLOT_PREFERENCES[vehicleClass][rank] >= 0 &&
+           (SLOT_PREFERENCES[vehicleClass][rank] == slotType || isCompatible(vehicleClass, slotType, rank + 1));
+}
+
+// Number of vehicle classes that accept a slot type (compile-time checks)
+constexpr int classesAccepting(int slotType, int vehicleClass = 0) {
+    return (vehicleClass == NUM_VEHICLE_CLASSES) ? 0
+           : (isCompatible(vehicleClass, slotType) ? 1 : 0) + classesAccepting(slotType, vehicleClass + 1);
+}
+
+// Check that no class lists a slot type twice (compile-time checks)
+constexpr bool preferencesDistinct(int vehicleClass = 0, int rank = 0, int later = 1) {
+    return vehicleClass == NUM_VEHICLE_CLASSES ||
+           (rank == NUM_SLOT_TYPES ? preferencesDistinct(vehicleClass + 1, 0, 1)
+            : later > NUM_SLOT_TYPES ? preferencesDistinct(vehicleClass, rank + 1, rank + 2)
+            : ((SLOT_PREFERENCES[vehicleClass][rank] < 0 ||
+                SLOT_PREFERENCES[vehicleClass][rank] != SLOT_PREFERENCES[vehicleClass][later]) &&
+               preferencesDistinct(vehicleClass, rank, later + 1)));
+}
+
+static_assert(preferencesDistinct(), "A vehicle class lists each slot type at most once");
+static_assert(preferredSlotType(VEHICLE_STANDARD, 0) == SLOT_STANDARD && preferredSlotType(VEHICLE_COMPACT, 0) == SLOT_COMPACT &&
+              preferredSlotType(VEHICLE_EV, 0) == SLOT_EV && preferredSlotType(VEHICLE_ACCESSIBLE, 0) == SLOT_ACCESSIBLE &&
+              preferredSlotType(VEHICLE_MOTORCYCLE, 0) == SLOT_MOTORCYCLE,
+              "Every vehicle class prefers its own slot type");
+static_assert(classesAccepting(SLOT_EV) == 1 && classesAccepting(SLOT_ACCESSIBLE) == 1,
+              "EV and accessible bays are reserved for their own class");
+static_assert(classesAccepting(SLOT_STANDARD) == NUM_VEHICLE_CLASSES,
+              "Every vehicle class can fall back to a standard bay");
+
+// Names of slot types and vehicle classes (for exported counters)
+const char* slotTypeName(int slotType);
+const char* vehicleClassName(int vehicleClass);
+
+// Check that a value is a slot type / vehicle class
+inline bool isValidSlotType(int slotType) {
+    return slotType >= 0 && slotType < NUM_SLOT_TYPES;
+}
+
+inline bool isValidVehicleClass(int vehicleClass) {
+    return vehicleClass >= 0 && vehicleClass < NUM_VEHICLE_CLASSES;
+}
+
+#endif // SLOT_TYPE_H
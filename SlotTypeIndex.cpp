@@ -0,0 +1,101 @@
+#include "SlotTypeIndex.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// Index of the lowest set bit of a non-zero word
+static int countTrailingZeros(unsigned long long word) {
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctzll(word);
+#endif
+}
+
+SlotTypeIndex::SlotTypeIndex() {
+    built = false;
+    arena = nullptr;
+    numWords = 0;
+    numSummaryWords = 0;
+    freeBits = nullptr;
+    summaryBits = nullptr;
+}
+
+SlotTypeIndex::~SlotTypeIndex() {
+    clear();
+}
+
+unsigned long long* SlotTypeIndex::allocate(int count) {
+    if (count < 1) {
+        count = 1;
+    }
+    unsigned long long* words = (arena != nullptr) ? arena->allocateArray<unsigned long long>(count)
+                                                   : new unsigned long long[count];
+    for (int i = 0; i < count; i++) {
+        words[i] = 0;
+    }
+    return words;
+}
+
+void SlotTypeIndex::clear() {
+    if (arena == nullptr) {
+        delete[] freeBits;
+        delete[] summaryBits;
+    } else {
+        arena->releaseArray(freeBits, NUM_SLOT_TYPES * numWords);
+        arena->releaseArray(summaryBits, NUM_SLOT_TYPES * numSummaryWords);
+    }
+    freeBits = nullptr;
+    summaryBits = nullptr;
+    numWords = 0;
+    numSummaryWords = 0;
+    built = false;
+}
+
+void SlotTypeIndex::build(const SlotStore* store, int first, int count, Arena* indexArena) {
+    clear();
+    arena = indexArena;
+    numWords = (count > 0) ? (count + 63) / 64 : 1;
+    numSummaryWords = (numWords + 63) / 64;
+    freeBits = allocate(NUM_SLOT_TYPES * numWords);
+    summaryBits = allocate(NUM_SLOT_TYPES * numSummaryWords);
+    for (int i = 0; i < count; i++) {
+        if (store->isFree(first + i)) {
+            int type = store->getSlotType(first + i);
+            freeBits[type * numWords + (i >> 6)] |= 1ULL << (i & 63);
+            summaryBits[type * numSummaryWords + (i >> 12)] |= 1ULL << ((i >> 6) & 63);
+        }
+    }
+    built = true;
+}
+
+bool SlotTypeIndex::isBuilt() const {
+    return built;
+}
+
+void SlotTypeIndex::onOccupied(int offset, int slotType) {
+    int w = slotType * numWords + (offset >> 6);
+    freeBits[w] &= ~(1ULL << (offset & 63));
+    if (freeBits[w] == 0) {
+        summaryBits[slotType * numSummaryWords + (offset >> 12)] &= ~(1ULL << ((offset >> 6) & 63));
+    }
+}
+
+void SlotTypeIndex::onFreed(int offset, int slotType) {
+    freeBits[slotType * numWords + (offset >> 6)] |= 1ULL << (offset & 63);
+    summaryBits[slotType * numSummaryWords + (offset >> 12)] |= 1ULL << ((offset >> 6) & 63);
+}
+
+int SlotTypeIndex::findFirst(int slotType) const {
+    const unsigned long long* summary = summaryBits + slotType * numSummaryWords;
+    for (int s = 0; s < numSummaryWords; s++) {
+        if (summary[s] != 0) {
+            int w = (s << 6) + countTrailingZeros(summary[s]);
+            return (w << 6) + countTrailingZeros(freeBits[slotType * numWords + w]);
+        }
+    }
+    return -1;  // No free slot of this type
+}
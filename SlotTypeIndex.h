@@ -0,0 +1,63 @@
+#ifndef SLOT_TYPE_INDEX_H
+#define SLOT_TYPE_INDEX_H
+
+#include "Arena.h"
+#include "SlotStore.h"
+#include "SlotType.h"
+
+// Per-slot-type free structure over one area's slots, so a search for a
+// slot of one type goes straight to a free slot of that type instead of
+// scanning past slots of other types.
+//
+// Each slot type has its own availability bitmap over the area's offsets
+// and a summary bitmap with one bit per non-empty bitmap word. The lowest
+// free slot of a type is found with two bit scans for areas of up to 4096
+// slots (one more summary word per further 4096), and occupy/free update
+// the two bits in O(1). The area reports every occupy/free of an indexed
+// slot. Only areas that mix slot types need the index: in a single-type
+// area the store's own bitmap already is that type's free structure.
+// Arrays come from the area's arena when it has one.
+
+class SlotTypeIndex {
+private:
+    bool built;                       // True once build() ran (and nothing invalidated it)
+    Arena* arena;                     // Arena the arrays come from (nullptr = heap)
+    int numWords;                     // Bitmap words per type
+    int numSummaryWords;              // Summary words per type
+    unsigned long long* freeBits;     // NUM_SLOT_TYPES bitmaps: bit i set when offset i is a free slot of that type
+    unsigned long long* summaryBits;  // NUM_SLOT_TYPES summaries: bit w set when word w of that bitmap is non-zero
+
+    // Allocate a zeroed word array from the arena or the heap
+    unsigned long long* allocate(int count);
+
+public:
+    // Constructor: Not built
+    SlotTypeIndex();
+
+    // Destructor: Frees heap arrays
+    ~SlotTypeIndex();
+
+    // An index belongs to one area's range, so it is not copyable
+    SlotTypeIndex(const SlotTypeIndex& other) = delete;
+    SlotTypeIndex& operator=(const SlotTypeIndex& other) = delete;
+
+    // Index the count slots at positions [first, first + count) of a store,
+    // taking arrays from indexArena (nullptr = heap). O(count)
+    void build(const SlotStore* store, int first, int count, Arena* indexArena);
+
+    // Drop the index (heap arrays are freed; arena arrays stay in the arena)
+    void clear();
+
+    // Check if the index is built
+    bool isBuilt() const;
+
+    // Keep the bitmaps in step when the slot at an offset (of a slot type)
+    // is occupied or freed, O(1)
+    void onOccupied(int offset, int slotType);
+    void onFreed(int offset, int slotType);
+
+    // Lowest offset holding a free slot of a type, -1 if none
+    int findFirst(int slotType) const;
+};
+
+#endif // SLOT_TYPE_INDEX_H
@@ -0,0 +1,207 @@
+#include "Snapshot.h"
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define SNAPSHOT_HAS_MMAP 1
+#endif
+
+static const char SNAPSHOT_MAGIC[4] = {'P', 'K', 'S', 'N'};
+static const int SNAPSHOT_BYTE_ORDER = 0x01020304;  // Reads differently on another byte order
+
+struct SnapshotFileHeader {
+    char magic[4];  // "PKSN"
+    int version;    // SnapshotWriter::VERSION
+    int byteOrder;  // SNAPSHOT_BYTE_ORDER
+    int reserved;   // Always 0
+};
+
+struct SnapshotSectionHeader {
+    int tag;             // SnapshotSection
+    int reserved;        // Always 0
+    long long bytes;     // Payload bytes (before padding)
+};
+
+static_assert(sizeof(SnapshotFileHeader) == 16, "Snapshot header must stay 16 bytes");
+static_assert(sizeof(SnapshotSectionHeader) == 16, "Section header must stay 16 bytes");
+
+// Payload size rounded up to the 8-byte section alignment
+static size_t padded(size_t bytes) {
+    return (bytes + 7) & ~static_cast<size_t>(7);
+}
+
+SnapshotWriter::SnapshotWriter() {
+    file = nullptr;
+    failed = false;
+}
+
+SnapshotWriter::~SnapshotWriter() {
+    close();
+}
+
+void SnapshotWriter::writeBytes(const void* data, size_t bytes) {
+    if (file == nullptr || failed || bytes == 0) {
+        return;
+    }
+    if (std::fwrite(data, 1, bytes, file) != bytes) {
+        failed = true;
+    }
+}
+
+bool SnapshotWriter::open(const char* path) {
+    close();
+    file = std::fopen(path, "wb");
+    if (file == nullptr) {
+        return false;
+    }
+    failed = false;
+    SnapshotFileHeader header;
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+    header.version = VERSION;
+    header.byteOrder = SNAPSHOT_BYTE_ORDER;
+    header.reserved = 0;
+    writeBytes(&header, sizeof(header));
+    return !failed;
+}
+
+void SnapshotWriter::beginSection(int tag, size_t payloadBytes) {
+    SnapshotSectionHeader header;
+    header.tag = tag;
+    header.reserved = 0;
+    header.bytes = static_cast<long long>(payloadBytes);
+    writeBytes(&header, sizeof(header));
+}
+
+void SnapshotWriter::write(const void* data, size_t bytes) {
+    writeBytes(data, bytes);
+}
+
+void SnapshotWriter::endSection(size_t payloadBytes) {
+    static const char zeros[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    writeBytes(zeros, padded(payloadBytes) - payloadBytes);
+}
+
+bool SnapshotWriter::close() {
+    if (file == nullptr) {
+        return !failed;
+    }
+    if (std::fflush(file) != 0) {
+        failed = true;
+    }
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    return !failed;
+}
+
+SnapshotReader::SnapshotReader() {
+    data = nullptr;
+    size = 0;
+    offset = 0;
+    mapped = false;
+}
+
+SnapshotReader::~SnapshotReader() {
+    close();
+}
+
+bool SnapshotReader::open(const char* path) {
+    close();
+
+#if defined(SNAPSHOT_HAS_MMAP)
+    int fd = ::open(path, O_RDONLY);
+    if (fd == -1) {
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || static_cast<size_t>(info.st_size) < sizeof(SnapshotFileHeader)) {
+        ::close(fd);
+        return false;
+    }
+    size_t fileSize = static_cast<size_t>(info.st_size);
+    void* base = mmap(nullptr, fileSize, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);  // The mapping keeps the file open
+    if (base == MAP_FAILED) {
+        return false;
+    }
+    madvise(base, fileSize, MADV_SEQUENTIAL);
+    data = static_cast<const char*>(base);
+    size = fileSize;
+    mapped = true;
+#else
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    std::fseek(file, 0, SEEK_END);
+    long fileSize = std::ftell(file);
+    std::fseek(file, 0, SEEK_SET);
+    if (fileSize < static_cast<long>(sizeof(SnapshotFileHeader))) {
+        std::fclose(file);
+        return false;
+    }
+    // malloc keeps the buffer 8-byte aligned like a mapping
+    char* buffer = static_cast<char*>(std::malloc(fileSize));
+    if (buffer == nullptr || std::fread(buffer, 1, fileSize, file) != static_cast<size_t>(fileSize)) {
+        std::free(buffer);
+        std::fclose(file);
+        return false;
+    }
+    std::fclose(file);
+    data = buffer;
+    size = static_cast<size_t>(fileSize);
+    mapped = false;
+#endif
+
+    SnapshotFileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SnapshotWriter::VERSION ||
+        header.byteOrder != SNAPSHOT_BYTE_ORDER) {
+        close();
+        return false;
+    }
+    offset = sizeof(SnapshotFileHeader);
+    return true;
+}
+
+const char* SnapshotReader::section(int tag, size_t* payloadBytes) {
+    if (data == nullptr || size - offset < sizeof(SnapshotSectionHeader)) {
+        return nullptr;
+    }
+    SnapshotSectionHeader header;
+    std::memcpy(&header, data + offset, sizeof(header));
+    if (header.tag != tag || header.bytes < 0 ||
+        static_cast<unsigned long long>(header.bytes) > size - offset - sizeof(header)) {
+        return nullptr;
+    }
+    const char* payload = data + offset + sizeof(header);
+    size_t bytes = static_cast<size_t>(header.bytes);
+    offset += sizeof(header) + padded(bytes);
+    if (offset > size) {
+        offset = size;  // Last section without padding
+    }
+    *payloadBytes = bytes;
+    return payload;
+}
+
+void SnapshotReader::close() {
+    if (data != nullptr) {
+#if defined(SNAPSHOT_HAS_MMAP)
+        if (mapped) {
+            munmap(const_cast<char*>(data), size);
+        }
+#endif
+        if (!mapped) {
+            std::free(const_cast<char*>(data));
+        }
+    }
+    data = nullptr;
+    size = 0;
+    offset = 0;
+    mapped = false;
+}
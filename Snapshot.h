@@ -0,0 +1,102 @@
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <cstddef>
+#include <cstdio>
+
+// Binary snapshot file mechanics used by ParkingSystem::saveSnapshot and
+// ParkingSystem::loadSnapshot.
+//
+// File layout: a 16-byte header ("PKSN", format version, endianness marker)
+// followed by tagged sections. Each section is a 16-byte section header
+// (tag, payload bytes) and the payload, padded to 8 bytes so that arrays
+// in a mapped file are aligned and can be read in place.
+
+// Section tags, in the order ParkingSystem writes them
+enum SnapshotSection {
+    SNAPSHOT_SYSTEM = 1,       // Counts and configuration
+    SNAPSHOT_SLOTS = 2,        // SlotStore columns
+    SNAPSHOT_FREE_RANGES = 3,  // SlotStore ranges released for reuse
+    SNAPSHOT_ZONES = 4,        // Zone records, slot ranges and adjacency
+    SNAPSHOT_AREAS = 5,        // Area records
+    SNAPSHOT_BUCKETS = 6,      // ZoneIndex bucket order
+    SNAPSHOT_VEHICLES = 7,     // Vehicle records
+    SNAPSHOT_REQUESTS = 8,     // Request records
+    SNAPSHOT_ROLLBACK = 9,     // Rollback history and redo stack
+    SNAPSHOT_POLICY = 10,      // Allocation policy name and state
+    SNAPSHOT_END = 11          // End marker (empty)
+};
+
+// Writes a snapshot sequentially through stdio
+class SnapshotWriter {
+private:
+    FILE* file;    // Open snapshot file (nullptr if closed)
+    bool failed;   // True once any write failed
+
+    // Write raw bytes, remembering failures
+    void writeBytes(const void* data, size_t bytes);
+
+public:
+    static const int VERSION = 6;  // Current snapshot format version
+
+    // Constructor: No file open
+    SnapshotWriter();
+
+    // Destructor: Closes the file
+    ~SnapshotWriter();
+
+    // A writer owns its file, so it is not copyable
+    SnapshotWriter(const SnapshotWriter& other) = delete;
+    SnapshotWriter& operator=(const SnapshotWriter& other) = delete;
+
+    // Create (or truncate) a snapshot file and write the file header
+    bool open(const char* path);
+
+    // Start a section whose payload is the given number of bytes; the payload
+    // follows with write() calls and is padded by endSection()
+    void beginSection(int tag, size_t payloadBytes);
+
+    // Write part of the current section's payload
+    void write(const void* data, size_t bytes);
+
+    // Pad the section payload to 8 bytes
+    void endSection(size_t payloadBytes);
+
+    // Flush and close; returns false if any write failed
+    bool close();
+};
+
+// Reads a snapshot by memory-mapping it (or, without mmap, by reading the
+// whole file into one buffer) and hands out section payloads in place
+class SnapshotReader {
+private:
+    const char* data;  // File contents (mapped or buffered)
+    size_t size;       // Bytes in data
+    size_t offset;     // Read position
+    bool mapped;       // True if data is a mapping
+
+public:
+    // Constructor: No file open
+    SnapshotReader();
+
+    // Destructor: Unmaps or frees the file contents
+    ~SnapshotReader();
+
+    // A reader owns its mapping, so it is not copyable
+    SnapshotReader(const SnapshotReader& other) = delete;
+    SnapshotReader& operator=(const SnapshotReader& other) = delete;
+
+    // Open a snapshot and check its header. Returns false if the file is
+    // missing, not a snapshot, of another version or of another byte order
+    bool open(const char* path);
+
+    // Enter the next section, which must carry the given tag. Returns its
+    // payload (8-byte aligned) and size, or nullptr if the tag differs or
+    // the section runs past the end of the file
+    const char* section(int tag, size_t* payloadBytes);
+
+    // Release the file contents
+    void close();
+};
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,368 @@
+#include "SpatialGrid.h"
+#include <climits>
+#include <cmath>
+
+SpatialGrid::SpatialGrid() {
+    built = false;
+    arena = nullptr;
+    numSlots = 0;
+    minX = 0;
+    minY = 0;
+    cellSize = 1;
+    cols = 0;
+    rows = 0;
+    numLevels = 0;
+    numCells = 0;
+    levelValues = nullptr;
+    cellStart = nullptr;
+    entryOffset = nullptr;
+    entryX = nullptr;
+    entryY = nullptr;
+    cellOf = nullptr;
+    entryOf = nullptr;
+    cellFree = nullptr;
+    levelFree = nullptr;
+    totalFree = 0;
+}
+
+SpatialGrid::~SpatialGrid() {
+    clear();
+}
+
+int* SpatialGrid::allocate(int count) {
+    if (count < 1) {
+        count = 1;
+    }
+    return (arena != nullptr) ? arena->allocateArray<int>(count) : new int[count];
+}
+
+void SpatialGrid::clear() {
+    if (arena == nullptr) {
+        delete[] levelValues;
+        delete[] cellStart;
+        delete[] entryOffset;
+        delete[] entryX;
+        delete[] entryY;
+        delete[] cellOf;
+        delete[] entryOf;
+        delete[] cellFree;
+        delete[] levelFree;
+    } else {
+        arena->releaseArray(levelValues, numLevels);
+        arena->releaseArray(cellStart, numCells + 1);
+        arena->releaseArray(entryOffset, numSlots);
+        arena->releaseArray(entryX, numSlots);
+        arena->releaseArray(entryY, numSlots);
+        arena->releaseArray(cellOf, numSlots);
+        arena->releaseArray(entryOf, numSlots);
+        arena->releaseArray(cellFree, numCells);
+        arena->releaseArray(levelFree, numLevels);
+    }
+    levelValues = nullptr;
+    cellStart = nullptr;
+    entryOffset = nullptr;
+    entryX = nullptr;
+    entryY = nullptr;
+    cellOf = nullptr;
+    entryOf = nullptr;
+    cellFree = nullptr;
+    levelFree = nullptr;
+    numSlots = 0;
+    numLevels = 0;
+    numCells = 0;
+    totalFree = 0;
+    built = false;
+}
+
+void SpatialGrid::build(const SlotStore* store, int first, int count, Arena* gridArena) {
+    clear();
+    arena = gridArena;
+    numSlots = (count > 0) ? count : 0;
+
+    // Step 1: Bounding box and distinct levels (slots of one level are
+    // usually adjacent, so the distinct list is rarely searched)
+    int maxX = 0;
+    int maxY = 0;
+    int* levels = new int[numSlots > 0 ? numSlots : 1];
+    numLevels = 0;
+    for (int i = 0; i < numSlots; i++) {
+        const SlotCoordinates& c = store->getCoordinates(first + i);
+        minX = (i == 0 || c.x < minX) ? c.x : minX;
+        maxX = (i == 0 || c.x > maxX) ? c.x : maxX;
+        minY = (i == 0 || c.y < minY) ? c.y : minY;
+        maxY = (i == 0 || c.y > maxY) ? c.y : maxY;
+        bool seen = numLevels > 0 && levels[numLevels - 1] == c.level;
+        for (int l = 0; l < numLevels && !seen; l++) {
+            seen = levels[l] == c.level;
+        }
+        if (!seen) {
+            levels[numLevels++] = c.level;
+        }
+    }
+    for (int i = 1; i < numLevels; i++) {
+        int value = levels[i];
+        int j = i - 1;
+        while (j >= 0 && levels[j] > value) {
+            levels[j + 1] = levels[j];
+            j--;
+        }
+        levels[j + 1] = value;
+    }
+    levelValues = allocate(numLevels);
+    for (int l = 0; l < numLevels; l++) {
+        levelValues[l] = levels[l];
+    }
+    delete[] levels;
+
+    // Step 2: Size the cells for about TARGET_PER_CELL slots each, and never
+    // more than about four cells per slot
+    long long width = static_cast<long long>(maxX) - minX + 1;
+    long long height = static_cast<long long>(maxY) - minY + 1;
+    long long perLevel = (numLevels > 0) ? (numSlots + numLevels - 1) / numLevels : 1;
+    double side = std::sqrt(static_cast<double>(width) * static_cast<double>(height) * TARGET_PER_CELL / perLevel);
+    long long size = static_cast<long long>(std::ceil(side));
+    size = (size < 1) ? 1 : (size > INT_MAX / 2 ? INT_MAX / 2 : size);
+    long long layerCells = ((width - 1) / size + 1) * ((height - 1) / size + 1);
+    while (layerCells * (numLevels > 0 ? numLevels : 1) > 4LL * numSlots + 16 && size < INT_MAX / 2) {
+        size *= 2;
+        layerCells = ((width - 1) / size + 1) * ((height - 1) / size + 1);
+    }
+    cellSize = static_cast<int>(size);
+    cols = static_cast<int>((width - 1) / size + 1);
+    rows = static_cast<int>((height - 1) / size + 1);
+    numCells = cols * rows * numLevels;
+
+    // Step 3: Counting sort of slot offsets by cell, free slots first
+    cellOf = allocate(numSlots);
+    entryOf = allocate(numSlots);
+    cellStart = allocate(numCells + 1);
+    cellFree = allocate(numCells);
+    levelFree = allocate(numLevels);
+    for (int c = 0; c <= numCells; c++) {
+        cellStart[c] = 0;
+    }
+    for (int c = 0; c < numCells; c++) {
+        cellFree[c] = 0;
+    }
+    for (int l = 0; l < numLevels; l++) {
+        levelFree[l] = 0;
+    }
+    for (int i = 0; i < numSlots; i++) {
+        const SlotCoordinates& c = store->getCoordinates(first + i);
+        int low = 0;
+        int high = numLevels - 1;
+        while (low < high) {
+            int mid = (low + high) / 2;
+            if (levelValues[mid] < c.level) {
+                low = mid + 1;
+            } else {
+                high = mid;
+            }
+        }
+        int gx = static_cast<int>((static_cast<long long>(c.x) - minX) / cellSize);
+        int gy = static_cast<int>((static_cast<long long>(c.y) - minY) / cellSize);
+        cellOf[i] = (low * rows + gy) * cols + gx;
+        cellStart[cellOf[i] + 1]++;
+        if (store->isFree(first + i)) {
+            cellFree[cellOf[i]]++;
+            levelFree[low]++;
+            totalFree++;
+        }
+    }
+    for (int c = 0; c < numCells; c++) {
+        cellStart[c + 1] += cellStart[c];
+    }
+    entryOffset = allocate(numSlots);
+    entryX = allocate(numSlots);
+    entryY = allocate(numSlots);
+    // Two cursors per cell: free slots fill the front, occupied the back
+    int* freeCursor = new int[numCells > 0 ? numCells : 1];
+    int* busyCursor = new int[numCells > 0 ? numCells : 1];
+    for (int c = 0; c < numCells; c++) {
+        freeCursor[c] = cellStart[c];
+        busyCursor[c] = cellStart[c] + cellFree[c];
+    }
+    for (int i = 0; i < numSlots; i++) {
+        int e = store->isFree(first + i) ? freeCursor[cellOf[i]]++ : busyCursor[cellOf[i]]++;
+        const SlotCoordinates& c = store->getCoordinates(first + i);
+        entryOffset[e] = i;
+        entryX[e] = c.x;
+        entryY[e] = c.y;
+        entryOf[i] = e;
+    }
+    delete[] freeCursor;
+    delete[] busyCursor;
+    built = true;
+}
+
+bool SpatialGrid::isBuilt() const {
+    return built;
+}
+
+void SpatialGrid::swapEntries(int a, int b) {
+    if (a == b) {
+        return;
+    }
+    int offset = entryOffset[a];
+    int x = entryX[a];
+    int y = entryY[a];
+    entryOffset[a] = entryOffset[b];
+    entryX[a] = entryX[b];
+    entryY[a] = entryY[b];
+    entryOffset[b] = offset;
+    entryX[b] = x;
+    entryY[b] = y;
+    entryOf[entryOffset[a]] = a;
+    entryOf[entryOffset[b]] = b;
+}
+
+void SpatialGrid::onOccupied(int offset) {
+    // Swap the slot with the last free entry of its cell, then shrink the
+    // free part over it
+    int cell = cellOf[offset];
+    swapEntries(entryOf[offset], cellStart[cell] + cellFree[cell] - 1);
+    cellFree[cell]--;
+    levelFree[cell / (cols * rows)]--;
+    totalFree--;
+}
+
+void SpatialGrid::onFreed(int offset) {
+    // Swap the slot with the first occupied entry, then grow the free part
+    int cell = cellOf[offset];
+    swapEntries(entryOf[offset], cellStart[cell] + cellFree[cell]);
+    cellFree[cell]++;
+    levelFree[cell / (cols * rows)]++;
+    totalFree++;
+}
+
+void SpatialGrid::scanCell(int cell, int x, int y, const unsigned char* types, int slotType, long long& best,
+                           int& bestOffset) const {
+    int end = cellStart[cell] + cellFree[cell];
+    if (end == cellStart[cell]) {
+        return;
+    }
+    if (best != LLONG_MAX) {
+        // Skip the cell if its whole rectangle is farther than the best slot
+        int layerCell = cell % (cols * rows);
+        long long left = static_cast<long long>(minX) + static_cast<long long>(layerCell % cols) * cellSize;
+        long long top = static_cast<long long>(minY) + static_cast<long long>(layerCell / cols) * cellSize;
+        long long dx = (x < left) ? left - x : (x > left + cellSize - 1 ? x - (left + cellSize - 1) : 0);
+        long long dy = (y < top) ? top - y : (y > top + cellSize - 1 ? y - (top + cellSize - 1) : 0);
+        if (dx * dx + dy * dy > best) {
+            return;
+        }
+    }
+    for (int e = cellStart[cell]; e < end; e++) {
+        int offset = entryOffset[e];
+        if (types != nullptr && types[offset] != slotType) {
+            continue;
+        }
+        long long dx = static_cast<long long>(entryX[e]) - x;
+        long long dy = static_cast<long long>(entryY[e]) - y;
+        long long distance = dx * dx + dy * dy;
+        if (distance < best || (distance == best && offset < bestOffset)) {
+            best = distance;
+            bestOffset = offset;
+        }
+    }
+}
+
+void SpatialGrid::searchLevel(int levelIndex, int x, int y, const unsigned char* types, int slotType,
+                              long long& best, int& bestOffset) const {
+    if (levelFree[levelIndex] == 0) {
+        return;
+    }
+    // Cell of the reference point, clamped into the grid
+    long long gx = (static_cast<long long>(x) - minX) / cellSize;
+    long long gy = (static_cast<long long>(y) - minY) / cellSize;
+    int cx = static_cast<int>(gx < 0 ? 0 : (gx >= cols ? cols - 1 : gx));
+    int cy = static_cast<int>(gy < 0 ? 0 : (gy >= rows ? rows - 1 : gy));
+    int base = levelIndex * rows * cols;
+    int maxRing = cx;
+    maxRing = (cols - 1 - cx > maxRing) ? cols - 1 - cx : maxRing;
+    maxRing = (cy > maxRing) ? cy : maxRing;
+    maxRing = (rows - 1 - cy > maxRing) ? rows - 1 - cy : maxRing;
+
+    for (int r = 0; r <= maxRing; r++) {
+        // Every cell of ring r is at least (r - 1) cells from the point
+        if (best != LLONG_MAX && r > 0) {
+            long long gap = static_cast<long long>(r - 1) * cellSize;
+            if (gap * gap > best) {
+                break;
+            }
+        }
+        if (r == 0) {
+            scanCell(base + cy * cols + cx, x, y, types, slotType, best, bestOffset);
+            continue;
+        }
+        int xLow = (cx - r > 0) ? cx - r : 0;
+        int xHigh = (cx + r < cols - 1) ? cx + r : cols - 1;
+        if (cy - r >= 0) {
+            for (int i = xLow; i <= xHigh; i++) {
+                scanCell(base + (cy - r) * cols + i, x, y, types, slotType, best, bestOffset);
+            }
+        }
+        if (cy + r < rows) {
+            for (int i = xLow; i <= xHigh; i++) {
+                scanCell(base + (cy + r) * cols + i, x, y, types, slotType, best, bestOffset);
+            }
+        }
+        int yLow = (cy - r + 1 > 0) ? cy - r + 1 : 0;
+        int yHigh = (cy + r - 1 < rows - 1) ? cy + r - 1 : rows - 1;
+        if (cx - r >= 0) {
+            for (int j = yLow; j <= yHigh; j++) {
+                scanCell(base + j * cols + cx - r, x, y, types, slotType, best, bestOffset);
+            }
+        }
+        if (cx + r < cols) {
+            for (int j = yLow; j <= yHigh; j++) {
+                scanCell(base + j * cols + cx + r, x, y, types, slotType, best, bestOffset);
+            }
+        }
+    }
+}
+
+int SpatialGrid::findNearest(int x, int y, int level) const {
+    long long levelGap = LLONG_MAX;
+    long long planarDistance = LLONG_MAX;
+    return findNearestOfType(x, y, level, nullptr, 0, &levelGap, &planarDistance);
+}
+
+int SpatialGrid::findNearestOfType(int x, int y, int level, const unsigned char* types, int slotType,
+                                   long long* levelGap, long long* planarDistance) const {
+    if (!built || totalFree == 0) {
+        return -1;
+    }
+    // Walk the levels outward from the reference level: below is the
+    // nearest level under it, above the nearest at or over it
+    int above = 0;
+    while (above < numLevels && levelValues[above] < level) {
+        above++;
+    }
+    int below = above - 1;
+    while (below >= 0 || above < numLevels) {
+        long long downGap = (below >= 0) ? static_cast<long long>(level) - levelValues[below] : LLONG_MAX;
+        long long upGap = (above < numLevels) ? static_cast<long long>(levelValues[above]) - level : LLONG_MAX;
+        long long gap = (downGap < upGap) ? downGap : upGap;
+        if (gap > *levelGap) {
+            return -1;  // Every remaining level is farther than the bound
+        }
+        // On the bound's level only a strictly nearer slot counts
+        long long best = (gap == *levelGap) ? *planarDistance : LLONG_MAX;
+        int bestOffset = -1;
+        if (downGap == gap) {
+            searchLevel(below, x, y, types, slotType, best, bestOffset);
+            below--;
+        }
+        if (upGap == gap) {
+            searchLevel(above, x, y, types, slotType, best, bestOffset);
+            above++;
+        }
+        if (bestOffset != -1) {
+            *levelGap = gap;
+            *planarDistance = best;
+            return bestOffset;
+        }
+    }
+    return -1;
+}
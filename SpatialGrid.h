@@ -0,0 +1,106 @@
+#ifndef SPATIAL_GRID_H
+#define SPATIAL_GRID_H
+
+#include "Arena.h"
+#include "SlotStore.h"
+
+// Uniform-grid spatial index over one area's slots, for nearest-free-slot
+// queries from a reference point (an entrance, a lift).
+//
+// Each level present in the area gets its own layer of square cells over
+// the area's (x, y) bounding box, sized for about 8 slots per cell. Slots
+// are grouped by cell (counting sort) with a copy of their x and y, and
+// each cell keeps its free slots at the front of its entries: the area
+// reports every occupy/free, and the slot is swapped across the boundary
+// and the cell's free count adjusted, O(1). A query searches the nearest
+// level first, then rings of cells outward from the reference point's
+// cell, reading only the free entries of each cell (no bitmap access) and
+// skipping cells whose rectangle is already farther than the best slot
+// found; it stops once the next ring is. At high occupancy most cells have
+// no free entry, so a query reads a few dozen counters and a handful of
+// slots.
+//
+// Distance: the fewest levels away wins; among slots on equally distant
+// levels the smallest planar (x, y) Euclidean distance wins, then the lowest
+// position. Arrays come from the area's arena when it has one.
+
+class SpatialGrid {
+private:
+    static const int TARGET_PER_CELL = 8;  // Average slots per non-empty cell the sizing aims for
+
+    bool built;           // True once build() ran (and nothing invalidated it)
+    Arena* arena;         // Arena the arrays come from (nullptr = heap)
+    int numSlots;         // Slots indexed (offsets 0..numSlots-1 from the range start)
+    int minX;             // Bounding box origin
+    int minY;
+    int cellSize;         // Side of a square cell, in coordinate units
+    int cols;             // Cells per row
+    int rows;             // Rows per level layer
+    int numLevels;        // Distinct levels
+    int numCells;         // cols * rows * numLevels
+    int* levelValues;     // Distinct levels, ascending
+    int* cellStart;       // First entry of each cell (numCells + 1)
+    int* entryOffset;     // Slot offset of each entry, grouped by cell
+    int* entryX;          // x of each entry
+    int* entryY;          // y of each entry
+    int* cellOf;          // Cell of each slot offset
+    int* entryOf;         // Entry of each slot offset
+    int* cellFree;        // Free slots per cell (its first entries)
+    int* levelFree;       // Free slots per level layer
+    int totalFree;        // Free slots in the area
+
+    // Allocate an int array from the arena or the heap
+    int* allocate(int count);
+
+    // Swap two entries (and their slots' entry numbers)
+    void swapEntries(int a, int b);
+
+    // Search one level layer, improving best / bestOffset (only slots whose
+    // types[offset] is slotType count when types is given)
+    void searchLevel(int levelIndex, int x, int y, const unsigned char* types, int slotType, long long& best,
+                     int& bestOffset) const;
+
+    // Check the free slots of one cell, improving best / bestOffset
+    void scanCell(int cell, int x, int y, const unsigned char* types, int slotType, long long& best,
+                  int& bestOffset) const;
+
+public:
+    // Constructor: Not built
+    SpatialGrid();
+
+    // Destructor: Frees heap arrays
+    ~SpatialGrid();
+
+    // An index belongs to one area's range, so it is not copyable
+    SpatialGrid(const SpatialGrid& other) = delete;
+    SpatialGrid& operator=(const SpatialGrid& other) = delete;
+
+    // Index the count slots at positions [first, first + count) of a store,
+    // taking arrays from gridArena (nullptr = heap). O(count + levels^2)
+    void build(const SlotStore* store, int first, int count, Arena* gridArena);
+
+    // Drop the index (heap arrays are freed; arena arrays stay in the arena)
+    void clear();
+
+    // Check if the index is built
+    bool isBuilt() const;
+
+    // Keep the free entries and counters in step when the slot at an offset
+    // is occupied or freed (it must actually change state), O(1)
+    void onOccupied(int offset);
+    void onFreed(int offset);
+
+    // Offset of the free slot nearest to (x, y, level), -1 if none
+    int findNearest(int x, int y, int level) const;
+
+    // Same search among the free slots whose type (types[offset], the
+    // area's part of the store's type column) is slotType, bounded by
+    // *levelGap / *planarDistance (LLONG_MAX: no bound): only a slot strictly
+    // nearer than the bound is returned, and its level gap and squared
+    // planar distance are stored there. Lets a caller find the nearest slot
+    // of several areas, pruning each area by the best found so far
+    int findNearestOfType(int x, int y, int level, const unsigned char* types, int slotType, long long* levelGap,
+                          long long* planarDistance) const;
+};
+
+#endif // SPATIAL_GRID_H
@@ -0,0 +1,197 @@
+#include "TimerWheel.h"
+
+TimerWheel::TimerWheel() {
+    for (int i = 0; i <= DUE; i++) {
+        heads[i] = -1;
+    }
+    for (int l = 0; l < LEVELS; l++) {
+        levelCounts[l] = 0;
+    }
+    next = nullptr;
+    prev = nullptr;
+    deadlines = nullptr;
+    lists = nullptr;
+    capacity = 0;
+    current = 0;
+    count = 0;
+}
+
+TimerWheel::~TimerWheel() {
+    delete[] next;
+    delete[] prev;
+    delete[] deadlines;
+    delete[] lists;
+}
+
+void TimerWheel::grow(int id) {
+    int newCapacity = (capacity > 0) ? capacity : 64;
+    while (newCapacity <= id) {
+        newCapacity *= 2;
+    }
+    int* newNext = new int[newCapacity];
+    int* newPrev = new int[newCapacity];
+    int* newDeadlines = new int[newCapacity];
+    int* newLists = new int[newCapacity];
+    for (int i = 0; i < capacity; i++) {
+        newNext[i] = next[i];
+        newPrev[i] = prev[i];
+        newDeadlines[i] = deadlines[i];
+        newLists[i] = lists[i];
+    }
+    for (int i = capacity; i < newCapacity; i++) {
+        newLists[i] = -1;
+    }
+    delete[] next;
+    delete[] prev;
+    delete[] deadlines;
+    delete[] lists;
+    next = newNext;
+    prev = newPrev;
+    deadlines = newDeadlines;
+    lists = newLists;
+    capacity = newCapacity;
+}
+
+void TimerWheel::place(int id) {
+    long long deadline = deadlines[id];
+    long long delta = deadline - current;
+    int list = DUE;
+    if (delta > 0) {
+        // Lowest level whose span covers the delay; the slot comes from the
+        // deadline's own bits, so it is reached exactly when due
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (1LL << (SLOT_BITS * (level + 1)))) {
+            level++;
+        }
+        int slot = static_cast<int>((static_cast<unsigned long long>(deadline) >> (SLOT_BITS * level)) & (SLOTS - 1));
+        list = level * SLOTS + slot;
+        levelCounts[level]++;
+    }
+    lists[id] = list;
+    prev[id] = -1;
+    next[id] = heads[list];
+    if (heads[list] != -1) {
+        prev[heads[list]] = id;
+    }
+    heads[list] = id;
+}
+
+void TimerWheel::unlink(int id) {
+    int list = lists[id];
+    if (prev[id] != -1) {
+        next[prev[id]] = next[id];
+    } else {
+        heads[list] = next[id];
+    }
+    if (next[id] != -1) {
+        prev[next[id]] = prev[id];
+    }
+    if (list != DUE) {
+        levelCounts[list / SLOTS]--;
+    }
+    lists[id] = -1;
+}
+
+void TimerWheel::schedule(int id, int deadline) {
+    if (id < 0) {
+        return;
+    }
+    if (id >= capacity) {
+        grow(id);
+    }
+    if (lists[id] != -1) {
+        unlink(id);
+        count--;
+    }
+    deadlines[id] = deadline;
+    place(id);
+    count++;
+}
+
+void TimerWheel::cancel(int id) {
+    if (id >= 0 && id < capacity && lists[id] != -1) {
+        unlink(id);
+        count--;
+    }
+}
+
+bool TimerWheel::isScheduled(int id) const {
+    return id >= 0 && id < capacity && lists[id] != -1;
+}
+
+int TimerWheel::getDeadline(int id) const {
+    return deadlines[id];
+}
+
+void TimerWheel::cascade(int level) {
+    int list = level * SLOTS + static_cast<int>((static_cast<unsigned long long>(current) >> (SLOT_BITS * level)) & (SLOTS - 1));
+    int id = heads[list];
+    heads[list] = -1;
+    while (id != -1) {
+        int following = next[id];
+        levelCounts[level]--;
+        place(id);  // Lands on a lower level (or the due list)
+        id = following;
+    }
+}
+
+int TimerWheel::expireNext(int now) {
+    while (heads[DUE] == -1) {
+        if (current >= now) {
+            return -1;
+        }
+        if (count == 0) {
+            current = now;  // Nothing scheduled: jump straight there
+            return -1;
+        }
+
+        // Skip ahead to the last tick before the next event: every tick
+        // while level 0 has timers, else the next boundary of the lowest
+        // non-empty level (where its slot cascades)
+        int lowest = 0;
+        while (lowest < LEVELS && levelCounts[lowest] == 0) {
+            lowest++;
+        }
+        if (lowest > 0) {
+            long long span = 1LL << (SLOT_BITS * (lowest < LEVELS ? lowest : LEVELS - 1));
+            long long boundary = (current / span + 1) * span;
+            if (boundary - 1 > current) {
+                current = (boundary - 1 < now) ? boundary - 1 : now;
+                continue;
+            }
+        }
+
+        // Process the next tick: cascade the levels whose slot starts here
+        // (highest first), then the tick's level-0 slot is due
+        current++;
+        for (int l = LEVELS - 1; l >= 1; l--) {
+            if ((current & ((1LL << (SLOT_BITS * l)) - 1)) == 0) {
+                cascade(l);
+            }
+        }
+        int list = static_cast<int>(current & (SLOTS - 1));
+        int id = heads[list];
+        heads[list] = -1;
+        while (id != -1) {
+            int following = next[id];
+            levelCounts[0]--;
+            lists[id] = DUE;
+            prev[id] = -1;
+            next[id] = heads[DUE];
+            if (heads[DUE] != -1) {
+                prev[heads[DUE]] = id;
+            }
+            heads[DUE] = id;
+            id = following;
+        }
+    }
+
+    int id = heads[DUE];
+    unlink(id);
+    count--;
+    return id;
+}
+
+int TimerWheel::size() const {
+    return count;
+}
@@ -0,0 +1,85 @@
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+// Hierarchical timing wheel over integer times, with at most one timer per
+// ID (request index). ParkingSystem uses one wheel to expire ALLOCATED
+// requests whose car never arrived and one to flag OCCUPIED requests that
+// stay too long.
+//
+// Four levels of 256 slots: level 0 holds timers due within 256 ticks (one
+// slot per tick), level 1 within 65536 ticks (one slot per 256 ticks), and
+// so on, covering the whole int range. When the clock reaches the start of
+// a higher-level slot, that slot's timers cascade down a level; every timer
+// cascades at most three times, so schedule, cancel and expiry are O(1)
+// amortized. Ticks with no timer on the lower levels are skipped, so
+// advancing over a long idle stretch does not visit every tick.
+//
+// Timers live in intrusive doubly linked lists threaded through arrays
+// indexed by ID, so scheduling never allocates (except to grow the arrays
+// when a larger ID shows up).
+
+class TimerWheel {
+private:
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 8;
+    static const int SLOTS = 1 << SLOT_BITS;    // Slots per level
+    static const int DUE = LEVELS * SLOTS;      // List of timers whose deadline has passed
+
+    int heads[LEVELS * SLOTS + 1];  // First ID in each slot list (-1 if empty), plus the due list
+    int levelCounts[LEVELS];        // Timers on each level
+
+    int* next;                      // Next ID in the same list (-1 at the end)
+    int* prev;                      // Previous ID in the same list (-1 at the head)
+    int* deadlines;                 // Deadline of each scheduled ID
+    int* lists;                     // List each ID is in (-1 if not scheduled)
+    int capacity;                   // Size of the per-ID arrays
+
+    long long current;              // Last tick processed: no timer is due at or before it
+    int count;                      // Timers scheduled (including due ones)
+
+    // Grow the per-ID arrays to cover id
+    void grow(int id);
+
+    // Put a scheduled ID into the list that fits its deadline
+    void place(int id);
+
+    // Remove an ID from its list
+    void unlink(int id);
+
+    // Move the timers of one higher-level slot down, relative to current
+    void cascade(int level);
+
+public:
+    // Constructor: Creates an empty wheel whose clock starts at time 0
+    TimerWheel();
+
+    // Destructor
+    ~TimerWheel();
+
+    // The wheel owns its arrays, so it is not copyable
+    TimerWheel(const TimerWheel& other) = delete;
+    TimerWheel& operator=(const TimerWheel& other) = delete;
+
+    // Schedule (or reschedule) the timer of an ID. A deadline at or before
+    // the clock makes the timer due on the next expire call. O(1)
+    void schedule(int id, int deadline);
+
+    // Cancel the timer of an ID (no-op if none), O(1)
+    void cancel(int id);
+
+    // Check if an ID has a timer
+    bool isScheduled(int id) const;
+
+    // Deadline of a scheduled ID
+    int getDeadline(int id) const;
+
+    // Advance the clock towards now and remove one timer whose deadline is
+    // at or before now. Returns its ID, or -1 once no timer is due (the
+    // clock then stands at now). Call repeatedly to expire everything due
+    int expireNext(int now);
+
+    // Getter for number of scheduled timers
+    int size() const;
+};
+
+#endif // TIMER_WHEEL_H
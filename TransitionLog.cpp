@@ -0,0 +1,55 @@
+#include "TransitionLog.h"
+#include "ParkingRequest.h"
+
+TransitionLog::TransitionLog(int capacity) {
+    this->capacity = (capacity > 0) ? capacity : 1;
+    entries = new TransitionLogEntry[this->capacity];
+    first = 0;
+    count = 0;
+    dropped = 0;
+}
+
+TransitionLog::~TransitionLog() {
+    delete[] entries;
+}
+
+void TransitionLog::record(int requestID, int transition, int fromState) {
+    int position;
+    if (count < capacity) {
+        position = (first + count) % capacity;
+        count++;
+    } else {
+        // Full: overwrite the oldest entry
+        position = first;
+        first = (first + 1) % capacity;
+        dropped++;
+    }
+    entries[position].requestID = requestID;
+    entries[position].transition = transition;
+    entries[position].fromState = fromState;
+}
+
+int TransitionLog::flush(std::ostream& out) {
+    if (dropped > 0) {
+        out << "Error: " << dropped << " earlier transition errors dropped\n";
+    }
+    for (int i = 0; i < count; i++) {
+        const TransitionLogEntry& entry = entries[(first + i) % capacity];
+        out << "Error: Cannot " << ParkingRequest::transitionName(entry.transition) << " request "
+            << entry.requestID << " from " << ParkingRequest::stateName(entry.fromState) << " state\n";
+    }
+    out.flush();
+    int written = count;
+    first = 0;
+    count = 0;
+    dropped = 0;
+    return written;
+}
+
+int TransitionLog::size() const {
+    return count;
+}
+
+long long TransitionLog::getDropped() const {
+    return dropped;
+}
@@ -0,0 +1,55 @@
+#ifndef TRANSITION_LOG_H
+#define TRANSITION_LOG_H
+
+#include <ostream>
+
+// Opt-in, buffered log of rejected request transitions.
+//
+// Recording an error only copies three ints into a fixed ring buffer, so a
+// burst of bad events (replay of a damaged log, rollback storms) costs a
+// few nanoseconds each instead of a console write and flush. The text is
+// formatted only when the owner calls flush(). When the ring is full the
+// oldest entries are overwritten and counted as dropped; the per-transition
+// error counters in Analytics stay exact either way.
+
+// One rejected transition
+struct TransitionLogEntry {
+    int requestID;   // Request the transition was attempted on
+    int transition;  // ParkingRequest::Transition
+    int fromState;   // ParkingRequest::State at the time
+};
+
+class TransitionLog {
+private:
+    TransitionLogEntry* entries;  // Ring buffer
+    int capacity;                 // Size of the ring
+    int first;                    // Position of the oldest entry
+    int count;                    // Entries held
+    long long dropped;            // Entries overwritten since the last flush
+
+public:
+    // Constructor: Empty log holding up to capacity entries (at least 1)
+    TransitionLog(int capacity);
+
+    // Destructor
+    ~TransitionLog();
+
+    // The log owns its buffer, so it is not copyable
+    TransitionLog(const TransitionLog& other) = delete;
+    TransitionLog& operator=(const TransitionLog& other) = delete;
+
+    // Record a rejected transition, O(1), no I/O
+    void record(int requestID, int transition, int fromState);
+
+    // Write every held entry (oldest first), one line each, plus a line for
+    // dropped entries if any, then empty the log. Returns entries written
+    int flush(std::ostream& out);
+
+    // Getter for entries held
+    int size() const;
+
+    // Getter for entries overwritten since the last flush
+    long long getDropped() const;
+};
+
+#endif // TRANSITION_LOG_H
@@ -3,6 +3,7 @@
 Vehicle::Vehicle() {
     vehicleID = 0;
     preferredZone = 0;
+    vehicleClass = VEHICLE_STANDARD;
 }
 
 Vehicle::~Vehicle() {
@@ -23,4 +24,12 @@ int Vehicle::getPreferredZone() const {
 
 void Vehicle::setPreferredZone(int zone) {
     preferredZone = zone;
+}
+
+int Vehicle::getVehicleClass() const {
+    return vehicleClass;
+}
+
+void Vehicle::setVehicleClass(int vehicleClassValue) {
+    vehicleClass = isValidVehicleClass(vehicleClassValue) ? vehicleClassValue : VEHICLE_STANDARD;
 }
\ No newline at end of file
@@ -1,10 +1,13 @@
 #ifndef VEHICLE_H
 #define VEHICLE_H
 
+#include "SlotType.h"
+
 class Vehicle {
 private:
     int vehicleID;
     int preferredZone;
+    int vehicleClass;  // VehicleClass (VEHICLE_STANDARD unless set)
 
 public:
     // Constructor
@@ -24,6 +27,12 @@ public:
 
     // Setter for preferredZone
     void setPreferredZone(int zone);
+
+    // Getter for vehicleClass
+    int getVehicleClass() const;
+
+    // Setter for vehicleClass (values outside VehicleClass become VEHICLE_STANDARD)
+    void setVehicleClass(int vehicleClassValue);
 };
 
 #endif // VEHICLE_H
\ No newline at end of file
@@ -1,93 +1,368 @@
 #include "Zone.h"
 #include <cstring>  // For strcpy
+#include <utility>  // For std::move
 
 Zone::Zone() {
-    zoneID = 0;
-    zoneName[0] = '\0';  // Initialize as empty string
-    capacity = 10;  // Default capacity
-    numSlots = 0;
-    parkingSlots = new ParkingSlot[capacity];
-    adjacencyCapacity = 10;  // Default adjacency capacity
-    numAdjacentZones = 0;
-    adjacentZones = new int[adjacencyCapacity];
+    init(new SlotStore(10), true, 10);  // Default capacity
 }
 
 Zone::Zone(int initialCapacity) {
+    init(new SlotStore(initialCapacity), true, initialCapacity);
+}
+
+Zone::Zone(SlotStore* target, int initialCapacity) {
+    init(target, false, initialCapacity);
+}
+
+void Zone::init(SlotStore* target, bool owns, int initialCapacity) {
     zoneID = 0;
     zoneName[0] = '\0';  // Initialize as empty string
     capacity = initialCapacity;
     numSlots = 0;
-    parkingSlots = new ParkingSlot[capacity];
+    store = target;
+    ownsStore = owns;
+    arena = owns ? nullptr : store->getArena();
+    rangeCapacity = 4;  // Default range capacity
+    rangeFirst = allocateInts(rangeCapacity);
+    rangeCount = allocateInts(rangeCapacity);
+    rangeFirst[0] = store->reserve(capacity);
+    rangeCount[0] = 0;
+    numRanges = 1;
+    slotIndex.moveToArena(arena);
     adjacencyCapacity = 10;  // Default adjacency capacity
     numAdjacentZones = 0;
-    adjacentZones = new int[adjacencyCapacity];
+    adjacentZones = allocateInts(adjacencyCapacity);
+    growthFactor = Arena::DEFAULT_GROWTH_FACTOR;
 }
 
-Zone::Zone(const Zone& other) {
-    zoneID = other.zoneID;
-    strcpy(zoneName, other.zoneName);
-    capacity = other.capacity;
-    numSlots = other.numSlots;
-    parkingSlots = new ParkingSlot[capacity];
-    for (int i = 0; i < numSlots; i++) {
-        parkingSlots[i] = other.parkingSlots[i];
+int* Zone::allocateInts(int count) {
+    if (arena != nullptr) {
+        return arena->allocateArray<int>(count);
     }
-    adjacencyCapacity = other.adjacencyCapacity;
+    return new int[count];
+}
+
+void Zone::releaseInts(int* array, int count) {
+    if (arena == nullptr) {
+        delete[] array;
+        return;
+    }
+    arena->releaseArray(array, count);
+}
+
+void Zone::copyAdjacency(const Zone& other) {
+    releaseInts(adjacentZones, adjacencyCapacity);
+    adjacencyCapacity = (other.adjacencyCapacity > 0) ? other.adjacencyCapacity : 10;
     numAdjacentZones = other.numAdjacentZones;
-    adjacentZones = new int[adjacencyCapacity];
+    adjacentZones = allocateInts(adjacencyCapacity);
     for (int i = 0; i < numAdjacentZones; i++) {
         adjacentZones[i] = other.adjacentZones[i];
     }
 }
 
+Zone::Zone(const Zone& other) {
+    zoneID = other.zoneID;
+    strcpy(zoneName, other.zoneName);
+    store = nullptr;
+    ownsStore = false;
+    arena = nullptr;
+    rangeFirst = nullptr;
+    rangeCount = nullptr;
+    adjacentZones = nullptr;
+    numAdjacentZones = 0;
+    adjacencyCapacity = 0;
+    growthFactor = other.growthFactor;
+    takeSlots(other, new SlotStore(other.capacity > other.numSlots ? other.capacity : other.numSlots), true);
+    copyAdjacency(other);
+}
+
 Zone& Zone::operator=(const Zone& other) {
     if (this != &other) {
-        if (parkingSlots != nullptr) {
-            delete[] parkingSlots;
-        }
-        if (adjacentZones != nullptr) {
-            delete[] adjacentZones;
+        zoneID = other.zoneID;
+        strcpy(zoneName, other.zoneName);
+        growthFactor = other.growthFactor;
+        takeSlots(other, new SlotStore(other.capacity > other.numSlots ? other.capacity : other.numSlots), true);
+        copyAdjacency(other);
+    }
+    return *this;
+}
+
+Zone::Zone(Zone&& other) : slotIndex(std::move(other.slotIndex)) {
+    zoneID = other.zoneID;
+    strcpy(zoneName, other.zoneName);
+    store = other.store;
+    ownsStore = other.ownsStore;
+    arena = other.arena;
+    rangeFirst = other.rangeFirst;
+    rangeCount = other.rangeCount;
+    numRanges = other.numRanges;
+    rangeCapacity = other.rangeCapacity;
+    numSlots = other.numSlots;
+    capacity = other.capacity;
+    adjacentZones = other.adjacentZones;
+    numAdjacentZones = other.numAdjacentZones;
+    adjacencyCapacity = other.adjacencyCapacity;
+    growthFactor = other.growthFactor;
+    other.store = nullptr;
+    other.ownsStore = false;
+    other.rangeFirst = nullptr;
+    other.rangeCount = nullptr;
+    other.numRanges = 0;
+    other.rangeCapacity = 0;
+    other.numSlots = 0;
+    other.capacity = 0;
+    other.adjacentZones = nullptr;
+    other.numAdjacentZones = 0;
+    other.adjacencyCapacity = 0;
+}
+
+Zone& Zone::operator=(Zone&& other) {
+    if (this != &other) {
+        if (ownsStore) {
+            delete store;
         }
+        releaseInts(rangeFirst, rangeCapacity);
+        releaseInts(rangeCount, rangeCapacity);
+        releaseInts(adjacentZones, adjacencyCapacity);
         zoneID = other.zoneID;
         strcpy(zoneName, other.zoneName);
-        capacity = other.capacity;
+        store = other.store;
+        ownsStore = other.ownsStore;
+        arena = other.arena;
+        rangeFirst = other.rangeFirst;
+        rangeCount = other.rangeCount;
+        numRanges = other.numRanges;
+        rangeCapacity = other.rangeCapacity;
         numSlots = other.numSlots;
-        parkingSlots = new ParkingSlot[capacity];
-        for (int i = 0; i < numSlots; i++) {
-            parkingSlots[i] = other.parkingSlots[i];
-        }
-        adjacencyCapacity = other.adjacencyCapacity;
+        capacity = other.capacity;
+        slotIndex = std::move(other.slotIndex);
+        adjacentZones = other.adjacentZones;
         numAdjacentZones = other.numAdjacentZones;
-        adjacentZones = new int[adjacencyCapacity];
-        for (int i = 0; i < numAdjacentZones; i++) {
-            adjacentZones[i] = other.adjacentZones[i];
-        }
+        adjacencyCapacity = other.adjacencyCapacity;
+        growthFactor = other.growthFactor;
+        other.store = nullptr;
+        other.ownsStore = false;
+        other.rangeFirst = nullptr;
+        other.rangeCount = nullptr;
+        other.numRanges = 0;
+        other.rangeCapacity = 0;
+        other.numSlots = 0;
+        other.capacity = 0;
+        other.adjacentZones = nullptr;
+        other.numAdjacentZones = 0;
+        other.adjacencyCapacity = 0;
     }
     return *this;
 }
 
 Zone::~Zone() {
-    if (parkingSlots != nullptr) {
-        delete[] parkingSlots;
-        parkingSlots = nullptr;
+    if (ownsStore) {
+        delete store;
+    }
+    store = nullptr;
+    releaseInts(rangeFirst, rangeCapacity);
+    releaseInts(rangeCount, rangeCapacity);
+    releaseInts(adjacentZones, adjacencyCapacity);
+    adjacentZones = nullptr;
+}
+
+void Zone::takeSlots(const Zone& source, SlotStore* target, bool owns) {
+    // Step 1: Copy every range of the source into one new range
+    Arena* newArena = owns ? nullptr : target->getArena();
+    int total = source.numSlots;
+    int newCapacity = source.capacity > total ? source.capacity : total;
+    int newFirst = target->reserve(newCapacity);
+    int offset = 0;
+    for (int r = 0; r < source.numRanges && source.store != nullptr; r++) {
+        target->copySlots(newFirst + offset, *source.store, source.rangeFirst[r], source.rangeCount[r]);
+        offset += source.rangeCount[r];
     }
-    if (adjacentZones != nullptr) {
-        delete[] adjacentZones;
-        adjacentZones = nullptr;
+
+    // Step 2: Drop the old view (the source has been read already) and
+    // move the adjacency list to the new arena
+    if (ownsStore) {
+        delete store;
+    }
+    releaseInts(rangeFirst, rangeCapacity);
+    releaseInts(rangeCount, rangeCapacity);
+    int* oldAdjacent = adjacentZones;
+    Arena* oldArena = arena;
+    arena = newArena;
+    if (oldAdjacent != nullptr) {
+        adjacentZones = allocateInts(adjacencyCapacity);
+        for (int i = 0; i < numAdjacentZones; i++) {
+            adjacentZones[i] = oldAdjacent[i];
+        }
+        if (oldArena == nullptr) {
+            delete[] oldAdjacent;
+        } else {
+            oldArena->releaseArray(oldAdjacent, adjacencyCapacity);
+        }
+    }
+
+    // Step 3: View the new range
+    store = target;
+    ownsStore = owns;
+    capacity = newCapacity;
+    numSlots = total;
+    rangeCapacity = 4;  // Default range capacity
+    rangeFirst = allocateInts(rangeCapacity);
+    rangeCount = allocateInts(rangeCapacity);
+    rangeFirst[0] = newFirst;
+    rangeCount[0] = total;
+    numRanges = 1;
+    slotIndex.moveToArena(arena);
+    slotIndex.clear();
+    for (int i = 0; i < total; i++) {
+        int slotID = store->getSlotID(newFirst + i);
+        slotIndex.add(slotID, newFirst + i);  // First slot with an ID wins
     }
 }
 
 void Zone::addSlot(const ParkingSlot& slot) {
-    if (numSlots < capacity) {
-        parkingSlots[numSlots] = slot;
-        numSlots++;
+    if (numRanges == 0) {
+        return;  // Moved-from zone
+    }
+    if (rangeCount[0] == capacity) {
+        growOwnRange(Arena::grownCapacity(capacity, rangeCount[0] + 1, growthFactor));
+    }
+    int position = rangeFirst[0] + rangeCount[0];
+    store->setSlot(position, slot.getSlotID(), slot.getZoneID(), slot.getIsAvailable());
+    store->setCoordinates(position, slot.getX(), slot.getY(), slot.getLevel());
+    store->setSlotType(position, slot.getSlotType());
+    slotIndex.add(slot.getSlotID(), position);  // First slot with an ID wins
+    rangeCount[0]++;
+    numSlots++;
+}
+
+void Zone::growOwnRange(int newCapacity) {
+    // The last range in the store grows in place; any other moves to a new
+    // range and gives the old one back for reuse
+    int oldFirst = rangeFirst[0];
+    int count = rangeCount[0];
+    if (store->extendRange(oldFirst, capacity, newCapacity)) {
+        capacity = newCapacity;
+        return;
+    }
+    int newFirst = store->reserve(newCapacity);
+    if (count > 0) {
+        store->copySlots(newFirst, *store, oldFirst, count);
     }
-    // If capacity is full, do nothing (could add error handling if needed)
+    for (int i = 0; i < count; i++) {
+        int slotID = store->getSlotID(newFirst + i);
+        if (slotIndex.find(slotID) == oldFirst + i) {
+            slotIndex.set(slotID, newFirst + i);
+        }
+    }
+    store->releaseRange(oldFirst, capacity);
+    rangeFirst[0] = newFirst;
+    capacity = newCapacity;
+}
+
+void Zone::setGrowthFactor(double factor) {
+    growthFactor = factor;
+}
+
+double Zone::getGrowthFactor() const {
+    return growthFactor;
+}
+
+void Zone::attachToStore(SlotStore* target) {
+    if (target != store) {
+        takeSlots(*this, target, false);
+    }
+}
+
+void Zone::linkSlotRange(int first, int count) {
+    // Grow the range arrays if full
+    if (numRanges == rangeCapacity) {
+        int newCapacity = Arena::grownCapacity(rangeCapacity, 4, growthFactor);
+        int* newFirst = allocateInts(newCapacity);
+        int* newCount = allocateInts(newCapacity);
+        for (int r = 0; r < numRanges; r++) {
+            newFirst[r] = rangeFirst[r];
+            newCount[r] = rangeCount[r];
+        }
+        releaseInts(rangeFirst, rangeCapacity);
+        releaseInts(rangeCount, rangeCapacity);
+        rangeFirst = newFirst;
+        rangeCount = newCount;
+        rangeCapacity = newCapacity;
+    }
+    rangeFirst[numRanges] = first;
+    rangeCount[numRanges] = count;
+    numRanges++;
+    numSlots += count;
+    for (int p = first; p < first + count; p++) {
+        int slotID = store->getSlotID(p);
+        slotIndex.add(slotID, p);  // First slot with an ID wins
+    }
+}
+
+int Zone::getNumSlots() const {
+    return numSlots;
+}
+
+int Zone::getNumRanges() const {
+    return numRanges;
+}
+
+int Zone::getRangeFirst(int range) const {
+    return rangeFirst[range];
+}
+
+int Zone::getRangeCount(int range) const {
+    return rangeCount[range];
+}
+
+int Zone::getOwnCapacity() const {
+    return capacity;
+}
+
+void Zone::restoreRanges(const int* firsts, const int* counts, int count, int ownCapacity) {
+    releaseInts(rangeFirst, rangeCapacity);
+    releaseInts(rangeCount, rangeCapacity);
+    rangeCapacity = (count > 4) ? count : 4;
+    rangeFirst = allocateInts(rangeCapacity);
+    rangeCount = allocateInts(rangeCapacity);
+    numRanges = count;
+    numSlots = 0;
+    capacity = ownCapacity;
+    slotIndex.clear();
+    int minID = 0;
+    int maxID = -1;
+    int total = 0;
+    for (int r = 0; r < count; r++) {
+        for (int p = firsts[r]; p < firsts[r] + counts[r]; p++) {
+            int slotID = store->getSlotID(p);
+            minID = (total == 0 || slotID < minID) ? slotID : minID;
+            maxID = (total == 0 || slotID > maxID) ? slotID : maxID;
+            total++;
+        }
+    }
+    slotIndex.reserve(minID, maxID, total);
+    for (int r = 0; r < count; r++) {
+        rangeFirst[r] = firsts[r];
+        rangeCount[r] = counts[r];
+        numSlots += counts[r];
+        for (int p = firsts[r]; p < firsts[r] + counts[r]; p++) {
+            int slotID = store->getSlotID(p);
+            slotIndex.add(slotID, p);  // First slot with an ID wins
+        }
+    }
+}
+
+int Zone::getAvailableSlots() const {
+    int available = 0;
+    for (int r = 0; r < numRanges; r++) {
+        available += store->countFree(rangeFirst[r], rangeCount[r]);
+    }
+    return available;
 }
 
 bool Zone::isAvailable() const {
-    for (int i = 0; i < numSlots; i++) {
-        if (parkingSlots[i].getIsAvailable()) {
+    for (int r = 0; r < numRanges; r++) {
+        if (store->findFree(rangeFirst[r], rangeCount[r]) != -1) {
             return true;
         }
     }
@@ -95,12 +370,11 @@ bool Zone::isAvailable() const {
 }
 
 bool Zone::isSlotAvailable(int slotID) const {
-    for (int i = 0; i < numSlots; i++) {
-        if (parkingSlots[i].getSlotID() == slotID) {
-            return parkingSlots[i].getIsAvailable();
-        }
+    int position = slotIndex.find(slotID);
+    if (position == -1) {
+        return false;  // Slot not found
     }
-    return false;  // Slot not found or not available
+    return store->isFree(position);
 }
 
 int Zone::getZoneID() const {
@@ -128,12 +402,20 @@ void Zone::addAdjacentZone(int adjacentZoneID) {
             return;  // Already adjacent, skip
         }
     }
-    
-    // Add if capacity allows
-    if (numAdjacentZones < adjacencyCapacity) {
-        adjacentZones[numAdjacentZones] = adjacentZoneID;
-        numAdjacentZones++;
+
+    // Grow the adjacency list if full
+    if (numAdjacentZones == adjacencyCapacity) {
+        int newCapacity = Arena::grownCapacity(adjacencyCapacity, numAdjacentZones + 1, growthFactor);
+        int* newAdjacent = allocateInts(newCapacity);
+        for (int i = 0; i < numAdjacentZones; i++) {
+            newAdjacent[i] = adjacentZones[i];
+        }
+        releaseInts(adjacentZones, adjacencyCapacity);
+        adjacentZones = newAdjacent;
+        adjacencyCapacity = newCapacity;
     }
+    adjacentZones[numAdjacentZones] = adjacentZoneID;
+    numAdjacentZones++;
 }
 
 bool Zone::isAdjacentZone(int zoneID) const {
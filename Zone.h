@@ -2,17 +2,52 @@
 #define ZONE_H
 
 #include "ParkingSlot.h"
+#include "SlotStore.h"
+#include "IdIndex.h"
+
+// A zone views its slots through ranges of positions in a SlotStore: range 0
+// holds the slots added with addSlot, further ranges are the slots of the
+// zone's parking areas, linked by ParkingSystem. Zone and area therefore
+// read the same availability bit for a slot and cannot disagree.
+// A zone attached to an arena-backed store keeps its range, index and
+// adjacency arrays in that arena too, so it owns no heap memory.
 
 class Zone {
 private:
     int zoneID;
     char zoneName[50];  // Fixed-size character array for zone name (no STL strings)
-    ParkingSlot* parkingSlots;  // Array of ParkingSlot pointers
-    int numSlots;      // Current number of slots in the zone
-    int capacity;      // Maximum capacity of the parking slots array
+    SlotStore* store;   // Slot columns holding this zone's slots
+    bool ownsStore;     // True if store is private to this zone
+    Arena* arena;       // Arena for the range, index and adjacency arrays (nullptr = heap)
+    int* rangeFirst;    // First store position of each slot range (range 0 = own slots)
+    int* rangeCount;    // Number of slots in each range
+    int numRanges;      // Number of slot ranges
+    int rangeCapacity;  // Capacity of the range arrays
+    int numSlots;      // Current number of slots in the zone (all ranges)
+    int capacity;      // Maximum capacity of the zone's own range
+    IdIndex slotIndex;  // slotID -> store position, first slot with an ID wins
     int* adjacentZones;  // Array of adjacent zone IDs
     int numAdjacentZones;  // Number of adjacent zones
     int adjacencyCapacity;  // Capacity of adjacentZones array
+    double growthFactor;    // Factor by which full slot, range and adjacency arrays grow
+
+    // Move the own range (range 0) to a larger range of the same store and
+    // re-point its slotIndex entries; the old range is cleared
+    void growOwnRange(int newCapacity);
+
+    // Shared constructor body: own range of initialCapacity slots in target
+    void init(SlotStore* target, bool owns, int initialCapacity);
+
+    // Allocate and release int arrays from the arena or the heap
+    int* allocateInts(int count);
+    void releaseInts(int* array, int count);
+
+    // Replace the adjacency list with a copy of another zone's
+    void copyAdjacency(const Zone& other);
+
+    // Copy every slot of source (all ranges) into one new own range in target,
+    // then view that range. source may be this zone
+    void takeSlots(const Zone& source, SlotStore* target, bool owns);
 
 public:
     // Default constructor
@@ -21,22 +56,62 @@ public:
     // Constructor with initial capacity
     Zone(int initialCapacity);
 
+    // Constructor that reserves the zone's own slots directly in an existing
+    // store (used by ParkingSystem::emplaceZone; the store is not owned)
+    Zone(SlotStore* target, int initialCapacity);
+
     // Copy constructor
     Zone(const Zone& other);
 
     // Copy assignment operator
     Zone& operator=(const Zone& other);
 
+    // Move constructor (takes over slots and adjacency, leaves other empty)
+    Zone(Zone&& other);
+
+    // Move assignment operator
+    Zone& operator=(Zone&& other);
+
     // Destructor
     ~Zone();
 
-    // Function to add a parking slot to the zone
+    // Function to add a parking slot to the zone (grows the capacity when full)
     void addSlot(const ParkingSlot& slot);
 
+    // Growth factor used when the slot, range or adjacency arrays are full
+    // (values <= 1 grow one entry at a time)
+    void setGrowthFactor(double factor);
+    double getGrowthFactor() const;
+
+    // Move all of this zone's slots into another store (e.g. the
+    // facility-wide store) and view them there from now on
+    void attachToStore(SlotStore* target);
+
+    // View count slots starting at a position of the zone's store
+    // (ParkingSystem links the range of every area in the zone)
+    void linkSlotRange(int first, int count);
+
+    // Getter for number of slots (own and linked)
+    int getNumSlots() const;
+
+    // Snapshot support: the viewed ranges (range 0 = own slots) and the
+    // capacity of the own range
+    int getNumRanges() const;
+    int getRangeFirst(int range) const;
+    int getRangeCount(int range) const;
+    int getOwnCapacity() const;
+
+    // Snapshot support: view ranges of the current store that already hold
+    // the zone's slots (replaces the current ranges and rebuilds the index)
+    void restoreRanges(const int* firsts, const int* counts, int count, int ownCapacity);
+
+    // Number of available slots across all ranges (bitmap popcount)
+    int getAvailableSlots() const;
+
     // Function to check if the zone has any available parking slots
     bool isAvailable() const;
 
-    // Function to check if a specific slot is available by slotID
+    // Function to check if a specific slot is available by slotID (O(1))
     bool isSlotAvailable(int slotID) const;
 
     // Getter for zoneID
@@ -51,7 +126,8 @@ public:
     // Setter for zoneName
     void setZoneName(const char* name);
 
-    // Function to add an adjacent zone (for zone relationships)
+    // Function to add an adjacent zone (for zone relationships); the
+    // adjacency list grows when full
     void addAdjacentZone(int adjacentZoneID);
 
     // Function to check if a zone is adjacent
@@ -0,0 +1,208 @@
+#include "ZoneIndex.h"
+
+ZoneIndex::ZoneIndex() {
+    bucketCapacity = 8;  // Default bucket capacity
+    numBuckets = 0;
+    zoneIDs = new int[bucketCapacity];
+    areaLists = new int*[bucketCapacity];
+    areaCounts = new int[bucketCapacity];
+    areaCapacities = new int[bucketCapacity];
+    hopDistances = nullptr;
+    searchOrders = nullptr;
+    tableBuckets = 0;
+    distancesDirty = false;
+}
+
+ZoneIndex::~ZoneIndex() {
+    for (int i = 0; i < numBuckets; i++) {
+        delete[] areaLists[i];
+    }
+    delete[] zoneIDs;
+    delete[] areaLists;
+    delete[] areaCounts;
+    delete[] areaCapacities;
+    delete[] hopDistances;
+    delete[] searchOrders;
+}
+
+void ZoneIndex::growBuckets() {
+    int newCapacity = bucketCapacity * 2;
+    int* newZoneIDs = new int[newCapacity];
+    int** newAreaLists = new int*[newCapacity];
+    int* newAreaCounts = new int[newCapacity];
+    int* newAreaCapacities = new int[newCapacity];
+    for (int i = 0; i < numBuckets; i++) {
+        newZoneIDs[i] = zoneIDs[i];
+        newAreaLists[i] = areaLists[i];
+        newAreaCounts[i] = areaCounts[i];
+        newAreaCapacities[i] = areaCapacities[i];
+    }
+    delete[] zoneIDs;
+    delete[] areaLists;
+    delete[] areaCounts;
+    delete[] areaCapacities;
+    zoneIDs = newZoneIDs;
+    areaLists = newAreaLists;
+    areaCounts = newAreaCounts;
+    areaCapacities = newAreaCapacities;
+    bucketCapacity = newCapacity;
+}
+
+int ZoneIndex::addZone(int zoneID) {
+    int bucket = bucketOfZone.find(zoneID);
+    if (bucket != -1) {
+        return bucket;
+    }
+
+    if (numBuckets == bucketCapacity) {
+        growBuckets();
+    }
+    bucket = numBuckets;
+    zoneIDs[bucket] = zoneID;
+    areaCapacities[bucket] = 4;  // Default area list capacity
+    areaCounts[bucket] = 0;
+    areaLists[bucket] = new int[areaCapacities[bucket]];
+    numBuckets++;
+    bucketOfZone.set(zoneID, bucket);
+    distancesDirty = true;  // New bucket is not in the distance tables yet
+    return bucket;
+}
+
+void ZoneIndex::addArea(int zoneID, int areaIndex) {
+    int bucket = addZone(zoneID);
+
+    // Grow this bucket's area list if full
+    if (areaCounts[bucket] == areaCapacities[bucket]) {
+        int newCapacity = areaCapacities[bucket] * 2;
+        int* newList = new int[newCapacity];
+        for (int i = 0; i < areaCounts[bucket]; i++) {
+            newList[i] = areaLists[bucket][i];
+        }
+        delete[] areaLists[bucket];
+        areaLists[bucket] = newList;
+        areaCapacities[bucket] = newCapacity;
+    }
+
+    areaLists[bucket][areaCounts[bucket]] = areaIndex;
+    areaCounts[bucket]++;
+}
+
+int ZoneIndex::findBucket(int zoneID) const {
+    return bucketOfZone.find(zoneID);
+}
+
+int ZoneIndex::getNumBuckets() const {
+    return numBuckets;
+}
+
+int ZoneIndex::getBucketZoneID(int bucket) const {
+    return zoneIDs[bucket];
+}
+
+const int* ZoneIndex::getBucketAreas(int bucket) const {
+    return areaLists[bucket];
+}
+
+int ZoneIndex::getBucketAreaCount(int bucket) const {
+    return areaCounts[bucket];
+}
+
+void ZoneIndex::markDistancesDirty() {
+    distancesDirty = true;
+}
+
+bool ZoneIndex::needsRebuild() const {
+    return distancesDirty;
+}
+
+void ZoneIndex::rebuildDistances(const Zone* zones, int numZones) {
+    // Step 1: Make sure every zone and every adjacent zone has a bucket
+    for (int i = 0; i < numZones; i++) {
+        addZone(zones[i].getZoneID());
+        const int* adjacent = zones[i].getAdjacentZones();
+        for (int j = 0; j < zones[i].getNumAdjacentZones(); j++) {
+            addZone(adjacent[j]);
+        }
+    }
+    int n = numBuckets;
+
+    // Step 2: Build an undirected bucket adjacency list (CSR layout)
+    int* degree = new int[n + 1];
+    for (int b = 0; b <= n; b++) {
+        degree[b] = 0;
+    }
+    for (int i = 0; i < numZones; i++) {
+        int from = bucketOfZone.find(zones[i].getZoneID());
+        const int* adjacent = zones[i].getAdjacentZones();
+        for (int j = 0; j < zones[i].getNumAdjacentZones(); j++) {
+            int to = bucketOfZone.find(adjacent[j]);
+            degree[from]++;
+            degree[to]++;
+        }
+    }
+    int* edgeStart = new int[n + 1];
+    edgeStart[0] = 0;
+    for (int b = 0; b < n; b++) {
+        edgeStart[b + 1] = edgeStart[b] + degree[b];
+        degree[b] = edgeStart[b];  // Reused as fill cursor
+    }
+    int* edges = new int[edgeStart[n] > 0 ? edgeStart[n] : 1];
+    for (int i = 0; i < numZones; i++) {
+        int from = bucketOfZone.find(zones[i].getZoneID());
+        const int* adjacent = zones[i].getAdjacentZones();
+        for (int j = 0; j < zones[i].getNumAdjacentZones(); j++) {
+            int to = bucketOfZone.find(adjacent[j]);
+            edges[degree[from]++] = to;
+            edges[degree[to]++] = from;
+        }
+    }
+
+    // Step 3: Breadth-first search from every bucket
+    delete[] hopDistances;
+    delete[] searchOrders;
+    hopDistances = new int[n * n];
+    searchOrders = new int[n * n];
+    tableBuckets = n;
+    for (int from = 0; from < n; from++) {
+        int* dist = hopDistances + from * n;
+        int* order = searchOrders + from * n;
+        for (int b = 0; b < n; b++) {
+            dist[b] = -1;
+        }
+        // The search order doubles as the BFS queue: buckets are appended
+        // in non-decreasing hop distance
+        int head = 0;
+        int tail = 0;
+        dist[from] = 0;
+        order[tail++] = from;
+        while (head < tail) {
+            int u = order[head++];
+            for (int e = edgeStart[u]; e < edgeStart[u + 1]; e++) {
+                int v = edges[e];
+                if (dist[v] == -1) {
+                    dist[v] = dist[u] + 1;
+                    order[tail++] = v;
+                }
+            }
+        }
+        // Unreachable buckets are searched last, in bucket order
+        for (int b = 0; b < n; b++) {
+            if (dist[b] == -1) {
+                order[tail++] = b;
+            }
+        }
+    }
+
+    delete[] degree;
+    delete[] edgeStart;
+    delete[] edges;
+    distancesDirty = false;
+}
+
+int ZoneIndex::getHopDistance(int fromBucket, int toBucket) const {
+    return hopDistances[fromBucket * tableBuckets + toBucket];
+}
+
+const int* ZoneIndex::getSearchOrder(int fromBucket) const {
+    return searchOrders + fromBucket * tableBuckets;
+}
@@ -0,0 +1,88 @@
+#ifndef ZONE_INDEX_H
+#define ZONE_INDEX_H
+
+#include "IdIndex.h"
+#include "Zone.h"
+
+// Zone -> parking area index.
+// Every distinct zoneID gets a "bucket" holding the indices (into the
+// ParkingSystem areas array) of the areas that belong to that zone, so the
+// allocation engine only touches the areas of the zone it is searching.
+// Buckets are numbered densely in the order zones are first seen.
+//
+// The index also precomputes hop distances between zones from the Zone
+// adjacency lists (treated as undirected) and, for every zone, the order in
+// which the other zones should be searched: nearest first, unreachable
+// zones last. The table is rebuilt whenever zones, adjacency or new zone
+// buckets are added.
+
+class ZoneIndex {
+private:
+    IdIndex bucketOfZone;  // zoneID -> bucket number
+
+    int* zoneIDs;          // zoneID of each bucket
+    int** areaLists;       // Area indices of each bucket
+    int* areaCounts;       // Number of areas in each bucket
+    int* areaCapacities;   // Capacity of each bucket's area list
+    int numBuckets;        // Current number of buckets
+    int bucketCapacity;    // Capacity of the bucket arrays
+
+    int* hopDistances;     // hopDistances[from * tableBuckets + to], -1 if unreachable
+    int* searchOrders;     // searchOrders[from * tableBuckets + k] = k-th nearest bucket
+    int tableBuckets;      // Number of buckets covered by the distance tables
+    bool distancesDirty;   // True when the tables must be rebuilt
+
+    // Grow the bucket arrays when full
+    void growBuckets();
+
+public:
+    // Constructor: Creates an empty index
+    ZoneIndex();
+
+    // Destructor
+    ~ZoneIndex();
+
+    // Copying would share area lists, so the index is not copyable
+    ZoneIndex(const ZoneIndex& other) = delete;
+    ZoneIndex& operator=(const ZoneIndex& other) = delete;
+
+    // Get the bucket for a zone, creating an empty one if needed
+    int addZone(int zoneID);
+
+    // Register an area (by its index in the areas array) under its zone
+    void addArea(int zoneID, int areaIndex);
+
+    // Find the bucket of a zone (-1 if the zone has no bucket)
+    int findBucket(int zoneID) const;
+
+    // Getter for number of buckets
+    int getNumBuckets() const;
+
+    // Getter for the zoneID of a bucket
+    int getBucketZoneID(int bucket) const;
+
+    // Getter for the area indices of a bucket
+    const int* getBucketAreas(int bucket) const;
+
+    // Getter for number of areas in a bucket
+    int getBucketAreaCount(int bucket) const;
+
+    // Mark the distance tables as stale (zones or adjacency changed)
+    void markDistancesDirty();
+
+    // Check if the distance tables must be rebuilt before use
+    bool needsRebuild() const;
+
+    // Rebuild hop distances and search orders from the zones' adjacency
+    // lists using one breadth-first search per bucket: O(z·(z + e))
+    void rebuildDistances(const Zone* zones, int numZones);
+
+    // Hop distance between two buckets (-1 if unreachable)
+    int getHopDistance(int fromBucket, int toBucket) const;
+
+    // Buckets ordered by hop distance from a bucket (the bucket itself first,
+    // unreachable buckets last); getNumBuckets() entries
+    const int* getSearchOrder(int fromBucket) const;
+};
+
+#endif // ZONE_INDEX_H
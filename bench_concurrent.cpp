@@ -0,0 +1,99 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+#include "ParkingSystem.h"
+
+// Multi-threaded allocation stress benchmark.
+// Builds a facility, switches ParkingSystem to concurrent mode and lets
+// 1, 2, 4 and 8 gate threads allocate every request. Each thread handles a
+// contiguous block of requests spread over all zones, so threads contend on
+// the same zone locks and on the shared bookkeeping lock. That lock is
+// taken twice per allocation and bounds the speedup (about 1.2x at 2 and 4
+// threads, none at 8; see design.md Section 3.6).
+// Usage: bench_concurrent [zones] [areasPerZone] [slotsPerArea]
+
+void allocate_range(ParkingSystem* system, int first, int count) {
+    for (int i = first; i < first + count; i++) {
+        system->allocateForRequest(i);
+    }
+}
+
+// Build a facility with zones in a line and one request per slot
+ParkingSystem* build_facility(int numZones, int areasPerZone, int slotsPerArea) {
+    int numAreas = numZones * areasPerZone;
+    int numRequests = numAreas * slotsPerArea;
+    ParkingSystem* system = new ParkingSystem(numZones, numRequests, numRequests, numAreas, numRequests);
+    for (int z = 1; z <= numZones; z++) {
+        Zone zone;
+        zone.setZoneID(z);
+        system->addZone(zone);
+        if (z > 1) {
+            system->addZoneAdjacency(z - 1, z);
+        }
+    }
+    for (int a = 0; a < numAreas; a++) {
+        int z = (a % numZones) + 1;
+        ParkingArea area(slotsPerArea);
+        area.setAreaID(a + 1);
+        area.setZoneID(z);
+        for (int i = 0; i < slotsPerArea; i++) {
+            ParkingSlot slot;
+            slot.setSlotID(a * slotsPerArea + i);
+            slot.setZoneID(z);
+            slot.setIsAvailable(true);
+            area.addSlot(slot);
+        }
+        system->addArea(area);
+    }
+    for (int i = 0; i < numRequests; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone((i % numZones) + 1);
+        req.setRequestTime(i);
+        system->addRequest(req);
+    }
+    system->enableConcurrentAllocation();
+    return system;
+}
+
+int main(int argc, char* argv[]) {
+    int numZones = argc > 1 ? std::atoi(argv[1]) : 64;
+    int areasPerZone = argc > 2 ? std::atoi(argv[2]) : 4;
+    int slotsPerArea = argc > 3 ? std::atoi(argv[3]) : 256;
+    int numRequests = numZones * areasPerZone * slotsPerArea;
+
+    std::cout << "Concurrent allocation: " << numZones << " zones, "
+              << areasPerZone << " areas/zone, " << slotsPerArea << " slots/area, "
+              << numRequests << " requests" << std::endl;
+    std::cout << "threads\tops/sec\tspeedup\tconsistent" << std::endl;
+
+    double baseline = 0.0;
+    for (int numThreads = 1; numThreads <= 8; numThreads *= 2) {
+        ParkingSystem* system = build_facility(numZones, areasPerZone, slotsPerArea);
+
+        std::thread* workers = new std::thread[numThreads];
+        int perThread = numRequests / numThreads;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (int t = 0; t < numThreads; t++) {
+            int count = (t == numThreads - 1) ? numRequests - t * perThread : perThread;
+            workers[t] = std::thread(allocate_range, system, t * perThread, count);
+        }
+        for (int t = 0; t < numThreads; t++) {
+            workers[t].join();
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        delete[] workers;
+
+        double opsPerSec = numRequests / elapsed.count();
+        if (numThreads == 1) {
+            baseline = opsPerSec;
+        }
+        bool consistent = system->getAvailableSlots() == 0 && system->verifyCounters();
+        std::cout << numThreads << "\t" << static_cast<long long>(opsPerSec) << "\t"
+                  << (opsPerSec / baseline) << "\t" << (consistent ? "yes" : "NO") << std::endl;
+        delete system;
+    }
+    return 0;
+}
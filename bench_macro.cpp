@@ -0,0 +1,451 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "ParkingSystem.h"
+
+// City-scale macro benchmark.
+// Builds a synthetic facility (zones in a line, every zone adjacent to the
+// next) and runs the main workloads one after another on the same system:
+//   build        register every area (with its slots); the arena bytes the
+//                configuration took (in total and per slot) are printed
+//                after it
+//   allocate     allocateForRequest for every request; 80% of requests pick
+//                a uniformly random zone, 20% go to zone 1 so it fills up
+//                and the rest spill over through cross-zone fallback
+//   occupy       ALLOCATED -> OCCUPIED for the first half of the requests
+//   release      OCCUPIED -> RELEASED for the same half
+//   cancel       ALLOCATED -> CANCELLED for the third quarter
+//   rollback     rollbackLast for the last quarter (still ALLOCATED)
+//   analytics    a mix of the O(1) analytics getters and top-10 zones
+//   lifecycle / lifecycle_journaled
+//                allocate, occupy and release one new request (a quarter
+//                of the request count each), first without and then with a
+//                write-ahead journal (bench_journal.bin, group commit with
+//                the default group size); every slot is returned, so both
+//                run at the same fill level. The journal overhead and the
+//                number of group commits (fsyncs) are printed after them
+//   snapshot_save / snapshot_load
+//                write the whole state to bench_snapshot.bin and restore it
+//                (one operation each; the file is removed afterwards)
+//   nearest      findNearestAvailableSlot on a separate 10k-slot deck
+//                (4 levels of 50 x 50 bays) at 95% occupancy, from random
+//                reference points (up to 100k queries; the spatial index
+//                is built before timing starts)
+//   typed_claim  findFirstAvailableSlotOfType + occupySlot for a random slot
+//                type on a separate 10k-slot area mixing types (80% standard,
+//                10% EV, 5% accessible, 3% compact, 2% motorcycle) held at
+//                95% occupancy: a random occupied slot is freed after each
+//                claim, outside the timing
+// The workloads from lifecycle on use APIs added after the core ones; each
+// is compiled only when ParkingSystem.h defines its feature macro
+// (PARKING_HAS_JOURNAL, _SNAPSHOT, _NEAREST, _SLOT_TYPES), so the core
+// workloads build and run on older trees as well.
+// Each operation is timed on its own, so the reported ops/sec include the
+// clock overhead (about 20 ns per call). Latency percentiles are exact.
+//
+// Built with -DPARKING_INSTRUMENTATION, the system's own latency histograms
+// are printed at the end as well (not with --csv).
+//
+// Usage: bench_macro [--csv] [zones] [areasPerZone] [slotsPerArea] [requests]
+// With --csv the results are printed as comma-separated lines with a header,
+// e.g. to keep a baseline: bench_macro --csv > bench_output.txt
+
+typedef std::chrono::steady_clock Clock;
+
+// Deterministic pseudo-random numbers (xorshift), so every run is comparable
+unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+long long elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// In-place heap sort of the latency samples (no STL algorithms)
+void sift_down(long long* values, int root, int count) {
+    long long value = values[root];
+    while (true) {
+        int child = 2 * root + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && values[child + 1] > values[child]) {
+            child++;
+        }
+        if (values[child] <= value) {
+            break;
+        }
+        values[root] = values[child];
+        root = child;
+    }
+    values[root] = value;
+}
+
+void sort_samples(long long* values, int count) {
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        sift_down(values, i, count);
+    }
+    for (int end = count - 1; end > 0; end--) {
+        long long top = values[0];
+        values[0] = values[end];
+        values[end] = top;
+        sift_down(values, 0, end);
+    }
+}
+
+// Sample at a percentile of sorted samples (nearest rank)
+long long percentile(const long long* sorted, int count, double p) {
+    if (count == 0) {
+        return 0;
+    }
+    int rank = static_cast<int>(p / 100.0 * count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    return sorted[rank - 1];
+}
+
+// Print one workload's throughput and latency percentiles
+void report(const char* workload, long long* samples, int count, long long totalNs, bool csv) {
+    sort_samples(samples, count);
+    double seconds = totalNs / 1e9;
+    double opsPerSec = (seconds > 0.0) ? count / seconds : 0.0;
+    long long p50 = percentile(samples, count, 50.0);
+    long long p99 = percentile(samples, count, 99.0);
+    long long p999 = percentile(samples, count, 99.9);
+    if (csv) {
+        std::cout << workload << "," << count << "," << seconds << ","
+                  << static_cast<long long>(opsPerSec) << "," << p50 << "," << p99 << ","
+                  << p999 << std::endl;
+    } else {
+        std::cout << workload << "\t" << count << "\t" << static_cast<long long>(opsPerSec)
+                  << "\t" << p50 << "\t" << p99 << "\t" << p999 << std::endl;
+    }
+}
+
+int main(int argc, char* argv[]) {
+    bool csv = false;
+    int values[4] = {500, 20, 500, 1000000};  // zones, areas/zone, slots/area, requests
+    int numValues = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (numValues < 4) {
+            values[numValues++] = std::atoi(argv[i]);
+        }
+    }
+    int numZones = values[0];
+    int areasPerZone = values[1];
+    int slotsPerArea = values[2];
+    int numRequests = values[3];
+    int numAreas = numZones * areasPerZone;
+    if (numZones <= 0 || areasPerZone <= 0 || slotsPerArea <= 0 || numRequests <= 0) {
+        std::cerr << "Usage: bench_macro [--csv] [zones] [areasPerZone] [slotsPerArea] [requests]" << std::endl;
+        return 1;
+    }
+
+    int maxSamples = (numRequests > numAreas) ? numRequests : numAreas;
+    long long* samples = new long long[maxSamples];
+    ParkingSlot* slots = new ParkingSlot[slotsPerArea];
+    unsigned int seed = 12345;
+
+    if (csv) {
+        std::cout << "# zones=" << numZones << ",areas_per_zone=" << areasPerZone
+                  << ",slots_per_area=" << slotsPerArea << ",requests=" << numRequests << std::endl;
+        std::cout << "workload,ops,seconds,ops_per_sec,p50_ns,p99_ns,p999_ns" << std::endl;
+    } else {
+        std::cout << "Macro benchmark: " << numZones << " zones, " << areasPerZone
+                  << " areas/zone, " << slotsPerArea << " slots/area ("
+                  << static_cast<long long>(numAreas) * slotsPerArea << " slots), "
+                  << numRequests << " requests" << std::endl;
+        std::cout << "workload\tops\tops/sec\tp50_ns\tp99_ns\tp999_ns" << std::endl;
+    }
+
+    // Build: zones in a line, each zone's areas (and slotIDs) contiguous
+    ParkingSystem* system = new ParkingSystem(numZones, numRequests, numRequests, numAreas, numRequests);
+    long long totalNs = 0;
+    for (int z = 1; z <= numZones; z++) {
+        system->emplaceZone(z, "Zone");
+        if (z > 1) {
+            system->addZoneAdjacency(z - 1, z);
+        }
+    }
+    for (int a = 0; a < numAreas; a++) {
+        int z = (a / areasPerZone) + 1;
+        for (int i = 0; i < slotsPerArea; i++) {
+            slots[i].setSlotID(a * slotsPerArea + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(true);
+        }
+        Clock::time_point start = Clock::now();
+        system->emplaceArea(a + 1, z, slots, slotsPerArea);
+        samples[a] = elapsed_ns(start, Clock::now());
+        totalNs += samples[a];
+    }
+    report("build", samples, numAreas, totalNs, csv);
+    double buildBytesPerSlot = static_cast<double>(system->getArena().getBytesReserved()) /
+                               (static_cast<double>(numAreas) * (slotsPerArea > 0 ? slotsPerArea : 1));
+    if (csv) {
+        std::cout << "# build_arena_bytes=" << system->getArena().getBytesReserved()
+                  << ",bytes_per_slot=" << buildBytesPerSlot << std::endl;
+    } else {
+        std::cout << "build: " << system->getArena().getBytesReserved() / (1024 * 1024) << " MB arena reserved ("
+                  << buildBytesPerSlot << " bytes/slot)" << std::endl;
+    }
+
+    for (int i = 0; i < numRequests; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone((next_random(&seed) % 5 == 0) ? 1 : (next_random(&seed) % numZones) + 1);
+        req.setRequestTime(i);
+        system->addRequest(req);
+    }
+
+    // Allocate every request (the first call also builds the distance tables)
+    totalNs = 0;
+    int allocated = 0;
+    for (int i = 0; i < numRequests; i++) {
+        Clock::time_point start = Clock::now();
+        int slotID = system->allocateForRequest(i);
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+        if (slotID != -1) {
+            allocated++;
+        }
+    }
+    report("allocate", samples, numRequests, totalNs, csv);
+
+    // Lifecycle transitions on disjoint quarters of the requests
+    int half = numRequests / 2;
+    int quarter = numRequests / 4;
+    totalNs = 0;
+    for (int i = 0; i < half; i++) {
+        Clock::time_point start = Clock::now();
+        system->occupyRequest(i);
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("occupy", samples, half, totalNs, csv);
+
+    totalNs = 0;
+    for (int i = 0; i < half; i++) {
+        Clock::time_point start = Clock::now();
+        system->releaseRequest(i, numRequests + i);
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("release", samples, half, totalNs, csv);
+
+    totalNs = 0;
+    for (int i = 0; i < quarter; i++) {
+        Clock::time_point start = Clock::now();
+        system->cancelRequest(half + i);
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("cancel", samples, quarter, totalNs, csv);
+
+    // Roll back the newest allocations (the last quarter is still ALLOCATED)
+    int numRollbacks = numRequests - half - quarter;
+    totalNs = 0;
+    for (int i = 0; i < numRollbacks; i++) {
+        Clock::time_point start = Clock::now();
+        system->rollbackLast();
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("rollback", samples, numRollbacks, totalNs, csv);
+
+    // Analytics query mix
+    int topZones[10];
+    long long checksum = 0;
+    totalNs = 0;
+    for (int i = 0; i < numRequests; i++) {
+        Clock::time_point start = Clock::now();
+        switch (i % 5) {
+            case 0: checksum += system->getAvailableSlots(); break;
+            case 1: checksum += static_cast<long long>(system->getZoneUtilization((next_random(&seed) % numZones) + 1)); break;
+            case 2: checksum += system->getPeakUsageZone(); break;
+            case 3: checksum += system->getActiveRequests(); break;
+            default: checksum += system->getTopUsageZones(10, topZones); break;
+        }
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("analytics", samples, numRequests, totalNs, csv);
+
+#if defined(PARKING_HAS_JOURNAL)
+    // Journal overhead: the same lifecycle with and without the journal
+    int lifecycles = quarter;
+    double lifecycleSeconds[2] = {0.0, 0.0};
+    Journal journal;
+    bool journaled = journal.open("bench_journal.bin", system->getJournalSequence() + 1);
+    for (int pass = 0; pass < 2; pass++) {
+        if (pass == 1 && !(journaled && system->attachJournal(&journal))) {
+            break;
+        }
+        int firstIndex = system->getNumRequests();
+        for (int i = 0; i < lifecycles; i++) {
+            ParkingRequest req;
+            req.setRequestID(numRequests + pass * lifecycles + i + 1);
+            req.setVehicleID(i + 1);
+            req.setRequestedZone((next_random(&seed) % numZones) + 1);
+            req.setRequestTime(numRequests + i);
+            system->addRequest(req);
+        }
+        totalNs = 0;
+        for (int i = 0; i < lifecycles; i++) {
+            Clock::time_point start = Clock::now();
+            system->allocateForRequest(firstIndex + i);
+            system->occupyRequest(firstIndex + i);
+            system->releaseRequest(firstIndex + i, 2 * numRequests + i);
+            samples[i] = elapsed_ns(start, Clock::now());
+            totalNs += samples[i];
+        }
+        // Journaled operations count once their group is on disk
+        Clock::time_point start = Clock::now();
+        if (pass == 1) {
+            journal.sync();
+        }
+        totalNs += elapsed_ns(start, Clock::now());
+        lifecycleSeconds[pass] = totalNs / 1e9;
+        report(pass == 0 ? "lifecycle" : "lifecycle_journaled", samples, lifecycles, totalNs, csv);
+    }
+    system->attachJournal(nullptr);
+    long long journalRecords = journal.getDurableSequence();
+    long long journalCommits = journal.getNumCommits();
+    journal.close();
+    std::remove("bench_journal.bin");
+    double journalOverhead = (lifecycleSeconds[0] > 0.0 && lifecycleSeconds[1] > 0.0)
+                                 ? 100.0 * (lifecycleSeconds[1] / lifecycleSeconds[0] - 1.0) : 0.0;
+    if (csv) {
+        std::cout << "# journal_records=" << journalRecords << ",journal_commits=" << journalCommits
+                  << ",journal_overhead_pct=" << journalOverhead << std::endl;
+    } else {
+        std::cout << "journal: " << journalRecords << " records in " << journalCommits
+                  << " group commits, overhead " << journalOverhead << "%" << std::endl;
+    }
+#endif
+
+    bool consistent = system->verifyCounters();
+#if defined(PARKING_HAS_SNAPSHOT)
+    // Snapshot round trip of the final state
+    Clock::time_point start = Clock::now();
+    bool saved = system->saveSnapshot("bench_snapshot.bin");
+    samples[0] = elapsed_ns(start, Clock::now());
+    report("snapshot_save", samples, 1, samples[0], csv);
+    start = Clock::now();
+    ParkingSystem* restored = saved ? ParkingSystem::loadSnapshot("bench_snapshot.bin") : nullptr;
+    samples[0] = elapsed_ns(start, Clock::now());
+    report("snapshot_load", samples, 1, samples[0], csv);
+    std::remove("bench_snapshot.bin");
+    consistent = consistent && restored != nullptr && restored->verifyCounters() &&
+                 restored->getAvailableSlots() == system->getAvailableSlots();
+    delete restored;
+#endif
+
+#if defined(PARKING_HAS_NEAREST) || defined(PARKING_HAS_SLOT_TYPES)
+    const int deckSide = 50;
+    const int deckLevels = 4;
+    const int deckSlots = deckSide * deckSide * deckLevels;
+    int sideQueries = (maxSamples < 100000) ? maxSamples : 100000;
+    ParkingSlot baySlot;
+    baySlot.setZoneID(1);
+    baySlot.setIsAvailable(true);
+#endif
+
+#if defined(PARKING_HAS_NEAREST)
+    // Nearest free slot on a 95%-occupied 10k-slot deck
+    ParkingArea deck(deckSlots);
+    for (int i = 0; i < deckSlots; i++) {
+        baySlot.setSlotID(i);
+        baySlot.setCoordinates((i % deckSide) * 5, ((i / deckSide) % deckSide) * 5, i / (deckSide * deckSide));
+        deck.addSlot(baySlot);
+    }
+    deck.buildSpatialIndex();
+    for (int taken = 0; taken < deckSlots * 95 / 100;) {
+        if (deck.occupySlot(static_cast<int>(next_random(&seed) % deckSlots))) {
+            taken++;
+        }
+    }
+    totalNs = 0;
+    for (int i = 0; i < sideQueries; i++) {
+        int x = static_cast<int>(next_random(&seed) % (deckSide * 5));
+        int y = static_cast<int>(next_random(&seed) % (deckSide * 5));
+        int level = static_cast<int>(next_random(&seed) % deckLevels);
+        Clock::time_point start = Clock::now();
+        checksum += deck.findNearestAvailableSlot(x, y, level);
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+    }
+    report("nearest", samples, sideQueries, totalNs, csv);
+#endif
+
+#if defined(PARKING_HAS_SLOT_TYPES)
+    // Typed claims on a 95%-occupied 10k-slot area with mixed slot types
+    ParkingArea mixed(deckSlots);
+    for (int i = 0; i < deckSlots; i++) {
+        int percent = i % 100;
+        baySlot.setSlotID(i);
+        baySlot.setSlotType(percent < 80 ? SLOT_STANDARD : percent < 90 ? SLOT_EV
+                            : percent < 95 ? SLOT_ACCESSIBLE : percent < 98 ? SLOT_COMPACT : SLOT_MOTORCYCLE);
+        mixed.addSlot(baySlot);
+    }
+    for (int taken = 0; taken < deckSlots * 95 / 100;) {
+        if (mixed.occupySlot(static_cast<int>(next_random(&seed) % deckSlots))) {
+            taken++;
+        }
+    }
+    mixed.findFirstAvailableSlotOfType(SLOT_STANDARD);  // Builds the per-type index
+    totalNs = 0;
+    for (int i = 0; i < sideQueries; i++) {
+        int type = static_cast<int>(next_random(&seed) % NUM_SLOT_TYPES);
+        Clock::time_point start = Clock::now();
+        int slotID = mixed.findFirstAvailableSlotOfType(type);
+        if (slotID != -1) {
+            mixed.occupySlot(slotID);
+        }
+        samples[i] = elapsed_ns(start, Clock::now());
+        totalNs += samples[i];
+        checksum += slotID;
+        if (slotID != -1) {
+            while (!mixed.freeSlot(static_cast<int>(next_random(&seed) % deckSlots))) {
+            }
+        }
+    }
+    report("typed_claim", samples, sideQueries, totalNs, csv);
+#endif
+
+#if defined(PARKING_INSTRUMENTATION)
+    if (!csv) {
+        system->dumpInstrumentation(std::cout);
+    }
+#endif
+
+    if (csv) {
+        std::cout << "# allocated=" << allocated << ",consistent=" << (consistent ? 1 : 0)
+                  << ",arena_bytes=" << system->getArena().getBytesReserved()
+                  << ",checksum=" << checksum << std::endl;
+    } else {
+        std::cout << "allocated " << allocated << "/" << numRequests << ", counters "
+                  << (consistent ? "consistent" : "INCONSISTENT") << ", arena "
+                  << system->getArena().getBytesUsed() / (1024 * 1024) << " MB used / "
+                  << system->getArena().getBytesReserved() / (1024 * 1024) << " MB reserved" << std::endl;
+    }
+
+    delete system;
+    delete[] slots;
+    delete[] samples;
+    return consistent ? 0 : 1;
+}
@@ -0,0 +1,316 @@
+#include <iostream>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include "AllocationEngine.h"
+
+// Allocation policy benchmark.
+// Runs every policy of AllocationPolicy.h on the same synthetic facility
+// (zones on a square grid, each adjacent to its four neighbours; in every
+// area the bays are laid out 25 to a row, 5 m apart, with the entrance at
+// 0, 0 in the middle of the first row) and the same request stream: 20% of
+// requests go to zone 1 (a corner), so it fills and spills over, the rest
+// to a uniformly random zone.
+//   fill   allocate until 90% of the slots are taken
+//   churn  free a random allocated slot, then allocate one more request
+//          (only the allocation is timed), at 90% occupancy
+// Throughput and latency cover the engine search alone (the engines are
+// driven directly, without ParkingSystem bookkeeping), so the numbers
+// compare policies rather than the full allocation path.
+// The nearest-slot policy builds each area's spatial index on its first
+// query, inside the fill timing.
+// Placement quality, over all allocations and the final occupancy:
+//   same_zone  share of allocations in the requested zone
+//   mean_hops  mean cross-zone penalty (hops)
+//   walk_m     mean distance from the area entrance to the occupied bays
+//   area_sd    standard deviation of area utilization (high = packed areas)
+//   zone_sd    standard deviation of zone utilization (low = balanced zones)
+//
+// Usage: bench_policies [--csv] [zones] [areasPerZone] [slotsPerArea] [churn]
+
+typedef std::chrono::steady_clock Clock;
+
+// Deterministic pseudo-random numbers (xorshift), so every policy sees the same stream
+unsigned int next_random(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+long long elapsed_ns(Clock::time_point start, Clock::time_point end) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+}
+
+// In-place heap sort of the latency samples (no STL algorithms)
+void sift_down(long long* values, int root, int count) {
+    long long value = values[root];
+    while (true) {
+        int child = 2 * root + 1;
+        if (child >= count) {
+            break;
+        }
+        if (child + 1 < count && values[child + 1] > values[child]) {
+            child++;
+        }
+        if (values[child] <= value) {
+            break;
+        }
+        values[root] = values[child];
+        root = child;
+    }
+    values[root] = value;
+}
+
+void sort_samples(long long* values, int count) {
+    for (int i = count / 2 - 1; i >= 0; i--) {
+        sift_down(values, i, count);
+    }
+    for (int end = count - 1; end > 0; end--) {
+        long long top = values[0];
+        values[0] = values[end];
+        values[end] = top;
+        sift_down(values, 0, end);
+    }
+}
+
+// Sample at a percentile of sorted samples (nearest rank)
+long long percentile(const long long* sorted, int count, double p) {
+    if (count == 0) {
+        return 0;
+    }
+    int rank = static_cast<int>(p / 100.0 * count + 0.999999);
+    if (rank < 1) {
+        rank = 1;
+    }
+    if (rank > count) {
+        rank = count;
+    }
+    return sorted[rank - 1];
+}
+
+// Standard deviation of count values
+double deviation(const double* values, int count) {
+    double mean = 0.0;
+    for (int i = 0; i < count; i++) {
+        mean += values[i];
+    }
+    mean /= count;
+    double variance = 0.0;
+    for (int i = 0; i < count; i++) {
+        variance += (values[i] - mean) * (values[i] - mean);
+    }
+    return std::sqrt(variance / count);
+}
+
+const int BAYS_PER_ROW = 25;
+const int BAY_SPACING = 5;
+
+// Bay position of an area offset, relative to the entrance
+int bay_x(int offset) {
+    return (offset % BAYS_PER_ROW - BAYS_PER_ROW / 2) * BAY_SPACING;
+}
+
+int bay_y(int offset) {
+    return (offset / BAYS_PER_ROW) * BAY_SPACING;
+}
+
+// Zones, areas and the engine's index/counters for one policy run
+struct Facility {
+    int numZones;
+    int numAreas;
+    int slotsPerArea;
+    Zone* zones;
+    ParkingArea* areas;
+    ZoneIndex index;
+    Analytics analytics;
+
+    Facility(int zoneCount, int areasPerZone, int slots) : analytics(&index) {
+        numZones = zoneCount;
+        numAreas = zoneCount * areasPerZone;
+        slotsPerArea = slots;
+        zones = new Zone[numZones];
+        areas = new ParkingArea[numAreas];
+        int side = 1;
+        while (side * side < numZones) {
+            side++;
+        }
+        for (int z = 0; z < numZones; z++) {
+            zones[z].setZoneID(z + 1);
+            if (z % side + 1 < side && z + 1 < numZones) {
+                zones[z].addAdjacentZone(z + 2);  // Right neighbour
+            }
+            if (z + side < numZones) {
+                zones[z].addAdjacentZone(z + side + 1);  // Neighbour below
+            }
+            index.addZone(z + 1);
+            analytics.onZoneRegistered(z + 1);
+        }
+        ParkingSlot slot;
+        slot.setIsAvailable(true);
+        for (int a = 0; a < numAreas; a++) {
+            int z = (a / areasPerZone) + 1;
+            areas[a] = ParkingArea(slotsPerArea);
+            areas[a].setAreaID(a + 1);
+            areas[a].setZoneID(z);
+            slot.setZoneID(z);
+            for (int i = 0; i < slotsPerArea; i++) {
+                slot.setSlotID(a * slotsPerArea + i);
+                slot.setCoordinates(bay_x(i), bay_y(i), 0);
+                areas[a].addSlot(slot);
+            }
+            index.addArea(z, a);
+            analytics.onSlotsAdded(z, SLOT_STANDARD, slotsPerArea, slotsPerArea);
+        }
+        index.rebuildDistances(zones, numZones);
+    }
+
+    ~Facility() {
+        delete[] zones;
+        delete[] areas;
+    }
+};
+
+// Run the fill and churn workloads with one policy and print its line
+template <typename Policy>
+void run_policy(int numZones, int areasPerZone, int slotsPerArea, int churn, long long* samples, bool csv) {
+    Facility facility(numZones, areasPerZone, slotsPerArea);
+    BasicAllocationEngine<Policy> engine(facility.areas, &facility.index, &facility.analytics);
+    int totalSlots = facility.numAreas * slotsPerArea;
+    int fill = totalSlots * 9 / 10;
+    int* heldAreas = new int[fill];  // Allocated (area, slot) pairs, for churn
+    int* heldSlots = new int[fill];
+    unsigned int seed = 12345;
+    long long sameZone = 0;
+    long long hops = 0;
+    double walk = 0.0;
+
+    // Fill to 90%, then churn at that level; both phases are timed per call
+    long long fillNs = 0;
+    long long churnNs = 0;
+    int allocations = fill + churn;
+    for (int n = 0; n < allocations; n++) {
+        int held = (n < fill) ? n : fill - 1;
+        if (n >= fill) {
+            // Free a random allocated slot and reuse its place in the held arrays
+            int victim = static_cast<int>(next_random(&seed) % fill);
+            ParkingArea& area = facility.areas[heldAreas[victim]];
+            area.freeSlot(heldSlots[victim]);
+            facility.analytics.onSlotFreed(area.getZoneID(), SLOT_STANDARD);
+            heldAreas[victim] = heldAreas[held];
+            heldSlots[victim] = heldSlots[held];
+        }
+        int zone = (next_random(&seed) % 5 == 0) ? 1 : static_cast<int>(next_random(&seed) % numZones) + 1;
+        Clock::time_point start = Clock::now();
+        int slotID = engine.allocateSlot(n + 1, zone, facility.numAreas);
+        samples[n] = elapsed_ns(start, Clock::now());
+        if (n < fill) {
+            fillNs += samples[n];
+        } else {
+            churnNs += samples[n];
+        }
+        if (slotID == -1) {
+            continue;  // Cannot happen below 100% occupancy
+        }
+        heldAreas[held] = engine.getLastAllocatedArea();
+        heldSlots[held] = slotID;
+        sameZone += engine.hasPenalty() ? 0 : 1;
+        hops += engine.getPenaltyHops();
+    }
+    for (int h = 0; h < fill; h++) {
+        int offset = heldSlots[h] - heldAreas[h] * slotsPerArea;
+        double x = bay_x(offset);
+        double y = bay_y(offset);
+        walk += std::sqrt(x * x + y * y);
+    }
+
+    double* areaUse = new double[facility.numAreas];
+    for (int a = 0; a < facility.numAreas; a++) {
+        areaUse[a] = 1.0 - static_cast<double>(facility.areas[a].getAvailableSlots()) / slotsPerArea;
+    }
+    double* zoneUse = new double[numZones];
+    for (int z = 0; z < numZones; z++) {
+        zoneUse[z] = facility.analytics.getZoneUtilization(z + 1) / 100.0;
+    }
+
+    const char* name = Policy::name();
+    for (int phase = 0; phase < 2; phase++) {
+        long long* phaseSamples = samples + (phase == 0 ? 0 : fill);
+        int count = (phase == 0) ? fill : churn;
+        long long totalNs = (phase == 0) ? fillNs : churnNs;
+        sort_samples(phaseSamples, count);
+        long long opsPerSec = (totalNs > 0) ? static_cast<long long>(count / (totalNs / 1e9)) : 0;
+        const char* workload = (phase == 0) ? "fill" : "churn";
+        if (csv) {
+            std::cout << name << "," << workload << "," << count << "," << opsPerSec << ","
+                      << percentile(phaseSamples, count, 50.0) << "," << percentile(phaseSamples, count, 99.0) << ","
+                      << percentile(phaseSamples, count, 99.9);
+        } else {
+            std::cout << name << "\t" << workload << "\t" << count << "\t" << opsPerSec << "\t"
+                      << percentile(phaseSamples, count, 50.0) << "\t" << percentile(phaseSamples, count, 99.0) << "\t"
+                      << percentile(phaseSamples, count, 99.9);
+        }
+        if (phase == 0) {
+            std::cout << std::endl;
+            continue;
+        }
+        // Placement quality is reported once per policy, on the churn line
+        const char* sep = csv ? "," : "\t";
+        std::cout.precision(3);
+        std::cout << sep << static_cast<double>(sameZone) / allocations << sep
+                  << static_cast<double>(hops) / allocations << sep << walk / fill << sep
+                  << deviation(areaUse, facility.numAreas) << sep << deviation(zoneUse, numZones) << std::endl;
+        std::cout.precision(6);
+    }
+
+    delete[] heldAreas;
+    delete[] heldSlots;
+    delete[] areaUse;
+    delete[] zoneUse;
+}
+
+int main(int argc, char* argv[]) {
+    bool csv = false;
+    int values[4] = {100, 10, 200, 200000};  // zones, areas/zone, slots/area, churn operations
+    int numValues = 0;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--csv") == 0) {
+            csv = true;
+        } else if (numValues < 4) {
+            values[numValues++] = std::atoi(argv[i]);
+        }
+    }
+    int numZones = values[0];
+    int areasPerZone = values[1];
+    int slotsPerArea = values[2];
+    int churn = values[3];
+    if (numZones <= 0 || areasPerZone <= 0 || slotsPerArea <= 0 || churn < 0) {
+        std::cerr << "Usage: bench_policies [--csv] [zones] [areasPerZone] [slotsPerArea] [churn]" << std::endl;
+        return 1;
+    }
+    int fill = numZones * areasPerZone * slotsPerArea * 9 / 10;
+    long long* samples = new long long[fill + churn];
+
+    if (csv) {
+        std::cout << "# zones=" << numZones << ",areas_per_zone=" << areasPerZone
+                  << ",slots_per_area=" << slotsPerArea << ",churn=" << churn << std::endl;
+        std::cout << "policy,workload,ops,ops_per_sec,p50_ns,p99_ns,p999_ns,same_zone,mean_hops,walk_m,area_sd,zone_sd"
+                  << std::endl;
+    } else {
+        std::cout << "Policy benchmark: " << numZones << " zones, " << areasPerZone << " areas/zone, "
+                  << slotsPerArea << " slots/area, fill to 90% then " << churn << " churn operations" << std::endl;
+        std::cout << "policy\tworkload\tops\tops/sec\tp50_ns\tp99_ns\tp999_ns\tsame_zone\tmean_hops\twalk_m\tarea_sd\tzone_sd"
+                  << std::endl;
+    }
+    run_policy<FirstFitPolicy>(numZones, areasPerZone, slotsPerArea, churn, samples, csv);
+    run_policy<BestFitPolicy>(numZones, areasPerZone, slotsPerArea, churn, samples, csv);
+    run_policy<RoundRobinPolicy>(numZones, areasPerZone, slotsPerArea, churn, samples, csv);
+    run_policy<NearestSlotPolicy>(numZones, areasPerZone, slotsPerArea, churn, samples, csv);
+    run_policy<LeastUtilizedZonePolicy>(numZones, areasPerZone, slotsPerArea, churn, samples, csv);
+
+    delete[] samples;
+    return 0;
+}
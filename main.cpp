@@ -21,6 +21,7 @@ int main() {
     // Add zone adjacency
     zone1.addAdjacentZone(2);
     zone2.addAdjacentZone(1);
+    system.addZoneAdjacency(1, 2);
 
     // Create and add a parking area
     ParkingArea area1(3);
@@ -0,0 +1,128 @@
+#include <iostream>
+#include <cstdlib>
+#include <cstring>
+#include "ParkingSystem.h"
+#include "EventLog.h"
+#include "EventReplayer.h"
+
+// Event-log replay tool.
+//   replay_events --generate <log> [requests]
+//       Write a synthetic day of gate events: every request is allocated on
+//       arrival; WINDOW requests later one in ten is cancelled and the rest
+//       occupy their slot, and after another WINDOW requests they leave.
+//       Every 1000th allocation is rolled back.
+//   replay_events [--stream] <log> [zones] [areasPerZone] [slotsPerArea]
+//       Build a facility (zones in a line) and replay the log through it,
+//       memory-mapped unless --stream is given. Reports events per second.
+
+static const int WINDOW = 20000;  // Requests between arrival, occupy and release
+
+int generate(const char* path, int numRequests) {
+    EventLogWriter writer;
+    if (!writer.open(path)) {
+        std::cerr << "Cannot create " << path << std::endl;
+        return 1;
+    }
+    unsigned int seed = 12345;
+    for (int t = 0; t < numRequests + 2 * WINDOW; t++) {
+        if (t < numRequests) {
+            seed = seed * 1103515245u + 12345u;
+            writer.logRequest(t + 1, t + 1, static_cast<int>((seed >> 16) % 100) + 1, t);
+            writer.logAllocate(t, t);
+            if (t % 1000 == 999) {
+                writer.logRollback(1, t);
+            }
+        }
+        int arriving = t - WINDOW;
+        if (arriving >= 0 && arriving < numRequests) {
+            if (arriving % 10 == 0) {
+                writer.logCancel(arriving, t);
+            } else {
+                writer.logOccupy(arriving, t);
+            }
+        }
+        int leaving = t - 2 * WINDOW;
+        if (leaving >= 0 && leaving < numRequests && leaving % 10 != 0) {
+            writer.logRelease(leaving, t);
+        }
+    }
+    long long written = writer.getNumWritten();
+    if (!writer.close()) {
+        std::cerr << "Write to " << path << " failed" << std::endl;
+        return 1;
+    }
+    std::cout << "Wrote " << written << " events for " << numRequests << " requests to " << path << std::endl;
+    return 0;
+}
+
+int replay(const char* path, bool mapped, int numZones, int areasPerZone, int slotsPerArea) {
+    EventLogReader reader(mapped);
+    if (!reader.open(path)) {
+        std::cerr << "Cannot read event log " << path << std::endl;
+        return 1;
+    }
+
+    // Size the request array from the log, so replay does not have to grow it
+    int numAreas = numZones * areasPerZone;
+    int maxRequests = static_cast<int>(reader.getNumRecords() / 2 + 1);
+    ParkingSystem* system = new ParkingSystem(numZones, 1, maxRequests, numAreas, 1000);
+    ParkingSlot* slots = new ParkingSlot[slotsPerArea];
+    for (int z = 1; z <= numZones; z++) {
+        system->emplaceZone(z, "Zone");
+        if (z > 1) {
+            system->addZoneAdjacency(z - 1, z);
+        }
+    }
+    for (int a = 0; a < numAreas; a++) {
+        int z = (a / areasPerZone) + 1;
+        for (int i = 0; i < slotsPerArea; i++) {
+            slots[i].setSlotID(a * slotsPerArea + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(true);
+        }
+        system->emplaceArea(a + 1, z, slots, slotsPerArea);
+    }
+    delete[] slots;
+
+    EventReplayer replayer(system);
+    ReplayStats stats = replayer.replay(reader);
+    double rate = (stats.seconds > 0.0) ? stats.events / stats.seconds : 0.0;
+    std::cout << "Replayed " << stats.events << " events (" << (reader.isMapped() ? "mapped" : "streamed")
+              << ") in " << stats.seconds << " s: " << static_cast<long long>(rate) << " events/sec" << std::endl;
+    std::cout << "applied " << stats.applied << ", rejected " << stats.rejected
+              << ", invalid " << stats.invalid << "; " << system->getActiveRequests()
+              << " active requests, " << system->getAvailableSlots() << "/"
+              << system->getTotalSlots() << " slots free" << std::endl;
+    if (stats.rejected > 0) {
+        system->exportTransitionErrors(std::cout);
+    }
+    bool consistent = system->verifyCounters();
+    delete system;
+    return consistent ? 0 : 1;
+}
+
+int main(int argc, char* argv[]) {
+    if (argc >= 3 && std::strcmp(argv[1], "--generate") == 0) {
+        return generate(argv[2], argc > 3 ? std::atoi(argv[3]) : 1000000);
+    }
+    bool mapped = true;
+    int arg = 1;
+    if (arg < argc && std::strcmp(argv[arg], "--stream") == 0) {
+        mapped = false;
+        arg++;
+    }
+    if (arg >= argc) {
+        std::cerr << "Usage: replay_events --generate <log> [requests]" << std::endl;
+        std::cerr << "       replay_events [--stream] <log> [zones] [areasPerZone] [slotsPerArea]" << std::endl;
+        return 1;
+    }
+    const char* path = argv[arg];
+    int numZones = (arg + 1 < argc) ? std::atoi(argv[arg + 1]) : 100;
+    int areasPerZone = (arg + 2 < argc) ? std::atoi(argv[arg + 2]) : 10;
+    int slotsPerArea = (arg + 3 < argc) ? std::atoi(argv[arg + 3]) : 100;
+    if (numZones <= 0 || areasPerZone <= 0 || slotsPerArea <= 0) {
+        std::cerr << "Facility sizes must be positive" << std::endl;
+        return 1;
+    }
+    return replay(path, mapped, numZones, areasPerZone, slotsPerArea);
+}
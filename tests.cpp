@@ -1,6 +1,15 @@
 #include <iostream>
 #include <cassert>
+#include <thread>
+#include <atomic>
+#include <cstring>
+#include <utility>
+#include <cstdio>
+#include <sstream>
 #include "ParkingSystem.h"
+#include "Snapshot.h"
+#include "EventLog.h"
+#include "EventReplayer.h"
 
 class TestTracker {
 private:
@@ -642,11 +651,2230 @@ void test_15_parking_duration() {
     test_assert(test15_released, "Request in RELEASED state");
 }
 
+void test_16_zone_indexed_allocation() {
+    std::cout << "\n=== TEST 16: Zone-Indexed Allocation ===" << std::endl;
+
+    ParkingSystem system(3, 5, 5, 4, 10);
+
+    // Areas of different zones are interleaved in the areas array
+    int zoneOrder[3] = {2, 1, 2};
+    for (int a = 0; a < 3; a++) {
+        ParkingArea area(1);
+        area.setAreaID(a + 1);
+        area.setZoneID(zoneOrder[a]);
+        ParkingSlot slot;
+        slot.setSlotID(zoneOrder[a] * 100 + a);
+        slot.setZoneID(zoneOrder[a]);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);
+        system.addArea(area);
+    }
+
+    for (int i = 0; i < 3; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(100 + i);
+        system.addRequest(req);
+    }
+
+    int first = system.allocateForRequest(0);
+    int second = system.allocateForRequest(1);
+    int third = system.allocateForRequest(2);
+
+    test_assert(first == 101, "Preferred zone found through zone index");
+    test_assert(second == 200 && third == 202, "Fallback visits other zone's areas in order");
+    test_assert(system.getZoneUtilization(2) == 100.0, "Zone utilization uses zone index");
+
+    // Zone IDs far apart: the zone maps hash them instead of spanning the range
+    ParkingSystem sparse(2, 1, 2, 2, 10);
+    int zoneIDs[2] = {1, 1500000000};
+    for (int z = 0; z < 2; z++) {
+        sparse.emplaceZone(zoneIDs[z], "Sparse");
+        ParkingSlot slot;
+        slot.setSlotID(10 + z);
+        slot.setZoneID(zoneIDs[z]);
+        slot.setIsAvailable(true);
+        sparse.emplaceArea(z + 1, zoneIDs[z], &slot, 1);
+    }
+    for (int i = 0; i < 2; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1500000000);
+        req.setRequestTime(100 + i);
+        sparse.addRequest(req);
+    }
+    bool sameZone = sparse.allocateForRequest(0) == 11 && sparse.getLastAllocationPenalty() == 0;
+    bool fallback = sparse.allocateForRequest(1) == 10 && sparse.getLastAllocationPenalty() > 0;
+    test_assert(sparse.getZone(1500000000) != nullptr && sparse.getZone(1) != nullptr && sparse.getZone(2) == nullptr,
+                "Zone IDs 1 and 1500000000 registered");
+    test_assert(sameZone && fallback && sparse.getZoneUtilization(1500000000) == 100.0,
+                "Allocation through sparse zone IDs");
+
+    // The index itself: dense IDs stay direct, sparse ones hash, removal
+    // keeps every other ID reachable
+    IdIndex dense;
+    for (int id = 500; id < 1500; id++) {
+        dense.set(id, id - 500);
+    }
+    IdIndex hashed;
+    for (int i = 0; i < 1000; i++) {
+        hashed.set(i * 2000003 - 1000000000, i);
+    }
+    for (int i = 0; i < 1000; i += 3) {
+        hashed.remove(i * 2000003 - 1000000000);
+    }
+    bool found = true;
+    for (int i = 0; i < 1000; i++) {
+        int expected = (i % 3 == 0) ? -1 : i;
+        found = found && hashed.find(i * 2000003 - 1000000000) == expected;
+    }
+    test_assert(!dense.isHashed() && dense.find(1499) == 999 && dense.find(1500) == -1,
+                "Dense IDs use the direct table");
+    test_assert(hashed.isHashed() && found && hashed.find(7) == -1, "Sparse IDs hash, removal keeps probe runs intact");
+}
+
+void test_17_availability_bitmap() {
+    std::cout << "\n=== TEST 17: Availability Bitmap ===" << std::endl;
+
+    // 130 slots span three 64-bit bitmap words
+    ParkingArea area(130);
+    area.setAreaID(1);
+    area.setZoneID(1);
+    for (int i = 0; i < 130; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(1000 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(i >= 70);  // First 70 slots start occupied
+        area.addSlot(slot);
+    }
+
+    bool firstFree = (area.findFirstAvailableSlot() == 1070);
+    bool countStart = (area.getAvailableSlots() == 60);
+
+    area.freeSlot(1003);
+    bool freedLowWord = (area.findFirstAvailableSlot() == 1003);
+
+    bool secondOccupy = area.occupySlot(1003) && !area.occupySlot(1003);
+    bool countAfter = (area.getAvailableSlots() == 60);
+
+    for (int i = 70; i < 130; i++) {
+        area.occupySlot(1000 + i);
+    }
+    bool full = (area.findFirstAvailableSlot() == -1 && area.getAvailableSlots() == 0);
+
+    test_assert(firstFree, "First free slot found across bitmap words");
+    test_assert(countStart, "Free counter initialised from slot states");
+    test_assert(freedLowWord, "Freed slot visible in bitmap");
+    test_assert(secondOccupy && countAfter, "Double occupy rejected, counter consistent");
+    test_assert(full, "Full area reports no free slot");
+}
+
+void test_18_sparse_slot_ids() {
+    std::cout << "\n=== TEST 18: Sparse Slot ID Lookup ===" << std::endl;
+
+    ParkingArea area(4);
+    area.setAreaID(1);
+    area.setZoneID(1);
+    Zone zone(4);
+    zone.setZoneID(1);
+
+    int ids[4] = {201, 101, 102, 5000};
+    for (int i = 0; i < 4; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(ids[i]);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);
+        zone.addSlot(slot);
+    }
+
+    bool occupied = area.occupySlot(101) && !area.isSlotAvailable(101);
+    bool othersFree = area.isSlotAvailable(201) && area.isSlotAvailable(102) && area.isSlotAvailable(5000);
+    bool unknown = !area.occupySlot(150) && !area.freeSlot(99) && !zone.isSlotAvailable(150);
+    bool freed = area.freeSlot(101) && area.isSlotAvailable(101);
+    bool zoneLookup = zone.isSlotAvailable(5000) && zone.isSlotAvailable(101);
+
+    test_assert(occupied, "Occupy by sparse slot ID");
+    test_assert(othersFree, "Other slots unaffected");
+    test_assert(unknown, "Unknown slot IDs rejected");
+    test_assert(freed, "Free by sparse slot ID");
+    test_assert(zoneLookup, "Zone slot lookup by ID");
+
+    // Slot IDs far apart in one area (and its zone) must not size the index
+    // by the raw ID range
+    ParkingArea wide(2);
+    wide.setAreaID(2);
+    wide.setZoneID(1);
+    Zone wideZone(2);
+    wideZone.setZoneID(1);
+    int wideIDs[3] = {1, 1500000000, -2000000000};
+    for (int i = 0; i < 3; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(wideIDs[i]);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        wide.addSlot(slot);
+        wideZone.addSlot(slot);
+    }
+    bool wideOccupy = wide.occupySlot(1500000000) && !wide.isSlotAvailable(1500000000) && wide.isSlotAvailable(1) &&
+                      wide.isSlotAvailable(-2000000000);
+    bool wideUnknown = !wide.occupySlot(2) && !wide.freeSlot(1499999999) && !wideZone.isSlotAvailable(2);
+    test_assert(wideOccupy && wideUnknown && wide.findFirstAvailableSlot() == 1 && wide.freeSlot(1500000000),
+                "Slot IDs 1, 1500000000 and -2000000000 in one area");
+    test_assert(wideZone.isSlotAvailable(1500000000) && wideZone.isSlotAvailable(-2000000000),
+                "Zone lookup of widely spread slot IDs");
+}
+
+void test_19_adjacency_ordered_fallback() {
+    std::cout << "\n=== TEST 19: Adjacency-Ordered Fallback ===" << std::endl;
+
+    // Chain of zones 1 - 2 - 3 - 4, with zone 4's area added first
+    ParkingSystem system(4, 5, 5, 4, 10);
+    for (int z = 1; z <= 4; z++) {
+        Zone zone;
+        zone.setZoneID(z);
+        system.addZone(zone);
+    }
+    system.addZoneAdjacency(1, 2);
+    system.addZoneAdjacency(2, 3);
+    system.addZoneAdjacency(3, 4);
+
+    int areaZones[4] = {4, 3, 2, 1};
+    for (int a = 0; a < 4; a++) {
+        ParkingArea area(1);
+        area.setAreaID(a + 1);
+        area.setZoneID(areaZones[a]);
+        ParkingSlot slot;
+        slot.setSlotID(areaZones[a] * 100 + 1);
+        slot.setZoneID(areaZones[a]);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);
+        system.addArea(area);
+    }
+
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(100 + i);
+        system.addRequest(req);
+    }
+
+    int s0 = system.allocateForRequest(0);
+    int p0 = system.getLastAllocationPenalty();
+    int s1 = system.allocateForRequest(1);
+    int p1 = system.getLastAllocationPenalty();
+    int s2 = system.allocateForRequest(2);
+    int p2 = system.getLastAllocationPenalty();
+    int s3 = system.allocateForRequest(3);
+    int p3 = system.getLastAllocationPenalty();
+
+    test_assert(s0 == 101 && p0 == 0, "Same zone first, no penalty");
+    test_assert(s1 == 201 && p1 == 1, "Nearest adjacent zone next (1 hop)");
+    test_assert(s2 == 301 && p2 == 2, "Then 2 hops away");
+    test_assert(s3 == 401 && p3 == 3, "Farthest zone last (3 hops)");
+}
+
+void test_20_running_counters() {
+    std::cout << "\n=== TEST 20: Running Analytics Counters ===" << std::endl;
+
+    ParkingSystem system(2, 5, 5, 2, 10);
+
+    Zone zone1;
+    zone1.setZoneID(1);
+    system.addZone(zone1);
+
+    ParkingArea area1(4);
+    area1.setAreaID(1);
+    area1.setZoneID(1);
+    for (int i = 0; i < 4; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(101 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        area1.addSlot(slot);
+    }
+    system.addArea(area1);
+
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(100 + i);
+        system.addRequest(req);
+    }
+
+    system.allocateForRequest(0);
+    system.allocateForRequest(1);
+    system.allocateForRequest(2);
+    bool occupied = system.occupyRequest(0);
+    bool released = system.releaseRequest(0, 110);
+    bool cancelled = system.cancelRequest(1);
+    bool badRelease = !system.releaseRequest(2, 120);  // Still ALLOCATED
+    system.rollbackLast();                             // Cancels request 3
+
+    test_assert(occupied && released && cancelled && badRelease, "Lifecycle transitions through the system");
+    test_assert(system.getAvailableSlots() == 4 && system.getTotalSlots() == 4, "Slots freed on release, cancel and rollback");
+    test_assert(system.getCompletedRequests() == 1 && system.getCancelledRequests() == 2, "Completed and cancelled counters");
+    test_assert(system.getActiveRequests() == 1, "Active counter (one REQUESTED left)");
+    test_assert(system.verifyCounters(), "Counters match a full recount");
+}
+
+void test_21_peak_zone_heap() {
+    std::cout << "\n=== TEST 21: Peak Zone Heap and Top-K ===" << std::endl;
+
+    ParkingSystem system(3, 10, 10, 3, 20);
+    for (int z = 1; z <= 3; z++) {
+        Zone zone;
+        zone.setZoneID(z);
+        system.addZone(zone);
+
+        ParkingArea area(4);
+        area.setAreaID(z);
+        area.setZoneID(z);
+        for (int i = 0; i < 4; i++) {
+            ParkingSlot slot;
+            slot.setSlotID(z * 100 + i);
+            slot.setZoneID(z);
+            slot.setIsAvailable(true);
+            area.addSlot(slot);
+        }
+        system.addArea(area);
+    }
+
+    bool tieAtStart = (system.getPeakUsageZone() == 1);  // All zones at 0%
+
+    // Zone 3: 3 of 4 occupied, zone 2: 1 of 4, zone 1: empty
+    int zoneOfRequest[4] = {3, 3, 3, 2};
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(zoneOfRequest[i]);
+        req.setRequestTime(100 + i);
+        system.addRequest(req);
+        system.allocateForRequest(i);
+    }
+
+    int top[3] = {0, 0, 0};
+    int count = system.getTopUsageZones(3, top);
+    bool peakFirst = (system.getPeakUsageZone() == 3);
+    bool topOrder = (count == 3 && top[0] == 3 && top[1] == 2 && top[2] == 1);
+
+    system.rollbackLastK(4);  // Back to all zones at 0%
+    bool tieToEarlier = tieAtStart && (system.getPeakUsageZone() == 1);
+
+    test_assert(peakFirst, "Peak zone read from heap top");
+    test_assert(topOrder, "Top-K zones in utilization order");
+    test_assert(tieToEarlier, "Ties resolved to the zone added first");
+    test_assert(system.verifyCounters(), "Per-zone counters match a full recount");
+}
+
+// Builds three zones (1 - 2 - 3 chain) with two small areas each
+void build_batch_facility(ParkingSystem& system) {
+    for (int z = 1; z <= 3; z++) {
+        Zone zone;
+        zone.setZoneID(z);
+        system.addZone(zone);
+    }
+    system.addZoneAdjacency(1, 2);
+    system.addZoneAdjacency(2, 3);
+    for (int a = 0; a < 6; a++) {
+        int z = (a % 3) + 1;
+        ParkingArea area(2);
+        area.setAreaID(a + 1);
+        area.setZoneID(z);
+        for (int i = 0; i < 2; i++) {
+            ParkingSlot slot;
+            slot.setSlotID(z * 100 + a * 10 + i);
+            slot.setZoneID(z);
+            slot.setIsAvailable(true);
+            area.addSlot(slot);
+        }
+        system.addArea(area);
+    }
+    int zoneOfRequest[10] = {1, 2, 1, 3, 1, 1, 2, 1, 3, 3};
+    for (int i = 0; i < 10; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(zoneOfRequest[i]);
+        req.setRequestTime(100 + i);
+        system.addRequest(req);
+    }
+}
+
+void test_22_batch_allocation() {
+    std::cout << "\n=== TEST 22: Batch Allocation ===" << std::endl;
+
+    ParkingSystem sequential(3, 10, 10, 6, 20);
+    ParkingSystem batched(3, 10, 10, 6, 20);
+    build_batch_facility(sequential);
+    build_batch_facility(batched);
+
+    // Zone 1 gets 5 requests for 4 slots, so the batch overflows mid-way
+    int indices[11] = {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 42};
+    int expected[11];
+    bool expectedPenalty[11];
+    for (int i = 0; i < 11; i++) {
+        expected[i] = sequential.allocateForRequest(indices[i]);
+        expectedPenalty[i] = (expected[i] != -1 && sequential.getLastAllocationPenalty() > 0);
+    }
+
+    int slots[11];
+    bool penalties[11];
+    int allocated = batched.allocateBatch(indices, 11, slots, penalties);
+
+    bool same = true;
+    for (int i = 0; i < 11; i++) {
+        if (slots[i] != expected[i] || penalties[i] != expectedPenalty[i]) {
+            same = false;
+        }
+    }
+
+    batched.rollbackLastK(3);
+    sequential.rollbackLastK(3);
+
+    test_assert(allocated == 10 && slots[10] == -1, "Batch allocates every valid request");
+    test_assert(same, "Batch results match sequential allocation");
+    test_assert(penalties[7], "Overflowing request falls back across zones");
+    test_assert(batched.getAvailableSlots() == sequential.getAvailableSlots() &&
+                batched.getCancelledRequests() == 3, "Batch rollback records in allocation order");
+    test_assert(batched.verifyCounters(), "Counters consistent after batch");
+
+    // A request repeated in one batch is allocated once, like sequential calls
+    ParkingSystem repeatSequential(3, 10, 10, 6, 20);
+    ParkingSystem repeatBatched(3, 10, 10, 6, 20);
+    build_batch_facility(repeatSequential);
+    build_batch_facility(repeatBatched);
+    int repeated[4] = {0, 0, 2, 0};
+    int repeatExpected[4];
+    for (int i = 0; i < 4; i++) {
+        repeatExpected[i] = repeatSequential.allocateForRequest(repeated[i]);
+    }
+    int repeatSlots[4];
+    bool repeatPenalties[4];
+    int repeatAllocated = repeatBatched.allocateBatch(repeated, 4, repeatSlots, repeatPenalties);
+    bool repeatSame = true;
+    for (int i = 0; i < 4; i++) {
+        repeatSame = repeatSame && repeatSlots[i] == repeatExpected[i];
+    }
+    test_assert(repeatAllocated == 2 && repeatSame && repeatSlots[1] == -1 && repeatSlots[3] == -1,
+                "Repeated request index allocated once, as sequentially");
+    test_assert(repeatBatched.getAvailableSlots() == repeatSequential.getAvailableSlots() &&
+                repeatBatched.getRollbackHistorySize() == 2 &&
+                repeatBatched.getTransitionErrors(ParkingRequest::ALLOCATE, ParkingRequest::ALLOCATED) == 2 &&
+                repeatBatched.verifyCounters(),
+                "Repeated index takes no extra slot, rollback record or counter");
+}
+
+void allocate_range(ParkingSystem* system, int first, int count, int* outSlotIDs) {
+    for (int i = 0; i < count; i++) {
+        outSlotIDs[first + i] = system->allocateForRequest(first + i);
+    }
+}
+
+// Same, raising started once the first request is allocated, so another
+// thread can overlap the rest
+void allocate_range_signal(ParkingSystem* system, int first, int count, int* outSlotIDs,
+                           std::atomic<bool>* started) {
+    for (int i = 0; i < count; i++) {
+        outSlotIDs[first + i] = system->allocateForRequest(first + i);
+        started->store(true);
+    }
+}
+
+// Repeated nearest-free-slot queries on one area
+void nearest_queries(ParkingSystem* system, int areaIndex) {
+    for (int i = 0; i < 200; i++) {
+        system->findNearestFreeSlot(areaIndex, i % 8, 0, 0);
+    }
+}
+
+// Toggle every other position of a 64-position range (the even ones or the
+// odd ones), leaving them free
+void toggle_positions(SlotStore* store, int parity) {
+    for (int round = 0; round < 2000; round++) {
+        for (int p = parity; p < 64; p += 2) {
+            store->setFree(p, round % 2 == 1);
+        }
+    }
+}
+
+void test_23_concurrent_allocation() {
+    std::cout << "\n=== TEST 23: Concurrent Allocation ===" << std::endl;
+
+    // 4 zones in a line, 2 areas of 16 slots each: 128 slots, 160 requests
+    ParkingSystem system(4, 160, 160, 8, 200);
+    for (int z = 1; z <= 4; z++) {
+        Zone zone;
+        zone.setZoneID(z);
+        system.addZone(zone);
+    }
+    system.addZoneAdjacency(1, 2);
+    system.addZoneAdjacency(2, 3);
+    system.addZoneAdjacency(3, 4);
+    for (int a = 0; a < 8; a++) {
+        int z = (a % 4) + 1;
+        ParkingArea area(16);
+        area.setAreaID(a + 1);
+        area.setZoneID(z);
+        for (int i = 0; i < 16; i++) {
+            ParkingSlot slot;
+            slot.setSlotID(a * 100 + i);
+            slot.setZoneID(z);
+            slot.setIsAvailable(true);
+            area.addSlot(slot);
+        }
+        system.addArea(area);
+    }
+    for (int i = 0; i < 160; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone((i % 4) + 1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+    system.enableConcurrentAllocation();
+
+    // Each thread allocates a contiguous block of requests across all zones
+    int slots[160];
+    std::thread workers[4];
+    for (int t = 0; t < 4; t++) {
+        workers[t] = std::thread(allocate_range, &system, t * 40, 40, slots);
+    }
+    for (int t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+
+    int allocated = 0;
+    bool seen[800] = {false};
+    bool duplicate = false;
+    for (int i = 0; i < 160; i++) {
+        if (slots[i] != -1) {
+            allocated++;
+            duplicate = duplicate || seen[slots[i]];
+            seen[slots[i]] = true;
+        }
+    }
+
+    test_assert(allocated == 128 && system.getAvailableSlots() == 0,
+                "Every slot allocated exactly once under contention");
+    test_assert(!duplicate, "No slot handed to two requests");
+    test_assert(system.getZoneUtilization(1) == 100.0 && system.getZoneUtilization(4) == 100.0,
+                "Per-zone counters match allocations");
+    test_assert(system.verifyCounters(), "Counters consistent after concurrent allocation");
+
+    system.rollbackLastK(28);
+    test_assert(system.getAvailableSlots() == 28 && system.getCancelledRequests() == 28 &&
+                system.verifyCounters(), "Rollback works in concurrent mode");
+
+    // An ALLOCATED request cannot take a second slot
+    int holder = system.getFirstRequestInState(ParkingRequest::ALLOCATED);
+    int held = system.getRequest(holder)->getAllocatedSlotID();
+    int again = system.allocateForRequest(holder);
+    test_assert(again == -1 && system.getRequest(holder)->getAllocatedSlotID() == held &&
+                system.getAvailableSlots() == 28 && system.getRollbackHistorySize() == 100 &&
+                system.getTransitionErrors(ParkingRequest::ALLOCATE, ParkingRequest::ALLOCATED) == 1,
+                "Re-allocating an ALLOCATED request is rejected without claiming");
+
+    // Threads racing for the same requests: each request takes one slot
+    int raceSlots[4][160];
+    for (int t = 0; t < 4; t++) {
+        workers[t] = std::thread(allocate_range, &system, 0, 160, raceSlots[t]);
+    }
+    for (int t = 0; t < 4; t++) {
+        workers[t].join();
+    }
+    int won = 0;
+    bool once = true;
+    for (int i = 0; i < 160; i++) {
+        int winners = 0;
+        for (int t = 0; t < 4; t++) {
+            winners += (raceSlots[t][i] != -1) ? 1 : 0;
+        }
+        once = once && winners <= 1;
+        won += winners;
+    }
+    test_assert(once && won == 28 && system.getAvailableSlots() == 0 && system.getRollbackHistorySize() == 128 &&
+                system.verifyCounters(), "Racing allocations of one request take one slot");
+
+    // A batch racing concurrent allocations in the same zone, asking for more
+    // slots than are left, only hands out slots it actually claimed
+    bool batchValid = true;
+    for (int round = 0; round < 20 && batchValid; round++) {
+        ParkingSystem mixed(1, 1, 64, 2, 200);
+        mixed.emplaceZone(1, "Main");
+        ParkingSlot deck[16];
+        for (int a = 0; a < 2; a++) {
+            for (int i = 0; i < 16; i++) {
+                deck[i].setSlotID(1000 + a * 100 + i);
+                deck[i].setZoneID(1);
+                deck[i].setIsAvailable(true);
+            }
+            mixed.emplaceArea(a + 1, 1, deck, 16);
+        }
+        for (int i = 0; i < 64; i++) {
+            ParkingRequest req;
+            req.setRequestID(i + 1);
+            req.setVehicleID(i + 1);
+            req.setRequestedZone(1);
+            req.setRequestTime(i);
+            mixed.addRequest(req);
+        }
+        mixed.enableConcurrentAllocation();
+        int mixedSlots[64];
+        int batch[48];
+        bool penalties[48];
+        for (int i = 0; i < 48; i++) {
+            batch[i] = 16 + i;
+        }
+        std::atomic<bool> started(false);
+        std::thread single(allocate_range_signal, &mixed, 0, 16, mixedSlots, &started);
+        while (!started.load()) {
+            std::this_thread::yield();
+        }
+        mixed.allocateBatch(batch, 48, mixedSlots + 16, penalties);
+        single.join();
+        bool taken[2][16] = {{false}};
+        int held = 0;
+        for (int i = 0; i < 64; i++) {
+            const ParkingRequest* req = mixed.getRequest(i);
+            if (req->getState() != ParkingRequest::ALLOCATED) {
+                continue;
+            }
+            int a = (req->getAllocatedSlotID() - 1000) / 100;
+            int s = (req->getAllocatedSlotID() - 1000) % 100;
+            bool exists = req->getAllocatedSlotID() >= 1000 && a < 2 && s < 16 && req->getAllocatedArea() == a;
+            batchValid = batchValid && exists && !taken[a][s];
+            if (exists) {
+                taken[a][s] = true;
+            }
+            held++;
+        }
+        batchValid = batchValid && held == 32 && mixed.getAvailableSlots() == 0 && mixed.verifyCounters();
+    }
+    test_assert(batchValid, "Batch alongside concurrent allocation hands out only claimed slots");
+
+    // Typed searches in mixed-type areas of two zones at once: their
+    // indexes were built up front, so no search allocates from the arena
+    ParkingSystem typed(2, 1, 16, 2, 20);
+    ParkingSlot bays[8];
+    for (int z = 1; z <= 2; z++) {
+        typed.emplaceZone(z, "Typed");
+        for (int i = 0; i < 8; i++) {
+            bays[i].setSlotID(z * 100 + i);
+            bays[i].setZoneID(z);
+            bays[i].setIsAvailable(true);
+            bays[i].setSlotType(i < 2 ? SLOT_EV : SLOT_STANDARD);
+        }
+        typed.emplaceArea(z, z, bays, 8);
+    }
+    for (int i = 0; i < 16; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(i < 8 ? 1 : 2);
+        req.setRequestTime(i);
+        req.setVehicleClass(VEHICLE_EV);
+        typed.addRequest(req);
+    }
+    typed.enableConcurrentAllocation();
+    size_t usedBefore = typed.getArena().getBytesUsed();
+    int typedSlots[16];
+    std::thread zoneOne(allocate_range, &typed, 0, 8, typedSlots);
+    std::thread zoneTwo(allocate_range, &typed, 8, 8, typedSlots);
+    zoneOne.join();
+    zoneTwo.join();
+    test_assert(typed.getAvailableSlots() == 0 && typed.getAvailableSlotsByType(SLOT_EV) == 0 &&
+                typed.getArena().getBytesUsed() == usedBefore && typed.verifyCounters(),
+                "Concurrent typed searches do not allocate from the arena");
+
+    // Nearest-slot queries in two zones at once use the grids built up front
+    typed.rollbackLastK(16);
+    usedBefore = typed.getArena().getBytesUsed();
+    std::thread nearOne(nearest_queries, &typed, 0);
+    std::thread nearTwo(nearest_queries, &typed, 1);
+    nearOne.join();
+    nearTwo.join();
+    test_assert(typed.findNearestFreeSlot(1, 0, 0, 0) != -1 && typed.getArena().getBytesUsed() == usedBefore,
+                "Concurrent nearest-slot queries do not allocate from the arena");
+
+    // Packed ranges of different zones share bitmap words: two threads
+    // updating different bits of one word under different locks lose none
+    SlotStore store(64);
+    int low = store.reserve(32);
+    int high = store.reserve(32);
+    store.setShared(true);
+    std::thread even(toggle_positions, &store, 0);
+    std::thread odd(toggle_positions, &store, 1);
+    even.join();
+    odd.join();
+    test_assert(high == low + 32 && store.countFree(low, 64) == 64, "Shared bitmap words keep concurrent updates");
+}
+
+void test_24_rollback_request_position() {
+    std::cout << "\n=== TEST 24: Rollback By Request Position ===" << std::endl;
+
+    // Request IDs are deliberately unrelated to array positions, and one ID
+    // is reused, so rollback must follow the recorded position
+    ParkingSystem system(1, 10, 10, 1, 10);
+    Zone zone;
+    zone.setZoneID(1);
+    system.addZone(zone);
+    ParkingArea area(4);
+    area.setAreaID(1);
+    area.setZoneID(1);
+    for (int i = 0; i < 4; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(10 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);
+    }
+    system.addArea(area);
+    int ids[3] = {900, 7, 900};
+    for (int i = 0; i < 3; i++) {
+        ParkingRequest req;
+        req.setRequestID(ids[i]);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+
+    system.allocateForRequest(0);
+    system.allocateForRequest(1);
+    system.allocateForRequest(2);
+    system.occupyRequest(0);
+    system.rollbackLast();
+
+    // The third request (second with ID 900) is cancelled, not the first
+    test_assert(system.cancelRequest(2) == false, "Rolled-back request is cancelled");
+    test_assert(system.releaseRequest(0, 50), "Earlier request with the same ID untouched");
+    test_assert(system.getAvailableSlots() == 3 && system.verifyCounters(),
+                "Rollback frees the recorded slot");
+
+    // Rolling back an allocation the vehicle has already occupied leaves it
+    // parked: the slot is not handed out again
+    system.occupyRequest(1);
+    system.rollbackLast();
+    ParkingRequest late;
+    late.setRequestID(901);
+    late.setVehicleID(4);
+    late.setRequestedZone(1);
+    late.setRequestTime(3);
+    system.addRequest(late);
+    int lateSlot = system.allocateForRequest(3);
+    test_assert(lateSlot != -1 && lateSlot != 11 && system.getAvailableSlots() == 2,
+                "Rollback after occupy keeps the slot occupied");
+    test_assert(system.releaseRequest(1, 60) && system.verifyCounters(), "Occupied request untouched by rollback");
+
+    // A stale record: request 0 gave slot 10 up and request 1 holds it now,
+    // so undoing request 0's allocation must leave the slot alone
+    ZoneIndex index;
+    index.addZone(1);
+    Analytics stats(&index);
+    stats.onZoneRegistered(1);
+    ParkingArea lot(2);
+    lot.setAreaID(1);
+    lot.setZoneID(1);
+    for (int i = 0; i < 2; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(10 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        lot.addSlot(slot);
+    }
+    stats.onSlotsAdded(1, SLOT_STANDARD, 2, 2);
+    ParkingRequest held[2];
+    held[0].allocate();
+    held[0].occupy();
+    held[0].release();
+    held[1].allocate();
+    held[1].setAllocation(0, 10);
+    lot.occupySlot(10);
+    stats.onSlotOccupied(1, SLOT_STANDARD);
+    RollbackManager history(4, &stats);
+    history.recordAllocation(0, 10, 0);
+    history.undoLast(&lot, 1, held, 2);
+    test_assert(!lot.isSlotAvailable(10) && held[1].getAllocatedSlotID() == 10 && history.redoSize() == 0 &&
+                stats.getZoneAvailable(1) == 1, "Stale record leaves a slot held by another request");
+}
+
+void test_25_rollback_history_and_redo() {
+    std::cout << "\n=== TEST 25: Rollback History Eviction and Redo ===" << std::endl;
+
+    // History budget of 3 records for 5 allocations
+    ParkingSystem system(1, 10, 10, 1, 3);
+    Zone zone;
+    zone.setZoneID(1);
+    system.addZone(zone);
+    ParkingArea area(6);
+    area.setAreaID(1);
+    area.setZoneID(1);
+    for (int i = 0; i < 6; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);
+    }
+    system.addArea(area);
+    for (int i = 0; i < 6; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+    for (int i = 0; i < 5; i++) {
+        system.allocateForRequest(i);
+    }
+
+    test_assert(system.getRollbackHistorySize() == 3 && system.getRollbackEvictions() == 2,
+                "Oldest records evicted when history is full");
+
+    // Rolling back more than is kept only undoes the newest 3
+    system.rollbackLastK(10);
+    test_assert(system.getAvailableSlots() == 4 && system.getCancelledRequests() == 3,
+                "Rollback undoes only retained records");
+    test_assert(system.occupyRequest(1), "Evicted allocation stays in place");
+
+    // Redo replays the undone batch on the same slots
+    int redone = system.redoLastK(2);
+    test_assert(redone == 2 && system.getCancelledRequests() == 1 &&
+                system.getAvailableSlots() == 2, "Redo restores allocations in order");
+    test_assert(system.occupyRequest(3) && !system.occupyRequest(4),
+                "Redone requests are ALLOCATED again in original order");
+
+    // A new allocation takes the last undone slot and clears the redo history
+    int slot = system.allocateForRequest(5);
+    test_assert(slot == 4 && system.getRedoHistorySize() == 0 && system.redoLastK(1) == 0,
+                "New allocation clears redo history");
+    test_assert(system.verifyCounters(), "Counters consistent after redo");
+}
+
+void test_26_shared_slot_store() {
+    std::cout << "\n=== TEST 26: Shared Slot Store ===" << std::endl;
+
+    ParkingSystem system(2, 10, 10, 3, 10);
+
+    // Zone 2's area is added before zone 2 itself
+    ParkingArea early(3);
+    early.setAreaID(3);
+    early.setZoneID(2);
+    for (int i = 0; i < 3; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(300 + i);
+        slot.setZoneID(2);
+        slot.setIsAvailable(true);
+        early.addSlot(slot);
+    }
+    system.addArea(early);
+
+    Zone zone1;
+    zone1.setZoneID(1);
+    system.addZone(zone1);
+    Zone zone2;
+    zone2.setZoneID(2);
+    system.addZone(zone2);
+    for (int a = 0; a < 2; a++) {
+        ParkingArea area(2);
+        area.setAreaID(a + 1);
+        area.setZoneID(1);
+        for (int i = 0; i < 2; i++) {
+            ParkingSlot slot;
+            slot.setSlotID(100 + a * 10 + i);
+            slot.setZoneID(1);
+            slot.setIsAvailable(true);
+            area.addSlot(slot);
+        }
+        system.addArea(area);
+    }
+    for (int i = 0; i < 2; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+
+    const Zone* z1 = system.getZone(1);
+    const Zone* z2 = system.getZone(2);
+    test_assert(z1 != nullptr && z1->getNumSlots() == 4 && z2->getNumSlots() == 3,
+                "Zones view the slots of their areas");
+    test_assert(system.getZone(9) == nullptr, "Unknown zone not found");
+
+    int slot = system.allocateForRequest(0);
+    test_assert(slot == 100 && !z1->isSlotAvailable(100) && z1->getAvailableSlots() == 3,
+                "Zone sees allocation made through its area");
+    system.allocateForRequest(1);
+    system.rollbackLast();
+    test_assert(z1->isSlotAvailable(101) && z1->isAvailable() && z2->isSlotAvailable(302),
+                "Zone sees slot freed by rollback");
+
+    // A copied zone is a standalone snapshot with its own slots
+    Zone copy(*z1);
+    system.rollbackLast();
+    test_assert(copy.getNumSlots() == 4 && !copy.isSlotAvailable(100) && z1->isSlotAvailable(100),
+                "Zone copy owns its slots");
+}
+
+void test_27_emplace_and_move() {
+    std::cout << "\n=== TEST 27: In-Place and Move Registration ===" << std::endl;
+
+    ParkingSystem system(2, 10, 10, 3, 10);
+    int z1 = system.emplaceZone(1, "North Zone");
+    Zone south;
+    south.setZoneID(2);
+    south.setZoneName("South Zone");
+    system.addZone(std::move(south));
+    system.addZoneAdjacency(1, 2);
+
+    // Zone 1: one area built in place, zone 2: one area moved in
+    ParkingSlot slots[3];
+    for (int i = 0; i < 3; i++) {
+        slots[i].setSlotID(100 + i);
+        slots[i].setZoneID(1);
+        slots[i].setIsAvailable(i != 1);
+    }
+    int a0 = system.emplaceArea(1, 1, slots, 3);
+
+    ParkingArea moved(2);
+    moved.setAreaID(2);
+    moved.setZoneID(2);
+    for (int i = 0; i < 2; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(200 + i);
+        slot.setZoneID(2);
+        slot.setIsAvailable(true);
+        moved.addSlot(slot);
+    }
+    system.addArea(std::move(moved));
+
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+
+    test_assert(z1 == 0 && a0 == 0 && system.getZone(1)->getNumSlots() == 3 &&
+                strcmp(system.getZone(2)->getZoneName(), "South Zone") == 0,
+                "Zones and areas registered in place");
+    test_assert(moved.getNumSlots() == 0 && south.getNumAdjacentZones() == 0,
+                "Moved-from objects are left empty");
+    test_assert(system.getTotalSlots() == 5 && system.getAvailableSlots() == 4,
+                "Counters include emplaced and moved areas");
+
+    int s0 = system.allocateForRequest(0);
+    int s1 = system.allocateForRequest(1);
+    int s2 = system.allocateForRequest(2);
+    test_assert(s0 == 100 && s1 == 102 && s2 == 200 && system.getLastAllocationPenalty() == 1,
+                "Allocation uses emplaced slots, then falls back to moved area");
+    test_assert(system.verifyCounters(), "Counters consistent after in-place registration");
+
+    // Bulk configuration stays compact: 100k slots in 5000 emplaced areas
+    // take under 128 arena bytes per slot (columns, views, ID indexes and
+    // the area array included; padded ranges and abandoned generations
+    // used to take over 600)
+    ParkingSystem bulk(10, 1, 1, 1, 10);
+    for (int z = 1; z <= 10; z++) {
+        bulk.emplaceZone(z, "Bulk");
+    }
+    ParkingSlot bulkSlots[20];
+    for (int a = 0; a < 5000; a++) {
+        for (int i = 0; i < 20; i++) {
+            bulkSlots[i].setSlotID(a * 20 + i);
+            bulkSlots[i].setZoneID((a % 10) + 1);
+            bulkSlots[i].setIsAvailable(true);
+        }
+        bulk.emplaceArea(a + 1, (a % 10) + 1, bulkSlots, 20);
+    }
+    test_assert(bulk.getTotalSlots() == 100000 && bulk.getArena().getBytesReserved() <= 128 * 100000,
+                "Bulk configuration takes under 128 arena bytes per slot");
+}
+
+void test_28_arena_storage() {
+    std::cout << "\n=== TEST 28: Arena-Backed Storage ===" << std::endl;
+
+    // 20 zones x 10 areas x 50 slots, built with every registration path
+    ParkingSystem* system = new ParkingSystem(20, 100, 100, 200, 100);
+    for (int z = 1; z <= 20; z++) {
+        if (z % 2 == 0) {
+            system->emplaceZone(z, "Even");
+        } else {
+            Zone zone;
+            zone.setZoneID(z);
+            system->addZone(zone);
+        }
+    }
+    ParkingSlot slots[50];
+    for (int a = 0; a < 200; a++) {
+        int z = (a % 20) + 1;
+        for (int i = 0; i < 50; i++) {
+            slots[i].setSlotID(a * 100 + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(true);
+        }
+        if (a % 2 == 0) {
+            system->emplaceArea(a + 1, z, slots, 50);
+        } else {
+            ParkingArea area(50);
+            area.setAreaID(a + 1);
+            area.setZoneID(z);
+            for (int i = 0; i < 50; i++) {
+                area.addSlot(slots[i]);
+            }
+            system->addArea(area);
+        }
+    }
+    for (int i = 0; i < 100; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone((i % 20) + 1);
+        req.setRequestTime(i);
+        system->addRequest(req);
+        system->allocateForRequest(i);
+    }
+
+    const Arena& arena = system->getArena();
+    test_assert(arena.getNumChunks() <= 8, "Entity and slot storage come from a few chunks");
+    test_assert(arena.getBytesUsed() <= arena.getBytesReserved(), "Arena accounting consistent");
+    test_assert(system->getTotalSlots() == 10000 && system->getAvailableSlots() == 9900 &&
+                system->getZone(7)->getAvailableSlots() == 495, "Arena-backed views consistent");
+    test_assert(system->verifyCounters(), "Counters consistent with arena storage");
+    delete system;  // Teardown frees the arena chunks (checked by leak sanitizers)
+
+    // Released blocks are reused: a small one by the next request of its
+    // size class, a large one is freed at once
+    Arena scratch;
+    int* small = scratch.allocateArray<int>(20);
+    scratch.releaseArray(small, 20);
+    int* reused = scratch.allocateArray<int>(24);
+    size_t reserved = scratch.getBytesReserved();
+    long long* large = scratch.allocateArray<long long>(100000);
+    bool largeHeld = scratch.getBytesReserved() > reserved + 800000;
+    scratch.releaseArray(large, 100000);
+    test_assert(reused == small && largeHeld && scratch.getBytesReserved() == reserved,
+                "Arena reuses small blocks and frees large ones");
+
+    // A growing area or zone range is extended in place at the end of the
+    // store, and otherwise moves out of a range that later ranges reuse
+    SlotStore store(&scratch, 0);
+    ParkingArea growing(&store, 2);
+    ParkingArea next(&store, 2);
+    Zone own(&store, 2);
+    for (int i = 0; i < 12; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        growing.addSlot(slot);
+        own.addSlot(slot);
+    }
+    int endBefore = store.getSize();
+    for (int i = 0; i < 12; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(100 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(i % 2 == 0);
+        next.addSlot(slot);
+    }
+    ParkingArea filler(&store, 2);
+    int lastFirst = next.getFirstPosition();
+    for (int i = 12; i < 20; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(100 + i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        next.addSlot(slot);  // The last range in the store: grows in place
+    }
+    test_assert(filler.getFirstPosition() < endBefore && next.getFirstPosition() == lastFirst &&
+                store.getSize() == lastFirst + next.getCapacity() && growing.getAvailableSlots() == 12 &&
+                next.getAvailableSlots() == 14 && own.getAvailableSlots() == 12 && own.isSlotAvailable(11) &&
+                next.isSlotAvailable(110) && !next.isSlotAvailable(111),
+                "Slot ranges reused and extended in place as views grow");
+}
+
+void test_29_registry_growth() {
+    std::cout << "\n=== TEST 29: Registry Growth ===" << std::endl;
+
+    // Every registry starts with room for one entry and grows by 1.5x
+    ParkingSystem system(1, 1, 1, 1, 100, 1.5);
+    for (int z = 1; z <= 12; z++) {
+        system.emplaceZone(z, "Zone");
+    }
+    for (int z = 2; z <= 12; z++) {
+        system.addZoneAdjacency(1, z);  // More neighbours than the initial list holds
+    }
+    const Zone* copied = system.getZone(3);
+    Zone copy(*copied);
+    system.addZone(*system.getZone(3));  // Copy of a registered zone while the array grows
+
+    ParkingArea area(1);
+    area.setZoneID(1);
+    for (int i = 0; i < 40; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(i + 1);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        area.addSlot(slot);  // Grows past its initial capacity
+    }
+    bool areaGrew = (area.getNumSlots() == 40 && area.isSlotAvailable(1) && area.isSlotAvailable(40));
+    system.addArea(area);
+    int lastArea = -1;
+    for (int a = 0; a < 30; a++) {
+        ParkingSlot slot;
+        slot.setSlotID(1000 + a);
+        slot.setZoneID((a % 12) + 1);
+        slot.setIsAvailable(true);
+        lastArea = system.emplaceArea(a + 2, (a % 12) + 1, &slot, 1);
+    }
+    for (int i = 0; i < 60; i++) {
+        Vehicle vehicle;
+        vehicle.setVehicleID(i + 1);
+        vehicle.setPreferredZone(1);
+        system.addVehicle(vehicle);
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+
+    Zone zone(1);
+    zone.setZoneID(50);
+    for (int i = 0; i < 20; i++) {
+        ParkingSlot slot;
+        slot.setSlotID(500 + i);
+        slot.setZoneID(50);
+        slot.setIsAvailable(i % 2 == 0);
+        zone.addSlot(slot);  // Own range grows and keeps its slot index
+    }
+
+    test_assert(areaGrew && zone.getNumSlots() == 20 && zone.isSlotAvailable(518) &&
+                !zone.isSlotAvailable(519), "Areas and zones grow past their initial capacity");
+    test_assert(system.getZone(1)->getNumAdjacentZones() == 11 && copy.getZoneID() == 3,
+                "Adjacency lists grow when full");
+    test_assert(lastArea == 30 && system.getTotalSlots() == 70, "Area indices stay stable across growth");
+
+    // Zone 1 has 40 + 3 slots; 43 same-zone allocations, then cross-zone
+    int sameZone = 0;
+    int allocated = 0;
+    for (int i = 0; i < 60; i++) {
+        if (system.allocateForRequest(i) != -1) {
+            allocated++;
+            if (system.getLastAllocationPenalty() == 0) {
+                sameZone++;
+            }
+        }
+    }
+    test_assert(sameZone == 43 && allocated == 60, "Requests beyond the initial capacity are served");
+    system.rollbackLastK(60);
+    test_assert(system.getAvailableSlots() == 70 && system.verifyCounters(),
+                "Rollback by request position after growth");
+
+    // Old generations are given back as the request array grows: the arena
+    // holds about the final array (under 2x the requests), not every
+    // generation before it as well
+    ParkingSystem grown(1, 1, 1, 1, 10);
+    for (int i = 0; i < 20000; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        grown.addRequest(req);
+    }
+    size_t bound = 2 * sizeof(ParkingRequest) * 20000 + 2 * Arena::DEFAULT_CHUNK_SIZE;
+    test_assert(grown.getNumRequests() == 20000 && grown.getArena().getBytesReserved() <= bound,
+                "Arena bytes bounded after many inserts");
+}
+
+// Small two-zone system for the replay test (zone 1: 2 slots, zone 2: 2 slots)
+ParkingSystem* build_replay_system() {
+    ParkingSystem* system = new ParkingSystem(2, 1, 4, 2, 10);
+    system->emplaceZone(1, "A");
+    system->emplaceZone(2, "B");
+    system->addZoneAdjacency(1, 2);
+    ParkingSlot slots[2];
+    for (int a = 0; a < 2; a++) {
+        for (int i = 0; i < 2; i++) {
+            slots[i].setSlotID(a * 10 + i);
+            slots[i].setZoneID(a + 1);
+            slots[i].setIsAvailable(true);
+        }
+        system->emplaceArea(a + 1, a + 1, slots, 2);
+    }
+    return system;
+}
+
+void test_30_event_log_replay() {
+    std::cout << "\n=== TEST 30: Event Log Replay ===" << std::endl;
+
+    const char* path = "test_events.bin";
+    EventLogWriter writer;
+    bool opened = writer.open(path);
+    for (int i = 0; i < 5; i++) {
+        writer.logRequest(i + 1, i + 1, 1, i);  // All five want zone 1
+        writer.logAllocate(i, i);
+    }
+    writer.logOccupy(0, 10);
+    writer.logRelease(0, 20);
+    writer.logCancel(1, 21);
+    writer.logRollback(1, 22);          // Undoes request 3's allocation
+    writer.logOccupy(3, 23);            // Rejected: request 3 was rolled back
+    writer.logOccupy(7, 24);            // Invalid: request 7 was never logged
+    bool closed = writer.close();
+    test_assert(opened && closed && writer.getNumWritten() == 16, "Event log written");
+
+    // Expected state from the same calls made directly
+    ParkingSystem* direct = build_replay_system();
+    for (int i = 0; i < 5; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        direct->addRequest(req);
+        direct->allocateForRequest(i);
+    }
+    direct->occupyRequest(0);
+    direct->releaseRequest(0, 20);
+    direct->cancelRequest(1);
+    direct->rollbackLastK(1);
+
+    for (int mode = 0; mode < 2; mode++) {
+        EventLogReader reader(mode == 0);
+        bool readable = reader.open(path);
+        ParkingSystem* system = build_replay_system();
+        EventReplayer replayer(system);
+        ReplayStats stats = replayer.replay(reader);
+        bool same = system->getNumRequests() == 5;
+        for (int i = 0; i < 5 && same; i++) {
+            same = system->getRequest(i)->getState() == direct->getRequest(i)->getState() &&
+                   system->getRequest(i)->getAllocatedSlotID() == direct->getRequest(i)->getAllocatedSlotID();
+        }
+        test_assert(readable && reader.getNumRecords() == 16 && stats.events == 16 &&
+                    stats.applied == 13 && stats.rejected == 2 && stats.invalid == 1,
+                    mode == 0 ? "Mapped replay counts events" : "Streamed replay counts events");
+        test_assert(same && system->getAvailableSlots() == direct->getAvailableSlots() &&
+                    system->verifyCounters(), mode == 0 ? "Mapped replay matches direct calls"
+                                                        : "Streamed replay matches direct calls");
+        delete system;
+    }
+    delete direct;
+
+    // A file that is not an event log is refused
+    FILE* bogus = std::fopen(path, "wb");
+    std::fputs("not an event log at all", bogus);
+    std::fclose(bogus);
+    EventLogReader reader;
+    test_assert(!reader.open(path), "Foreign file rejected by header check");
+    std::remove(path);
+}
+
+// Offset of the first record of a snapshot section, or -1 (walks the
+// 16-byte file header and the 16-byte section headers of Snapshot.cpp)
+static long snapshotSectionOffset(const char* bytes, long size, int tag) {
+    long offset = 16;
+    while (offset + 16 <= size) {
+        int sectionTag;
+        long long payload;
+        memcpy(&sectionTag, bytes + offset, sizeof(int));
+        memcpy(&payload, bytes + offset + 8, sizeof(long long));
+        if (sectionTag == tag) {
+            return offset + 16;
+        }
+        offset += 16 + ((payload + 7) & ~7LL);
+    }
+    return -1;
+}
+
+// Point a request record of a saved snapshot at another area and slot, then
+// try to load it
+static bool loadsWithRequestSlot(const char* path, int request, int area, int slotID) {
+    FILE* in = std::fopen(path, "rb");
+    std::fseek(in, 0, SEEK_END);
+    long size = std::ftell(in);
+    std::fseek(in, 0, SEEK_SET);
+    char* bytes = new char[size];
+    size_t got = std::fread(bytes, 1, size, in);
+    std::fclose(in);
+    long offset = snapshotSectionOffset(bytes, static_cast<long>(got), SNAPSHOT_REQUESTS);
+    int* record = reinterpret_cast<int*>(bytes + offset) + request * 10;  // SnapshotRequestRecord
+    record[6] = area;
+    record[7] = slotID;
+    FILE* out = std::fopen("test_snapshot_patched.bin", "wb");
+    std::fwrite(bytes, 1, got, out);
+    std::fclose(out);
+    delete[] bytes;
+    ParkingSystem* system = ParkingSystem::loadSnapshot("test_snapshot_patched.bin");
+    std::remove("test_snapshot_patched.bin");
+    bool loaded = system != nullptr;
+    delete system;
+    return loaded;
+}
+
+void test_31_snapshot_restore() {
+    std::cout << "\n=== TEST 31: Snapshot Save and Restore ===" << std::endl;
+
+    ParkingSystem* original = new ParkingSystem(3, 4, 8, 6, 5);
+    Zone north(2);
+    north.setZoneID(1);
+    north.setZoneName("North");
+    ParkingSlot own;
+    own.setSlotID(900);
+    own.setZoneID(1);
+    own.setIsAvailable(true);
+    north.addSlot(own);  // A zone slot outside any area
+    original->addZone(north);
+    original->emplaceZone(2, "South");
+    original->emplaceZone(3, "East");
+    original->addZoneAdjacency(1, 2);
+    original->addZoneAdjacency(2, 3);
+    ParkingSlot slots[3];
+    for (int a = 0; a < 6; a++) {
+        int z = (a % 3) + 1;
+        for (int i = 0; i < 3; i++) {
+            slots[i].setSlotID(a * 10 + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(i != 2 || a != 0);
+        }
+        original->emplaceArea(a + 1, z, slots, 3);
+    }
+    for (int i = 0; i < 4; i++) {
+        Vehicle vehicle;
+        vehicle.setVehicleID(i + 1);
+        vehicle.setPreferredZone(2);
+        original->addVehicle(vehicle);
+    }
+    for (int i = 0; i < 12; i++) {
+        ParkingRequest req;
+        req.setRequestID(100 + i);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        original->addRequest(req);
+        original->allocateForRequest(i);  // Zone 1 has 5 free slots, then zone 2
+    }
+    original->occupyRequest(0);
+    original->releaseRequest(0, 50);
+    original->occupyRequest(1);
+    original->cancelRequest(2);
+    original->rollbackLastK(2);  // History holds 5 records: 2 evicted so far
+    original->redoLastK(1);      // One record left to redo
+
+    bool saved = original->saveSnapshot("test_snapshot.bin");
+    ParkingSystem* restored = ParkingSystem::loadSnapshot("test_snapshot.bin");
+    test_assert(saved && restored != nullptr, "Snapshot written and restored");
+    if (restored == nullptr) {
+        delete original;
+        return;
+    }
+
+    bool sameRequests = restored->getNumRequests() == original->getNumRequests();
+    for (int i = 0; i < original->getNumRequests() && sameRequests; i++) {
+        const ParkingRequest* a = original->getRequest(i);
+        const ParkingRequest* b = restored->getRequest(i);
+        sameRequests = a->getRequestID() == b->getRequestID() && a->getState() == b->getState() &&
+                       a->getAllocatedSlotID() == b->getAllocatedSlotID() &&
+                       a->getExitTime() == b->getExitTime();
+    }
+    test_assert(sameRequests, "Requests restored with states and allocations");
+    test_assert(restored->getTotalSlots() == original->getTotalSlots() &&
+                restored->getAvailableSlots() == original->getAvailableSlots() &&
+                restored->getZoneUtilization(2) == original->getZoneUtilization(2) &&
+                restored->getPeakUsageZone() == original->getPeakUsageZone() &&
+                restored->getZone(1)->getNumSlots() == 7 && restored->getZone(1)->isSlotAvailable(900) &&
+                strcmp(restored->getZone(2)->getZoneName(), "South") == 0 &&
+                restored->getZone(2)->getNumAdjacentZones() == 2,
+                "Zones, slots and analytics restored");
+    test_assert(restored->getRollbackHistorySize() == original->getRollbackHistorySize() &&
+                restored->getRedoHistorySize() == 1 &&
+                restored->getRollbackEvictions() == original->getRollbackEvictions(),
+                "Rollback history and redo stack restored");
+    test_assert(restored->verifyCounters(), "Restored counters match a full recount");
+
+    // A held slot must exist in its area and be taken: point occupied
+    // request 1 at a missing slot, then at a free one (area a holds slots
+    // a * 10 + i of zone a % 3 + 1)
+    const ParkingRequest* held = original->getRequest(1);
+    int freeArea = -1;
+    int freeSlot = -1;
+    for (int a = 0; a < 6 && freeArea == -1; a++) {
+        for (int i = 0; i < 3 && freeArea == -1; i++) {
+            if (original->getZone(a % 3 + 1)->isSlotAvailable(a * 10 + i)) {
+                freeArea = a;
+                freeSlot = a * 10 + i;
+            }
+        }
+    }
+    test_assert(held->getState() == ParkingRequest::OCCUPIED && freeArea != -1 &&
+                loadsWithRequestSlot("test_snapshot.bin", 1, held->getAllocatedArea(), held->getAllocatedSlotID()) &&
+                !loadsWithRequestSlot("test_snapshot.bin", 1, held->getAllocatedArea(), 9999) &&
+                !loadsWithRequestSlot("test_snapshot.bin", 1, freeArea, freeSlot),
+                "Snapshot holding a missing or free slot rejected");
+
+    // Both systems behave the same from here on
+    bool sameFuture = restored->redoLastK(1) == original->redoLastK(1);
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(200 + i);
+        req.setVehicleID(1);
+        req.setRequestedZone(3);
+        original->addRequest(req);
+        restored->addRequest(req);
+        int idx = original->getNumRequests() - 1;
+        sameFuture = sameFuture && original->allocateForRequest(idx) == restored->allocateForRequest(idx);
+    }
+    original->rollbackLastK(3);
+    restored->rollbackLastK(3);
+    sameFuture = sameFuture && original->getAvailableSlots() == restored->getAvailableSlots();
+    test_assert(sameFuture && restored->verifyCounters(), "Restored system continues like the original");
+    delete original;
+    delete restored;
+
+    FILE* bogus = std::fopen("test_snapshot.bin", "wb");
+    std::fputs("PKSN but not really a snapshot", bogus);
+    std::fclose(bogus);
+    test_assert(ParkingSystem::loadSnapshot("test_snapshot.bin") == nullptr &&
+                ParkingSystem::loadSnapshot("missing_snapshot.bin") == nullptr,
+                "Damaged or missing snapshot rejected");
+    std::remove("test_snapshot.bin");
+
+    // Released store ranges survive a restore and are reused as before
+    SlotStore store(16);
+    store.reserve(4);
+    int middle = store.reserve(4);
+    store.reserve(4);
+    store.releaseRange(middle, 4);
+    int firsts[1];
+    int counts[1];
+    store.exportFreeRanges(firsts, counts);
+    SlotStore copy(16);
+    copy.reserve(12);
+    copy.restoreFreeRanges(firsts, counts, store.getNumFreeRanges());
+    test_assert(copy.getNumFreeRanges() == 1 && copy.reserve(4) == middle && copy.reserve(4) == 12,
+                "Released slot ranges restored for reuse");
+}
+
+void test_32_journal_recovery() {
+    std::cout << "\n=== TEST 32: Write-Ahead Journal and Recovery ===" << std::endl;
+
+    ParkingSystem* original = new ParkingSystem(2, 1, 4, 4, 6);
+    original->emplaceZone(1, "North");
+    original->emplaceZone(2, "South");
+    original->addZoneAdjacency(1, 2);
+    ParkingSlot slots[3];
+    for (int a = 0; a < 4; a++) {
+        int z = (a % 2) + 1;
+        for (int i = 0; i < 3; i++) {
+            slots[i].setSlotID(a * 10 + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(true);
+        }
+        original->emplaceArea(a + 1, z, slots, 3);
+    }
+
+    // Small groups, so the journal commits several times
+    Journal journal(4, 500);
+    bool opened = journal.open("test_journal.bin", original->getJournalSequence() + 1);
+    test_assert(opened && original->attachJournal(&journal) && original->checkpoint("test_checkpoint.bin"),
+                "Journal attached and facility checkpointed");
+
+    for (int i = 0; i < 10; i++) {
+        ParkingRequest req;
+        req.setRequestID(100 + i);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        original->addRequest(req);
+    }
+    for (int i = 0; i < 6; i++) {
+        original->allocateForRequest(i);
+    }
+    original->occupyRequest(0);
+    original->releaseRequest(0, 40);
+    original->cancelRequest(1);
+
+    // Checkpoint in the middle: later records go to the emptied journal
+    long long beforeCheckpoint = original->getJournalSequence();
+    test_assert(original->checkpoint("test_checkpoint.bin") && journal.getNextSequence() == beforeCheckpoint + 1,
+                "Checkpoint keeps the journal numbering");
+
+    int batch[3] = {6, 7, 8};
+    int batchSlots[3];
+    bool batchPenalties[3];
+    original->allocateBatch(batch, 3, batchSlots, batchPenalties);
+    original->occupyRequest(2);
+    original->rollbackLastK(2);
+    original->redoLastK(1);
+    original->allocateForRequest(9);
+
+    // A vehicle registered after the checkpoint must come back from the journal
+    Vehicle ev;
+    ev.setVehicleID(77);
+    ev.setPreferredZone(2);
+    ev.setVehicleClass(VEHICLE_EV);
+    original->addVehicle(ev);
+    test_assert(journal.sync() && journal.getDurableSequence() == original->getJournalSequence() &&
+                journal.getNumCommits() > 0,
+                "Group commit makes every record durable on sync");
+
+    // A crash can leave a partial record behind
+    FILE* tail = std::fopen("test_journal.bin", "ab");
+    if (tail != nullptr) {
+        std::fwrite("torn-record", 1, 11, tail);
+        std::fclose(tail);
+    }
+
+    ParkingSystem* recovered = ParkingSystem::recover("test_checkpoint.bin", "test_journal.bin");
+    test_assert(recovered != nullptr, "Recovered from checkpoint and journal (torn tail ignored)");
+    if (recovered != nullptr) {
+        bool same = recovered->getNumRequests() == original->getNumRequests();
+        for (int i = 0; i < original->getNumRequests() && same; i++) {
+            const ParkingRequest* a = original->getRequest(i);
+            const ParkingRequest* b = recovered->getRequest(i);
+            same = a->getState() == b->getState() && a->getAllocatedSlotID() == b->getAllocatedSlotID() &&
+                   a->getExitTime() == b->getExitTime();
+        }
+        test_assert(same && recovered->getAvailableSlots() == original->getAvailableSlots() &&
+                    recovered->getRollbackHistorySize() == original->getRollbackHistorySize() &&
+                    recovered->getRedoHistorySize() == original->getRedoHistorySize() &&
+                    recovered->getJournalSequence() == original->getJournalSequence() &&
+                    recovered->verifyCounters(),
+                    "Recovered state matches the original");
+
+        // The class of a later request comes from the journaled vehicle
+        ParkingRequest late;
+        late.setRequestID(200);
+        late.setVehicleID(77);
+        late.setRequestedZone(2);
+        late.setRequestTime(50);
+        recovered->addRequest(late);
+        test_assert(recovered->getRequest(recovered->getNumRequests() - 1)->getVehicleClass() == VEHICLE_EV,
+                    "Vehicle added after the checkpoint is recovered from the journal");
+
+        // A journal must continue the recovered numbering
+        Journal stale;
+        stale.open("test_journal_stale.bin", 1);
+        test_assert(!recovered->attachJournal(&stale), "Journal with the wrong numbering is refused");
+        stale.close();
+        std::remove("test_journal_stale.bin");
+    }
+
+    original->attachJournal(nullptr);
+    journal.close();
+    delete recovered;
+    delete original;
+    std::remove("test_journal.bin");
+    std::remove("test_checkpoint.bin");
+}
+
+// Overstay handler for test 33: releases the request at its deadline
+void release_overstay(ParkingSystem* system, int requestIndex, void* context) {
+    int* released = static_cast<int*>(context);
+    if (system->releaseRequest(requestIndex, system->getRequest(requestIndex)->getRequestTime() + 50)) {
+        (*released)++;
+    }
+}
+
+void test_33_request_timers() {
+    std::cout << "\n=== TEST 33: Timer-Wheel No-Show and Max-Stay Expiry ===" << std::endl;
+
+    ParkingSystem system(1, 1, 2, 1, 10);
+    system.emplaceZone(1, "Main");
+    ParkingSlot slots[4];
+    for (int i = 0; i < 4; i++) {
+        slots[i].setSlotID(i + 1);
+        slots[i].setZoneID(1);
+        slots[i].setIsAvailable(true);
+    }
+    system.emplaceArea(1, 1, slots, 4);
+    system.setNoShowGrace(10);
+
+    int times[4] = {0, 5, 7, 30};
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(times[i]);
+        system.addRequest(req);
+    }
+    for (int i = 0; i < 3; i++) {
+        system.allocateForRequest(i);
+    }
+    system.occupyRequest(1);  // Request 1 shows up
+
+    int early = system.advanceTime(9);
+    int first = system.advanceTime(10);  // Request 0 is due at 0 + 10
+    test_assert(early == 0 && first == 1 && system.getRequest(0)->getState() == ParkingRequest::CANCELLED &&
+                system.getAvailableSlots() == 2,
+                "No-show cancelled at requestTime + grace and its slot freed");
+
+    int second = system.advanceTime(20);  // Request 2 due at 17; request 1 is OCCUPIED
+    test_assert(second == 1 && system.getRequest(2)->getState() == ParkingRequest::CANCELLED &&
+                system.getRequest(1)->getState() == ParkingRequest::OCCUPIED &&
+                system.getExpiredNoShows() == 2,
+                "Only requests still ALLOCATED expire");
+
+    // Rolled back, then redone after its deadline: the timer is re-armed
+    system.allocateForRequest(3);
+    system.rollbackLast();
+    system.advanceTime(45);
+    system.redoLastK(1);
+    test_assert(system.getRequest(3)->getState() == ParkingRequest::ALLOCATED && system.advanceTime(46) == 1 &&
+                system.getRequest(3)->getState() == ParkingRequest::CANCELLED,
+                "Redone allocation expires through its re-armed timer");
+
+    // Max stay: request 1 (requestTime 5) overstays at 55
+    int released = 0;
+    system.setMaxStay(50, release_overstay, &released);
+    test_assert(system.advanceTime(54) == 0 && system.advanceTime(56) == 1 && released == 1 &&
+                system.getRequest(1)->getState() == ParkingRequest::RELEASED && system.getOverstays() == 1,
+                "Overstay reported to the handler, which releases the slot");
+
+    // A far-away deadline is reached without visiting every tick
+    ParkingRequest late;
+    late.setRequestID(9);
+    late.setVehicleID(9);
+    late.setRequestedZone(1);
+    late.setRequestTime(1000000000);
+    system.addRequest(late);
+    system.allocateForRequest(4);
+    test_assert(system.advanceTime(1000000009) == 0 && system.advanceTime(1000000010) == 1 &&
+                system.getAvailableSlots() == 4 && system.verifyCounters(),
+                "Long jumps expire timers at the right tick");
+}
+
+void test_34_instrumentation() {
+    std::cout << "\n=== TEST 34: Latency Histograms and Operation Counters ===" << std::endl;
+
+    // Buckets: exact below 32 ns, within 1/16 above
+    unsigned long long values[7] = {0, 31, 32, 33, 1000, 123456, 1ULL << 39};
+    bool accurate = true;
+    for (int i = 0; i < 7; i++) {
+        int bucket = HistogramSnapshot::bucketOf(values[i]);
+        unsigned long long limit = HistogramSnapshot::bucketLimit(bucket);
+        accurate = accurate && bucket < HistogramSnapshot::BUCKETS && limit >= values[i] &&
+                   limit - values[i] <= values[i] / 16 &&
+                   (bucket == 0 || HistogramSnapshot::bucketLimit(bucket - 1) < values[i]);
+    }
+    test_assert(accurate, "Log buckets hold each value within 1/16");
+
+    LatencyHistogram* histogram = new LatencyHistogram();
+    for (int i = 1; i <= 1000; i++) {
+        histogram->record(i);
+    }
+    HistogramSnapshot* copy = new HistogramSnapshot();
+    histogram->snapshot(copy);
+    unsigned long long p50 = copy->percentile(50.0);
+    test_assert(copy->count == 1000 && copy->min == 1 && copy->max == 1000 && copy->mean() == 500.5 &&
+                p50 >= 500 && p50 <= 500 + 500 / 16 && copy->percentile(100.0) == 1000,
+                "Histogram count, extremes, mean and percentiles");
+    delete copy;
+    delete histogram;
+
+    ParkingSystem system(2, 1, 4, 2, 10);
+    system.emplaceZone(1, "Near");
+    system.emplaceZone(2, "Far");
+    system.addZoneAdjacency(1, 2);
+    ParkingSlot slots[2];
+    for (int z = 1; z <= 2; z++) {
+        for (int i = 0; i < 2; i++) {
+            slots[i].setSlotID(z * 10 + i);
+            slots[i].setZoneID(z);
+            slots[i].setIsAvailable(true);
+        }
+        system.emplaceArea(z, z, slots, z == 1 ? 2 : 1);
+    }
+    for (int i = 0; i < 4; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        system.addRequest(req);
+        system.allocateForRequest(i);  // Same, same, cross-zone, failed
+    }
+    system.occupyRequest(0);
+    system.getAvailableSlots();
+
+    InstrumentationSnapshot* stats = new InstrumentationSnapshot();
+#if defined(PARKING_INSTRUMENTATION)
+    bool enabled = system.getInstrumentation(stats);
+    test_assert(enabled && stats->operations[OP_ALLOCATE_SAME_ZONE].count == 2 &&
+                stats->operations[OP_ALLOCATE_CROSS_ZONE].count == 1 &&
+                stats->operations[OP_ALLOCATE_FAILED].count == 1 &&
+                stats->operations[OP_OCCUPY].count == 1 && stats->operations[OP_QUERY_COUNTERS].count == 1,
+                "Allocations split into same-zone, cross-zone and failed");
+    std::ostringstream dump;
+    system.dumpInstrumentation(dump);
+    system.resetInstrumentation();
+    system.getInstrumentation(stats);
+    test_assert(dump.str().find("allocate_cross_zone\t1\t") != std::string::npos &&
+                stats->operations[OP_ALLOCATE_SAME_ZONE].count == 0,
+                "Text dump lists the operations; reset clears them");
+#else
+    test_assert(!system.getInstrumentation(stats), "Instrumentation compiled out unless enabled");
+#endif
+    delete stats;
+}
+
+void test_35_transition_errors() {
+    std::cout << "\n=== TEST 35: Transition Status Codes and Error Counters ===" << std::endl;
+
+    // Transitions report their outcome instead of printing
+    ParkingRequest lone;
+    bool statuses = lone.occupy() == ParkingRequest::TRANSITION_INVALID &&
+                    lone.allocate() == ParkingRequest::TRANSITION_OK &&
+                    lone.allocate() == ParkingRequest::TRANSITION_INVALID &&
+                    lone.getState() == ParkingRequest::ALLOCATED;
+    test_assert(statuses, "Transitions return OK or INVALID and leave the state on failure");
+
+    ParkingSystem system(1, 1, 2, 1, 10);
+    system.emplaceZone(1, "Main");
+    ParkingSlot slots[2];
+    for (int i = 0; i < 2; i++) {
+        slots[i].setSlotID(i + 1);
+        slots[i].setZoneID(1);
+        slots[i].setIsAvailable(true);
+    }
+    system.emplaceArea(1, 1, slots, 2);
+    for (int i = 0; i < 3; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        system.addRequest(req);
+    }
+
+    system.allocateForRequest(0);
+    system.occupyRequest(0);
+    bool rejected = system.allocateForRequest(0) == -1 && !system.occupyRequest(0) && !system.cancelRequest(0) &&
+                    !system.releaseRequest(1, 5) && !system.occupyRequest(2);
+    test_assert(rejected && system.getAvailableSlots() == 1 && system.verifyCounters(),
+                "Rejected calls take no slot and leave counters consistent");
+
+    std::ostringstream log;
+    test_assert(system.flushTransitionLog(log) == 0 && log.str().empty(), "Verbose log is off by default");
+
+    system.enableTransitionLog(2);
+    system.occupyRequest(1);
+    system.occupyRequest(2);
+    system.releaseRequest(2, 5);  // Overwrites the oldest entry
+    bool counted = system.getTransitionErrors(ParkingRequest::ALLOCATE) == 1 &&
+                   system.getTransitionErrors(ParkingRequest::OCCUPY) == 4 &&
+                   system.getTransitionErrors(ParkingRequest::OCCUPY, ParkingRequest::REQUESTED) == 3 &&
+                   system.getTransitionErrors(ParkingRequest::OCCUPY, ParkingRequest::OCCUPIED) == 1 &&
+                   system.getTransitionErrors(ParkingRequest::RELEASE) == 2 &&
+                   system.getTransitionErrors(ParkingRequest::CANCEL, ParkingRequest::OCCUPIED) == 1;
+    test_assert(counted, "Errors counted per transition and from-state");
+
+    int flushed = system.flushTransitionLog(log);
+    test_assert(flushed == 2 && log.str().find("1 earlier transition errors dropped") != std::string::npos &&
+                log.str().find("Cannot release request 3 from REQUESTED state") != std::string::npos &&
+                system.flushTransitionLog(log) == 0,
+                "Buffered log keeps the newest entries until flushed");
+
+    std::ostringstream exported;
+    system.exportTransitionErrors(exported);
+    system.resetTransitionErrors();
+    test_assert(exported.str().find("occupy\tREQUESTED\t3\n") != std::string::npos &&
+                system.getTransitionErrors(ParkingRequest::OCCUPY) == 0,
+                "Counters export as tab-separated lines and reset");
+
+    // Only calls through the facade are counted: the same rejected
+    // transition made on a request object directly is not
+    ParkingRequest direct = *system.getRequest(0);
+    bool directRejected = direct.occupy() == ParkingRequest::TRANSITION_INVALID;
+    bool directUncounted = system.getTransitionErrors(ParkingRequest::OCCUPY) == 0;
+    test_assert(directRejected && directUncounted && !system.occupyRequest(0) &&
+                system.getTransitionErrors(ParkingRequest::OCCUPY, ParkingRequest::OCCUPIED) == 1,
+                "Direct request transitions are not counted, facade ones are");
+}
+
+void test_36_state_lists() {
+    std::cout << "\n=== TEST 36: Transition Table and Per-State Request Lists ===" << std::endl;
+
+    bool table = ParkingRequest::canTransition(ParkingRequest::CANCEL, ParkingRequest::ALLOCATED) &&
+                 !ParkingRequest::canTransition(ParkingRequest::CANCEL, ParkingRequest::OCCUPIED) &&
+                 ParkingRequest::transitionTarget(ParkingRequest::REINSTATE, ParkingRequest::CANCELLED) == ParkingRequest::ALLOCATED &&
+                 ParkingRequest::edgesFrom(ParkingRequest::RELEASED) == 0;
+    test_assert(table, "Transition table matches the lifecycle");
+
+    ParkingSystem system(1, 1, 8, 1, 10);
+    system.emplaceZone(1, "Main");
+    ParkingSlot slots[6];
+    for (int i = 0; i < 6; i++) {
+        slots[i].setSlotID(i + 1);
+        slots[i].setZoneID(1);
+        slots[i].setIsAvailable(true);
+    }
+    system.emplaceArea(1, 1, slots, 6);
+    for (int i = 0; i < 8; i++) {
+        ParkingRequest req;
+        req.setRequestID(i + 1);
+        req.setVehicleID(i + 1);
+        req.setRequestedZone(1);
+        req.setRequestTime(i);
+        system.addRequest(req);
+    }
+    for (int i = 0; i < 5; i++) {
+        system.allocateForRequest(i);
+    }
+    system.occupyRequest(3);
+    system.occupyRequest(1);
+    system.releaseRequest(1, 20);
+    system.cancelRequest(6);
+    system.rollbackLast();  // Request 4 back to CANCELLED
+
+    int out[8];
+    int allocated = system.listRequestsInState(ParkingRequest::ALLOCATED, out, 8);
+    test_assert(allocated == 2 && out[0] == 0 && out[1] == 2, "Allocated-but-unoccupied requests listed in entry order");
+
+    int cancelled = system.listRequestsInState(ParkingRequest::CANCELLED, out, 8);
+    test_assert(cancelled == 2 && out[0] == 6 && out[1] == 4, "Cancel and rollback move requests to the CANCELLED list");
+
+    system.redoLastK(1);
+    int walked = 0;
+    int last = -1;
+    for (int i = system.getFirstRequestInState(ParkingRequest::ALLOCATED); i != -1; i = system.getNextRequestInState(i)) {
+        walked++;
+        last = i;
+    }
+    test_assert(walked == 3 && last == 4, "Redo appends the reinstated request to the ALLOCATED list");
+
+    int active = system.listActiveRequests(out, 8);
+    int capped = system.listActiveRequests(out, 2);
+    test_assert(active == system.getActiveRequests() && active == 6 && capped == 2 && out[0] == 5 && out[1] == 7,
+                "Active requests listed REQUESTED first and capped at maxCount");
+    test_assert(system.verifyCounters() && system.getAverageParkingDuration() == 19.0,
+                "Lists agree with the request states; duration reads the RELEASED list");
+}
+
+// Brute-force nearest free slot of an area, by the same rule as the
+// spatial index: fewest levels away, then planar distance, then position
+static int nearest_by_scan(const ParkingSlot* slots, const bool* taken, int count, int x, int y, int level) {
+    int best = -1;
+    long long bestGap = 0;
+    long long bestDistance = 0;
+    for (int i = 0; i < count; i++) {
+        if (taken[i]) {
+            continue;
+        }
+        long long gap = slots[i].getLevel() - level;
+        gap = (gap < 0) ? -gap : gap;
+        long long dx = slots[i].getX() - x;
+        long long dy = slots[i].getY() - y;
+        long long distance = dx * dx + dy * dy;
+        if (best == -1 || gap < bestGap || (gap == bestGap && distance < bestDistance)) {
+            best = i;
+            bestGap = gap;
+            bestDistance = distance;
+        }
+    }
+    return (best == -1) ? -1 : slots[best].getSlotID();
+}
+
+void test_37_nearest_slot() {
+    std::cout << "\n=== TEST 37: Nearest Free Slot with a Spatial Index ===" << std::endl;
+
+    // Three decks of 20 x 15 bays, 5 m apart, deck 1 missing a corner
+    const int maxSlots = 900;
+    ParkingSlot* slots = new ParkingSlot[maxSlots];
+    bool* taken = new bool[maxSlots];
+    int count = 0;
+    for (int level = 0; level < 3; level++) {
+        for (int row = 0; row < 15; row++) {
+            for (int col = 0; col < 20; col++) {
+                if (level == 1 && row < 5 && col < 5) {
+                    continue;
+                }
+                slots[count].setSlotID(1000 * (level + 1) + row * 20 + col);
+                slots[count].setZoneID(1);
+                slots[count].setIsAvailable(true);
+                slots[count].setCoordinates(col * 5, row * 5, level);
+                taken[count] = false;
+                count++;
+            }
+        }
+    }
+    ParkingArea area(count);
+    for (int i = 0; i < count; i++) {
+        area.addSlot(slots[i]);
+    }
+
+    test_assert(area.findNearestAvailableSlot(0, 0, 0) == 1000 && area.findNearestAvailableSlot(0, 0, 1) == 2005,
+                "Nearest slot is on the reference level, closest to the point");
+
+    // Occupy about 95% in a fixed pseudo-random order, comparing against a
+    // full scan from many reference points along the way
+    unsigned int seed = 12345;
+    bool matches = true;
+    int queries = 0;
+    for (int step = 0; step < count * 95 / 100; step++) {
+        seed = seed * 1103515245u + 12345u;
+        int i = static_cast<int>((seed >> 8) % count);
+        while (taken[i]) {
+            i = (i + 1) % count;
+        }
+        taken[i] = true;
+        area.occupySlot(slots[i].getSlotID());
+        if (step % 25 == 0) {
+            int x = static_cast<int>((seed >> 4) % 120) - 10;
+            int y = static_cast<int>((seed >> 12) % 90) - 10;
+            int level = static_cast<int>((seed >> 20) % 5) - 1;
+            matches = matches && area.findNearestAvailableSlot(x, y, level) ==
+                                 nearest_by_scan(slots, taken, count, x, y, level);
+            queries++;
+        }
+    }
+    test_assert(matches && queries > 20, "Grid answers match a full scan up to 95% occupancy");
+
+    // Freeing a slot makes it the answer again
+    int target = 0;
+    while (!taken[target]) {
+        target++;
+    }
+    area.freeSlot(slots[target].getSlotID());
+    taken[target] = false;
+    int x = slots[target].getX();
+    int y = slots[target].getY();
+    int level = slots[target].getLevel();
+    test_assert(area.findNearestAvailableSlot(x, y, level) == slots[target].getSlotID(),
+                "Freed slot found at its own coordinates");
+
+    // Coordinates survive a system snapshot
+    ParkingSystem system(1, 1, 1, 1, 10);
+    system.emplaceZone(1, "Deck");
+    system.emplaceArea(1, 1, slots, count);
+    const char* path = "test_nearest_snapshot.bin";
+    bool saved = system.saveSnapshot(path);
+    ParkingSystem* restored = ParkingSystem::loadSnapshot(path);
+    std::remove(path);
+    test_assert(saved && restored != nullptr && restored->findNearestFreeSlot(0, 52, 33, 2) == 3000 + 7 * 20 + 10 &&
+                restored->findNearestFreeSlot(0, 52, 33, 2) == system.findNearestFreeSlot(0, 52, 33, 2),
+                "Slot coordinates saved in and restored from a snapshot");
+    delete restored;
+    delete[] slots;
+    delete[] taken;
+}
+
+// Build the facility for test 38: zone 1 has one mixed area, zone 2 one
+// standard area with a single EV bay
+ParkingSystem* build_typed_facility() {
+    ParkingSystem* system = new ParkingSystem(2, 2, 2, 2, 16);
+    system->emplaceZone(1, "Mixed");
+    system->emplaceZone(2, "Overflow");
+    system->addZoneAdjacency(1, 2);
+    const int mixedTypes[7] = {SLOT_STANDARD, SLOT_STANDARD, SLOT_EV, SLOT_EV,
+                               SLOT_ACCESSIBLE, SLOT_COMPACT, SLOT_MOTORCYCLE};
+    ParkingSlot slots[7];
+    for (int i = 0; i < 7; i++) {
+        slots[i].setSlotID(i + 1);
+        slots[i].setZoneID(1);
+        slots[i].setIsAvailable(true);
+        slots[i].setSlotType(mixedTypes[i]);
+    }
+    system->emplaceArea(1, 1, slots, 7);
+    for (int i = 0; i < 4; i++) {
+        slots[i].setSlotID(20 + i);
+        slots[i].setZoneID(2);
+        slots[i].setSlotType(i == 3 ? SLOT_EV : SLOT_STANDARD);
+    }
+    system->emplaceArea(2, 2, slots, 4);
+    return system;
+}
+
+// Add a zone-1 request of a vehicle class to a test 38 facility
+void add_typed_request(ParkingSystem* system, int vehicleClass) {
+    ParkingRequest req;
+    req.setRequestID(500 + system->getNumRequests());
+    req.setVehicleID(900 + system->getNumRequests());
+    req.setRequestedZone(1);
+    req.setRequestTime(system->getNumRequests());
+    req.setVehicleClass(vehicleClass);
+    system->addRequest(req);
+}
+
+void test_38_slot_types() {
+    std::cout << "\n=== TEST 38: Slot Types and Vehicle Classes ===" << std::endl;
+
+    // Per-type index of a mixed area agrees with a scan
+    const int count = 300;
+    ParkingArea area(count);
+    ParkingSlot slot;
+    for (int i = 0; i < count; i++) {
+        slot.setSlotID(i);
+        slot.setZoneID(1);
+        slot.setIsAvailable(true);
+        slot.setSlotType((i * 7) % NUM_SLOT_TYPES);
+        area.addSlot(slot);
+    }
+    for (int i = 0; i < count; i += 3) {
+        area.occupySlot(i);
+    }
+    bool indexMatches = true;
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        int expected = -1;
+        int available = 0;
+        for (int i = count - 1; i >= 0; i--) {
+            if (i % 3 != 0 && (i * 7) % NUM_SLOT_TYPES == t) {
+                expected = i;
+                available++;
+            }
+        }
+        indexMatches = indexMatches && area.findFirstAvailableSlotOfType(t) == expected &&
+                       area.getAvailableSlotsOfType(t) == available;
+    }
+    area.freeSlot(3);
+    test_assert(indexMatches && area.findFirstAvailableSlotOfType((3 * 7) % NUM_SLOT_TYPES) == 3 &&
+                area.verifyTypeCounters(),
+                "Mixed area finds the first free slot of each type");
+
+    ParkingSystem* system = build_typed_facility();
+    test_assert(system->getTotalSlotsByType(SLOT_EV) == 3 && system->getTotalSlotsByType(SLOT_STANDARD) == 5 &&
+                system->getAvailableSlotsByType(SLOT_MOTORCYCLE) == 1,
+                "Per-type totals counted when areas are added");
+
+    // EVs take chargers first, then fall back to a standard bay in the same zone
+    add_typed_request(system, VEHICLE_EV);
+    add_typed_request(system, VEHICLE_EV);
+    add_typed_request(system, VEHICLE_EV);
+    int ev1 = system->allocateForRequest(0);
+    int ev2 = system->allocateForRequest(1);
+    int ev3 = system->allocateForRequest(2);
+    test_assert(ev1 == 3 && ev2 == 4 && ev3 == 1 && system->getZoneAvailableSlotsByType(1, SLOT_EV) == 0,
+                "EV bays go to EVs, then the same zone's standard bays");
+
+    // Standard cars never take reserved or small bays
+    add_typed_request(system, VEHICLE_STANDARD);
+    add_typed_request(system, VEHICLE_STANDARD);
+    int car1 = system->allocateForRequest(3);
+    int car2 = system->allocateForRequest(4);
+    test_assert(car1 == 2 && car2 == 20 && system->getZoneAvailableSlotsByType(1, SLOT_ACCESSIBLE) == 1 &&
+                system->getZoneAvailableSlotsByType(1, SLOT_COMPACT) == 1,
+                "Standard car overflows to the next zone instead of a reserved bay");
+
+    // Motorcycles fall back to compact bays; accessible bays go to permit holders
+    add_typed_request(system, VEHICLE_MOTORCYCLE);
+    add_typed_request(system, VEHICLE_MOTORCYCLE);
+    add_typed_request(system, VEHICLE_ACCESSIBLE);
+    int moto1 = system->allocateForRequest(5);
+    int moto2 = system->allocateForRequest(6);
+    int permit = system->allocateForRequest(7);
+    test_assert(moto1 == 7 && moto2 == 6 && permit == 5 && system->getAvailableSlotsByType(SLOT_COMPACT) == 0,
+                "Fallbacks follow each class's preference order");
+
+    // Rollback and redo keep the per-type counters in step
+    system->rollbackLastK(2);
+    bool afterRollback = system->getAvailableSlotsByType(SLOT_ACCESSIBLE) == 1 &&
+                         system->getAvailableSlotsByType(SLOT_COMPACT) == 1;
+    system->redoLastK(2);
+    int sum = 0;
+    for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+        sum += system->getAvailableSlotsByType(t);
+    }
+    test_assert(afterRollback && system->getAvailableSlotsByType(SLOT_COMPACT) == 0 &&
+                system->getAvailableSlotsByType(SLOT_STANDARD) == 2 && system->getAvailableSlotsByType(SLOT_EV) == 1 &&
+                sum == system->getAvailableSlots() && system->getAvailableSlotsByType(-1) == 0 &&
+                system->verifyCounters(),
+                "Per-type counters follow rollback and redo");
+
+    // A registered vehicle's class is stamped on its requests
+    Vehicle ev;
+    ev.setVehicleID(77);
+    ev.setPreferredZone(2);
+    ev.setVehicleClass(VEHICLE_EV);
+    system->addVehicle(ev);
+    ParkingRequest charge;
+    charge.setRequestID(600);
+    charge.setVehicleID(77);
+    charge.setRequestedZone(2);
+    charge.setRequestTime(20);
+    system->addRequest(charge);
+    int evSlot = system->allocateForRequest(8);
+    test_assert(system->getRequest(8)->getVehicleClass() == VEHICLE_EV && evSlot == 23,
+                "Request takes the class of its registered vehicle");
+
+    // Slot types and classes survive a snapshot
+    const char* path = "test_types_snapshot.bin";
+    bool saved = system->saveSnapshot(path);
+    ParkingSystem* restored = ParkingSystem::loadSnapshot(path);
+    std::remove(path);
+    bool sameTypes = restored != nullptr;
+    for (int t = 0; t < NUM_SLOT_TYPES && sameTypes; t++) {
+        sameTypes = restored->getTotalSlotsByType(t) == system->getTotalSlotsByType(t) &&
+                    restored->getAvailableSlotsByType(t) == system->getAvailableSlotsByType(t);
+    }
+    for (int i = 0; i < system->getNumRequests() && sameTypes; i++) {
+        sameTypes = restored->getRequest(i)->getVehicleClass() == system->getRequest(i)->getVehicleClass();
+    }
+    test_assert(saved && sameTypes && restored->verifyCounters(), "Slot types and vehicle classes restored from a snapshot");
+    delete restored;
+    delete system;
+
+    // A batch of mixed classes matches one-by-one allocation
+    const int classes[8] = {VEHICLE_STANDARD, VEHICLE_STANDARD, VEHICLE_EV, VEHICLE_STANDARD,
+                            VEHICLE_MOTORCYCLE, VEHICLE_EV, VEHICLE_ACCESSIBLE, VEHICLE_STANDARD};
+    ParkingSystem* batched = build_typed_facility();
+    ParkingSystem* serial = build_typed_facility();
+    int indices[8];
+    for (int i = 0; i < 8; i++) {
+        add_typed_request(batched, classes[i]);
+        add_typed_request(serial, classes[i]);
+        indices[i] = i;
+    }
+    int batchSlots[8];
+    bool batchPenalties[8];
+    batched->allocateBatch(indices, 8, batchSlots, batchPenalties);
+    bool sameSlots = true;
+    for (int i = 0; i < 8; i++) {
+        sameSlots = sameSlots && batchSlots[i] == serial->allocateForRequest(i);
+    }
+    test_assert(sameSlots && batched->getAvailableSlotsByType(SLOT_STANDARD) == serial->getAvailableSlotsByType(SLOT_STANDARD) &&
+                batched->verifyCounters(),
+                "Batch with mixed classes matches sequential allocation");
+    delete batched;
+    delete serial;
+}
+
+// Facility for test 39, wired by hand so every policy's engine can run on
+// it in one build: zone 1 (two areas of 4, the second half full) is
+// adjacent to zones 2 (one area of 4, half full) and 3 (one empty area of 4).
+// With evNearEntrance the first area's bay next to the entrance is an EV bay
+struct PolicyFacility {
+    Zone zones[3];
+    ParkingArea areas[4];
+    ZoneIndex index;
+    Analytics analytics;
+
+    explicit PolicyFacility(bool evNearEntrance = false) : analytics(&index) {
+        const int zoneOfArea[4] = {1, 1, 2, 3};
+        const int firstID[4] = {0, 10, 20, 30};
+        for (int z = 0; z < 3; z++) {
+            zones[z].setZoneID(z + 1);
+            index.addZone(z + 1);
+            analytics.onZoneRegistered(z + 1);
+        }
+        zones[0].addAdjacentZone(2);
+        zones[0].addAdjacentZone(3);
+        for (int a = 0; a < 4; a++) {
+            areas[a].setAreaID(a + 1);
+            areas[a].setZoneID(zoneOfArea[a]);
+            ParkingSlot slot;
+            for (int i = 0; i < 4; i++) {
+                slot.setSlotID(firstID[a] + i);
+                slot.setZoneID(zoneOfArea[a]);
+                slot.setIsAvailable(!((a == 1 || a == 2) && i < 2));
+                slot.setCoordinates((3 - i) * 5, 0, 0);  // The last slot is next to the entrance
+                slot.setSlotType((evNearEntrance && a == 0 && i == 3) ? SLOT_EV : SLOT_STANDARD);
+                areas[a].addSlot(slot);
+            }
+            index.addArea(zoneOfArea[a], a);
+            for (int t = 0; t < NUM_SLOT_TYPES; t++) {
+                if (areas[a].getSlotsOfType(t) > 0) {
+                    analytics.onSlotsAdded(zoneOfArea[a], t, areas[a].getSlotsOfType(t),
+                                           areas[a].getAvailableSlotsOfType(t));
+                }
+            }
+        }
+        index.rebuildDistances(zones, 3);
+    }
+};
+
+// Slots a policy hands out for count zone-1 requests, in order
+template <typename Policy>
+void allocate_with_policy(PolicyFacility& facility, int count, int* outSlotIDs, int* outHops) {
+    BasicAllocationEngine<Policy> engine(facility.areas, &facility.index, &facility.analytics);
+    for (int i = 0; i < count; i++) {
+        outSlotIDs[i] = engine.allocateSlot(i + 1, 1, 4);
+        outHops[i] = engine.getPenaltyHops();
+    }
+}
+
+void test_39_allocation_policies() {
+    std::cout << "\n=== TEST 39: Compile-Time Allocation Policies ===" << std::endl;
+    int slots[7];
+    int hops[7];
+
+    PolicyFacility firstFit;
+    allocate_with_policy<FirstFitPolicy>(firstFit, 7, slots, hops);
+    test_assert(slots[0] == 0 && slots[3] == 3 && slots[4] == 12 && slots[5] == 13 && slots[6] == 22 && hops[6] == 1,
+                "First fit takes the lowest slot of the first area, then the first nearest zone");
+
+    PolicyFacility bestFit;
+    allocate_with_policy<BestFitPolicy>(bestFit, 3, slots, hops);
+    test_assert(slots[0] == 12 && slots[1] == 13 && slots[2] == 0 && bestFit.areas[1].getAvailableSlots() == 0,
+                "Best fit fills the most loaded area first");
+
+    PolicyFacility roundRobin;
+    allocate_with_policy<RoundRobinPolicy>(roundRobin, 4, slots, hops);
+    test_assert(slots[0] == 0 && slots[1] == 12 && slots[2] == 1 && slots[3] == 13,
+                "Round robin alternates between the zone's areas");
+
+    // The cursors are the state a snapshot keeps: an engine restored from
+    // it continues the rotation
+    PolicyFacility rotating;
+    PolicyFacility resumed;
+    BasicAllocationEngine<RoundRobinPolicy> original(rotating.areas, &rotating.index, &rotating.analytics);
+    BasicAllocationEngine<RoundRobinPolicy> restored(resumed.areas, &resumed.index, &resumed.analytics);
+    original.allocateSlot(1, 1, 4);
+    resumed.areas[0].occupySlot(0);
+    int cursorState[3];
+    original.savePolicyState(cursorState);
+    restored.restorePolicyState(cursorState);
+    test_assert(original.getPolicyStateSize() == 3 && original.allocateSlot(2, 1, 4) == 12 &&
+                restored.allocateSlot(2, 1, 4) == 12,
+                "Round robin state restores the rotation");
+
+    PolicyFacility nearest;
+    allocate_with_policy<NearestSlotPolicy>(nearest, 3, slots, hops);
+    test_assert(slots[0] == 3 && slots[1] == 13 && slots[2] == 2,
+                "Nearest slot takes the bay closest to the entrance across the zone's areas");
+
+    // In an area mixing slot types the nearest bay of the vehicle's type wins
+    PolicyFacility mixed(true);
+    allocate_with_policy<NearestSlotPolicy>(mixed, 2, slots, hops);
+    test_assert(slots[0] == 13 && slots[1] == 2 && mixed.areas[0].getAvailableSlotsOfType(SLOT_EV) == 1,
+                "Nearest slot skips other slot types in mixed areas");
+
+    PolicyFacility balanced;
+    allocate_with_policy<LeastUtilizedZonePolicy>(balanced, 7, slots, hops);
+    test_assert(slots[0] == 0 && slots[5] == 13 && slots[6] == 30 && hops[6] == 1,
+                "Least utilized zone sends overflow to the emptier neighbour");
+
+    bool consistent = firstFit.analytics.getAvailableSlots() == 5 && bestFit.analytics.getAvailableSlots() == 9 &&
+                      roundRobin.analytics.getAvailableSlots() == 8 && balanced.analytics.getZoneAvailable(3) == 3;
+    test_assert(consistent, "Every policy keeps the analytics counters in step");
+
+    // The facade reports the policy it was built with
+    ParkingSystem system(1, 1, 1, 1, 1);
+    test_assert(std::strcmp(system.getAllocationPolicyName(), AllocationEngine::Policy::name()) == 0,
+                "ParkingSystem reports its compile-time policy");
+}
+
 int main() {
     std::cout << "\n";
     std::cout << "============================================================" << std::endl;
     std::cout << "SMART PARKING SYSTEM - COMPREHENSIVE TEST SUITE" << std::endl;
-    std::cout << "(15 Test Cases - DSA Semester Project)" << std::endl;
+    std::cout << "(39 Test Cases - DSA Semester Project)" << std::endl;
     std::cout << "============================================================" << std::endl;
 
     try { test_1_basic_slot_allocation(); } catch (...) { std::cout << "[ERROR] Test 1 crashed!" << std::endl; }
@@ -664,6 +2892,30 @@ int main() {
     try { test_13_zone_adjacency(); } catch (...) { std::cout << "[ERROR] Test 13 crashed!" << std::endl; }
     try { test_14_peak_usage_zones(); } catch (...) { std::cout << "[ERROR] Test 14 crashed!" << std::endl; }
     try { test_15_parking_duration(); } catch (...) { std::cout << "[ERROR] Test 15 crashed!" << std::endl; }
+    try { test_16_zone_indexed_allocation(); } catch (...) { std::cout << "[ERROR] Test 16 crashed!" << std::endl; }
+    try { test_17_availability_bitmap(); } catch (...) { std::cout << "[ERROR] Test 17 crashed!" << std::endl; }
+    try { test_18_sparse_slot_ids(); } catch (...) { std::cout << "[ERROR] Test 18 crashed!" << std::endl; }
+    try { test_19_adjacency_ordered_fallback(); } catch (...) { std::cout << "[ERROR] Test 19 crashed!" << std::endl; }
+    try { test_20_running_counters(); } catch (...) { std::cout << "[ERROR] Test 20 crashed!" << std::endl; }
+    try { test_21_peak_zone_heap(); } catch (...) { std::cout << "[ERROR] Test 21 crashed!" << std::endl; }
+    try { test_22_batch_allocation(); } catch (...) { std::cout << "[ERROR] Test 22 crashed!" << std::endl; }
+    try { test_23_concurrent_allocation(); } catch (...) { std::cout << "[ERROR] Test 23 crashed!" << std::endl; }
+    try { test_24_rollback_request_position(); } catch (...) { std::cout << "[ERROR] Test 24 crashed!" << std::endl; }
+    try { test_25_rollback_history_and_redo(); } catch (...) { std::cout << "[ERROR] Test 25 crashed!" << std::endl; }
+    try { test_26_shared_slot_store(); } catch (...) { std::cout << "[ERROR] Test 26 crashed!" << std::endl; }
+    try { test_27_emplace_and_move(); } catch (...) { std::cout << "[ERROR] Test 27 crashed!" << std::endl; }
+    try { test_28_arena_storage(); } catch (...) { std::cout << "[ERROR] Test 28 crashed!" << std::endl; }
+    try { test_29_registry_growth(); } catch (...) { std::cout << "[ERROR] Test 29 crashed!" << std::endl; }
+    try { test_30_event_log_replay(); } catch (...) { std::cout << "[ERROR] Test 30 crashed!" << std::endl; }
+    try { test_31_snapshot_restore(); } catch (...) { std::cout << "[ERROR] Test 31 crashed!" << std::endl; }
+    try { test_32_journal_recovery(); } catch (...) { std::cout << "[ERROR] Test 32 crashed!" << std::endl; }
+    try { test_33_request_timers(); } catch (...) { std::cout << "[ERROR] Test 33 crashed!" << std::endl; }
+    try { test_34_instrumentation(); } catch (...) { std::cout << "[ERROR] Test 34 crashed!" << std::endl; }
+    try { test_35_transition_errors(); } catch (...) { std::cout << "[ERROR] Test 35 crashed!" << std::endl; }
+    try { test_36_state_lists(); } catch (...) { std::cout << "[ERROR] Test 36 crashed!" << std::endl; }
+    try { test_37_nearest_slot(); } catch (...) { std::cout << "[ERROR] Test 37 crashed!" << std::endl; }
+    try { test_38_slot_types(); } catch (...) { std::cout << "[ERROR] Test 38 crashed!" << std::endl; }
+    try { test_39_allocation_policies(); } catch (...) { std::cout << "[ERROR] Test 39 crashed!" << std::endl; }
 
     std::cout << "\n";
     std::cout << "============================================================" << std::endl;
@@ -673,7 +2925,7 @@ int main() {
     std::cout << "Tests Passed: " << TestTracker::getTestsPassed() << std::endl;
     std::cout << "Tests Failed: " << (TestTracker::getTestsRun() - TestTracker::getTestsPassed()) << std::endl;
     std::cout << "Pass Rate: " << (100.0 * TestTracker::getTestsPassed() / TestTracker::getTestsRun()) << "%" << std::endl;
-    std::cout << "\nAll 15 test cases cover:" << std::endl;
+    std::cout << "\nAll 39 test cases cover:" << std::endl;
     std::cout << "  - Slot allocation correctness" << std::endl;
     std::cout << "  - Cross-zone allocation handling" << std::endl;
     std::cout << "  - Cancellation and rollback correctness" << std::endl;
@@ -682,6 +2934,29 @@ int main() {
     std::cout << "  - Zone adjacency relationships" << std::endl;
     std::cout << "  - Peak usage zones analytics" << std::endl;
     std::cout << "  - Parking duration tracking" << std::endl;
+    std::cout << "  - Zone-indexed allocation" << std::endl;
+    std::cout << "  - Bitmap-backed slot availability" << std::endl;
+    std::cout << "  - Constant-time slot ID lookup" << std::endl;
+    std::cout << "  - Adjacency-ordered cross-zone fallback" << std::endl;
+    std::cout << "  - Running analytics counters" << std::endl;
+    std::cout << "  - Peak zone heap and top-K zones" << std::endl;
+    std::cout << "  - Batch allocation" << std::endl;
+    std::cout << "  - Concurrent allocation with per-zone locks" << std::endl;
+    std::cout << "  - Rollback history eviction and redo" << std::endl;
+    std::cout << "  - Shared columnar slot store" << std::endl;
+    std::cout << "  - In-place and move registration" << std::endl;
+    std::cout << "  - Arena-backed entity and slot storage" << std::endl;
+    std::cout << "  - Geometric growth of registries, areas, zones and adjacency" << std::endl;
+    std::cout << "  - Binary event log write and replay (mapped and streamed)" << std::endl;
+    std::cout << "  - Snapshot save and memory-mapped restore" << std::endl;
+    std::cout << "  - Write-ahead journal, checkpoint and crash recovery" << std::endl;
+    std::cout << "  - Timer-wheel no-show and max-stay expiry" << std::endl;
+    std::cout << "  - Latency histograms and operation counters" << std::endl;
+    std::cout << "  - Transition status codes, error counters and buffered error log" << std::endl;
+    std::cout << "  - Compile-time transition table and per-state request lists" << std::endl;
+    std::cout << "  - Coordinate-aware nearest free slot (spatial grid) vs full scan" << std::endl;
+    std::cout << "  - Slot types, vehicle classes and per-type counters" << std::endl;
+    std::cout << "  - Compile-time allocation policies (first fit, best fit, round robin, nearest slot, least utilized zone)" << std::endl;
     std::cout << "  - Edge cases and error handling" << std::endl;
     std::cout << "============================================================" << std::endl;
     std::cout << std::flush;